@@ -3,5 +3,6 @@ int main (void)
     __builtin_clz(1);
     __builtin_ctz(1);
     __builtin_ctzll(1);
+    __builtin_popcountll(1);
     return 0;
 }
@@ -0,0 +1,15 @@
+#include <immintrin.h>
+
+__attribute__((target("popcnt,lzcnt,bmi,bmi2")))
+unsigned long long deposit (unsigned long long v, unsigned long long m)
+{
+    return _pdep_u64(v, m) + __builtin_popcountll(v) + __builtin_clzll(m);
+}
+
+int main (void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt") && __builtin_cpu_supports("bmi2"))
+        return static_cast<int>(deposit (1, 2) & 0x01);
+    return 0;
+}
@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ * $Id$
+ */
+#ifndef PENUM_DISJOINTODOMETER_H_
+#define PENUM_DISJOINTODOMETER_H_
+
+#include <cstdint>
+#include <vector>
+#include <pokerstove/util/lastbit.h>
+#include <pokerstove/peval/CardSet.h>
+#include "CardDistribution.h"
+
+namespace pokerstove
+{
+/**
+ * An odometer over the tuples of hands, one from each distribution, which
+ * only stops on tuples where no two hands share a card.  The tuples come
+ * in the same order as the plain Odometer, but the invalid ones are never
+ * built.  Instead each level is filled by backtracking: the hands which
+ * collide with the cards already used by the earlier levels are knocked
+ * out all at once, using a bitset per card of the hands of each
+ * distribution which hold that card, and whole subtrees are skipped when
+ * a level has nothing left.
+ *
+ * Hands with zero weight, and hands which collide with the dead cards,
+ * are never visited.  The weight of the current tuple, the product of
+ * the weights of its hands, is kept up to date incrementally.
+ *
+ * usage example:
+ *
+ *   DisjointOdometer o(dists, board);
+ *   if (o.seek (0))
+ *       do
+ *       {
+ *           ... dists[i][o[i]], o.weight(), o.used() ...
+ *       }
+ *       while (o.next ());
+ */
+class DisjointOdometer
+{
+public:
+    DisjointOdometer (const std::vector<CardDistribution>& dists, const CardSet& dead)
+        : _n(dists.size())
+        , _sizes(_n)
+        , _strides(_n)
+        , _words(_n)
+        , _masks(_n)
+        , _weights(_n)
+        , _conflicts(_n)
+        , _excluded(_n)
+        , _blocked(_n)
+        , _index(_n, 0)
+        , _used(_n+1, 0)
+        , _weight(_n+1, 1.0)
+    {
+        size_t stride = 1;
+        for (size_t i=_n; i-- > 0; )
+        {
+            _strides[i] = stride;
+            stride *= dists[i].size();
+        }
+        _used[0] = dead.mask();
+
+        for (size_t i=0; i<_n; i++)
+        {
+            const CardDistribution& dist = dists[i];
+            _sizes[i] = dist.size();
+            _words[i] = (_sizes[i]+63)/64;
+            _conflicts[i].assign (STANDARD_DECK_SIZE*_words[i], 0);
+            _excluded[i].assign (_words[i], 0);
+            _blocked[i].assign (_words[i], 0);
+
+            for (size_t h=0; h<_sizes[i]; h++)
+            {
+                uint64_t mask = dist[h].mask();
+                _masks[i].push_back (mask);
+                _weights[i].push_back (dist[dist[h]]);
+                for (size_t c=0; c<STANDARD_DECK_SIZE; c++)
+                    if ((mask >> c) & 0x01)
+                        _conflicts[i][c*_words[i] + h/64] |= UINT64_C(1) << h%64;
+                if ((mask & _used[0]) != 0 || _weights[i][h] == 0.0)
+                    _excluded[i][h/64] |= UINT64_C(1) << h%64;
+            }
+
+            // the slack bits past the last hand are never visited
+            if (_sizes[i]%64 != 0)
+                _excluded[i][_words[i]-1] |= ~UINT64_C(0) << _sizes[i]%64;
+        }
+    }
+
+    /**
+     * the number of tuples, valid or not, of the plain odometer
+     */
+    size_t count () const
+    {
+        return (_n == 0 ? 0 : _strides[0]*_sizes[0]);
+    }
+
+    /**
+     * Move to the first valid tuple at or after the nth tuple of the plain
+     * odometer.  Returns false if there is none.
+     */
+    bool seek (size_t n)
+    {
+        if (_n == 0 || n >= count())
+            return false;
+        for (size_t i=0; i<_n; i++)
+        {
+            size_t digit = (n/_strides[i]) % _sizes[i];
+            block (i);
+            if (!isFree (i, digit))
+                return fill (i, digit);
+            place (i, digit);
+        }
+        return true;
+    }
+
+    /**
+     * move to the next valid tuple, returns false if there is none
+     */
+    bool next ()
+    {
+        return fill (_n-1, _index[_n-1]+1);
+    }
+
+    /**
+     * the index of the hand in the ith distribution
+     */
+    size_t operator[] (size_t i) const
+    {
+        return _index[i];
+    }
+
+    /**
+     * the position of the current tuple in the order of the plain odometer
+     */
+    size_t index () const
+    {
+        size_t ret = 0;
+        for (size_t i=0; i<_n; i++)
+            ret += _index[i]*_strides[i];
+        return ret;
+    }
+
+    /**
+     * the product of the weights of the hands in the current tuple
+     */
+    double weight () const
+    {
+        return _weight[_n];
+    }
+
+    /**
+     * the cards of the current tuple, plus the dead cards
+     */
+    CardSet used () const
+    {
+        return CardSet(_used[_n]);
+    }
+
+private:
+    // the hands of level i which collide with the levels before it
+    void block (size_t i)
+    {
+        const size_t words = _words[i];
+        uint64_t* blocked = &_blocked[i][0];
+        for (size_t w=0; w<words; w++)
+            blocked[w] = _excluded[i][w];
+        uint64_t used = _used[i] & ~_used[0];
+        while (used)
+        {
+            size_t c = lastbit64 (used);
+            used &= used-1;
+            const uint64_t* conflicts = &_conflicts[i][c*words];
+            for (size_t w=0; w<words; w++)
+                blocked[w] |= conflicts[w];
+        }
+    }
+
+    bool isFree (size_t i, size_t h) const
+    {
+        return ((_blocked[i][h/64] >> h%64) & 0x01) == 0;
+    }
+
+    // the first free hand of level i at or after start, or _sizes[i]
+    size_t findFree (size_t i, size_t start) const
+    {
+        for (size_t w=start/64; w<_words[i]; w++)
+        {
+            uint64_t free = ~_blocked[i][w];
+            if (w == start/64)
+                free &= ~UINT64_C(0) << start%64;
+            if (free)
+                return w*64 + lastbit64 (free);
+        }
+        return _sizes[i];
+    }
+
+    void place (size_t i, size_t h)
+    {
+        _index[i]    = h;
+        _used[i+1]   = _used[i] | _masks[i][h];
+        _weight[i+1] = _weight[i] * _weights[i][h];
+    }
+
+    // put level i on its first free hand at or after start, and fill the
+    // later levels, backtracking when a level runs out of hands
+    bool fill (size_t i, size_t start)
+    {
+        for (;;)
+        {
+            size_t h = (start < _sizes[i] ? findFree (i, start) : _sizes[i]);
+            if (h == _sizes[i])
+            {
+                if (i == 0)
+                    return false;
+                i--;
+                start = _index[i]+1;
+                continue;
+            }
+            place (i, h);
+            if (i+1 == _n)
+                return true;
+            i++;
+            block (i);
+            start = 0;
+        }
+    }
+
+    const size_t _n;
+    std::vector<size_t> _sizes;
+    std::vector<size_t> _strides;                 //!< of the plain odometer
+    std::vector<size_t> _words;                   //!< 64 bit words per bitset
+    std::vector<std::vector<uint64_t> > _masks;   //!< cards of each hand
+    std::vector<std::vector<double> >   _weights; //!< weight of each hand
+    std::vector<std::vector<uint64_t> > _conflicts; //!< per card bitset of hands
+    std::vector<std::vector<uint64_t> > _excluded;  //!< never visited
+    std::vector<std::vector<uint64_t> > _blocked;   //!< per level, current
+    std::vector<size_t>   _index;
+    std::vector<uint64_t> _used;                  //!< cards used before level i
+    std::vector<double>   _weight;                //!< weight of levels before i
+};
+} // namespace pokerstove
+
+#endif  // PENUM_DISJOINTODOMETER_H_
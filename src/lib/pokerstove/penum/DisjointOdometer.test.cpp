@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "DisjointOdometer.h"
+#include "Odometer.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+vector<CardDistribution> overlappingRanges()
+{
+    const char* ranges[] = {
+        "AsAh,AsAd,AhAd,AsKs,AhKh,AdKd=0,KsKh,KsKd,QsQh",
+        "AsKh,AhKs,KsKh,KdKc,AsQs,QsQh,JsJh,AcAd",
+        "KsQs,AsJs,AhJh,QhQd,JhJd,AcKc,TsTs",
+    };
+    vector<CardDistribution> dists(3);
+    for (size_t i=0; i<dists.size(); i++)
+        dists[i].parse(ranges[i]);
+    return dists;
+}
+
+// the tuples the plain odometer would keep, as raw indices
+vector<size_t> bruteForce(const vector<CardDistribution>& dists, const CardSet& dead)
+{
+    vector<size_t> sizes;
+    for (size_t i=0; i<dists.size(); i++)
+        sizes.push_back(dists[i].size());
+    Odometer o(sizes);
+    vector<size_t> ret;
+    size_t t = 0;
+    do
+    {
+        CardSet used = dead;
+        bool disjoint = true;
+        double weight = 1.0;
+        for (size_t i=0; i<dists.size(); i++)
+        {
+            disjoint = disjoint && used.disjoint(dists[i][o[i]]);
+            used |= dists[i][o[i]];
+            weight *= dists[i][dists[i][o[i]]];
+        }
+        if (disjoint && weight > 0)
+            ret.push_back(t);
+        t++;
+    }
+    while (o.next());
+    return ret;
+}
+}
+
+TEST(DisjointOdometer, VisitsTheDisjointTuples) {
+    vector<CardDistribution> dists = overlappingRanges();
+    CardSet dead("Qd");
+    vector<size_t> expected = bruteForce(dists, dead);
+
+    DisjointOdometer o(dists, dead);
+    vector<size_t> actual;
+    if (o.seek(0))
+        do
+        {
+            actual.push_back(o.index());
+            double weight = 1.0;
+            CardSet used = dead;
+            for (size_t i=0; i<dists.size(); i++)
+            {
+                weight *= dists[i][dists[i][o[i]]];
+                used |= dists[i][o[i]];
+            }
+            EXPECT_EQ(weight, o.weight());
+            EXPECT_EQ(used, o.used());
+        }
+        while (o.next());
+    EXPECT_EQ(expected, actual);
+    EXPECT_GT(expected.size(), 0);
+}
+
+TEST(DisjointOdometer, SeekFindsNextDisjointTuple) {
+    vector<CardDistribution> dists = overlappingRanges();
+    vector<size_t> expected = bruteForce(dists, CardSet());
+    DisjointOdometer o(dists, CardSet());
+    size_t e = 0;
+    for (size_t t=0; t<o.count(); t++)
+    {
+        while (e < expected.size() && expected[e] < t)
+            e++;
+        if (e == expected.size())
+            EXPECT_FALSE(o.seek(t));
+        else
+        {
+            ASSERT_TRUE(o.seek(t));
+            EXPECT_EQ(expected[e], o.index());
+        }
+    }
+}
+
+TEST(DisjointOdometer, NothingToVisit) {
+    vector<CardDistribution> dists(2);
+    dists[0].parse("AsAh");
+    dists[1].parse("AsKs,AhKh");
+    DisjointOdometer o(dists, CardSet());
+    EXPECT_FALSE(o.seek(0));
+}
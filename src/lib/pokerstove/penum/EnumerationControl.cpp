@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "EnumerationControl.h"
+
+using namespace std;
+using namespace pokerstove;
+
+EnumerationControl::EnumerationControl ()
+    : _callback()
+    , _hasDeadline(false)
+    , _deadline()
+    , _cancelled(false)
+    , _coverage(0.0)
+    , _evaluations(0)
+    , _complete(false)
+{
+}
+
+void EnumerationControl::setProgressCallback (const ProgressCallback& callback)
+{
+    _callback = callback;
+}
+
+void EnumerationControl::setDeadline (Clock::time_point deadline)
+{
+    _hasDeadline = true;
+    _deadline = deadline;
+}
+
+void EnumerationControl::setTimeLimit (double seconds)
+{
+    setDeadline (Clock::now() +
+                 chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds)));
+}
+
+void EnumerationControl::clearDeadline ()
+{
+    _hasDeadline = false;
+}
+
+void EnumerationControl::cancel ()
+{
+    _cancelled.store (true, memory_order_relaxed);
+}
+
+bool EnumerationControl::cancelled () const
+{
+    return _cancelled.load (memory_order_relaxed);
+}
+
+bool EnumerationControl::expired () const
+{
+    return _hasDeadline && Clock::now() >= _deadline;
+}
+
+double EnumerationControl::coverage () const
+{
+    return _coverage;
+}
+
+uint64_t EnumerationControl::evaluations () const
+{
+    return _evaluations;
+}
+
+bool EnumerationControl::complete () const
+{
+    return _complete;
+}
+
+void EnumerationControl::start ()
+{
+    lock_guard<mutex> guard(_lock);
+    _coverage    = 0.0;
+    _evaluations = 0;
+    _complete    = false;
+}
+
+void EnumerationControl::report (double coverage, uint64_t evaluations)
+{
+    lock_guard<mutex> guard(_lock);
+    _coverage    += coverage;
+    _evaluations += evaluations;
+    if (_callback)
+        _callback (_coverage, _evaluations);
+}
+
+void EnumerationControl::finish (bool complete)
+{
+    // the sum of the unit coverages may be off in the last place
+    lock_guard<mutex> guard(_lock);
+    _complete = complete;
+    if (complete)
+        _coverage = 1.0;
+    else if (_coverage > 1.0)
+        _coverage = 1.0;
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PENUM_ENUMERATIONCONTROL_H_
+#define PENUM_ENUMERATIONCONTROL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace pokerstove
+{
+/**
+ * Optional control over a long enumeration: a progress callback, a
+ * cancellation flag and a deadline.  Pass one to calculateEquity.
+ *
+ * The enumerators split their work into units, and look at the flag and
+ * the clock only between units and between hand tuples.  Once either
+ * says stop, the units not yet started are skipped and calculateEquity
+ * returns the results of the ones which were finished.  Those results
+ * are exact for the part of the odometer space they cover, which is
+ * given by coverage().
+ *
+ * The callback is called after each unit with the fraction of the space
+ * done so far and the number of evaluations so far.  It may be called
+ * from any of the worker threads, but never from two at once.  It may
+ * call cancel().
+ *
+ * usage example:
+ *
+ *   EnumerationControl control;
+ *   control.setTimeLimit (0.25);
+ *   results = showdown.calculateEquity (dists, board, peval, &control);
+ *   if (!control.complete ())
+ *       ... results cover control.coverage() of the space ...
+ */
+class EnumerationControl
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (double coverage, uint64_t evaluations)> ProgressCallback;
+
+    EnumerationControl ();
+
+    void setProgressCallback (const ProgressCallback& callback);
+
+    /**
+     * stop at this time, or this many seconds from now
+     */
+    void setDeadline (Clock::time_point deadline);
+    void setTimeLimit (double seconds);
+    void clearDeadline ();
+
+    /**
+     * ask the enumeration to stop, safe to call from any thread
+     */
+    void cancel ();
+    bool cancelled () const;
+
+    /**
+     * true once the deadline, if any, has passed
+     */
+    bool expired () const;
+
+    /**
+     * true if the enumeration should stop, polled by the enumerators
+     */
+    bool stopRequested () const
+    {
+        return cancelled() || expired();
+    }
+
+    /**
+     * the fraction of the odometer space covered by the results of the
+     * last enumeration, and the number of evaluations it made
+     */
+    double   coverage () const;
+    uint64_t evaluations () const;
+
+    /**
+     * true if the last enumeration covered everything
+     */
+    bool complete () const;
+
+    // for the enumerators
+    void start ();                                      //!< clears the counts
+    void report (double coverage, uint64_t evaluations); //!< after each unit
+    void finish (bool complete);
+
+private:
+    EnumerationControl (const EnumerationControl&);
+    EnumerationControl& operator= (const EnumerationControl&);
+
+    ProgressCallback  _callback;
+    bool              _hasDeadline;
+    Clock::time_point _deadline;
+    std::atomic<bool> _cancelled;
+    std::mutex        _lock;          //!< guards the counts and the callback
+    double            _coverage;
+    uint64_t          _evaluations;
+    bool              _complete;
+};
+}
+
+#endif  // PENUM_ENUMERATIONCONTROL_H_
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "EnumerationControl.h"
+#include "RangeShowdownEnumerator.h"
+#include "ShowdownEnumerator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+vector<CardDistribution> parseHands(const char* a, const char* b)
+{
+    vector<CardDistribution> dists(2);
+    dists[0].parse(a);
+    dists[1].parse(b);
+    return dists;
+}
+
+double totalShares(const vector<EquityResult>& results)
+{
+    double total = 0.0;
+    for (size_t i=0; i<results.size(); i++)
+        total += results[i].winShares + results[i].tieShares;
+    return total;
+}
+}
+
+TEST(EnumerationControl, ReportsProgressToCompletion) {
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    vector<double> fractions;
+    EnumerationControl control;
+    control.setProgressCallback([&](double coverage, uint64_t) {
+        fractions.push_back(coverage);
+    });
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> results =
+        showdown.calculateEquity(dists, CardSet(), PokerHandEvaluator::alloc("h"), &control);
+    EXPECT_TRUE(control.complete());
+    EXPECT_EQ(1.0, control.coverage());
+    EXPECT_EQ(201376, control.evaluations());
+    EXPECT_NEAR(201376.0, totalShares(results), 1e-6);
+
+    ASSERT_GT(fractions.size(), 1);
+    for (size_t i=1; i<fractions.size(); i++)
+        EXPECT_LE(fractions[i-1], fractions[i]);
+    EXPECT_NEAR(1.0, fractions.back(), 1e-9);
+}
+
+TEST(EnumerationControl, CancelReturnsExactPartialResults) {
+    // a single matchup is split by the lowest board card, and the first
+    // of those covers C(31,4) of the C(32,5) boards
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    EnumerationControl control;
+    control.setProgressCallback([&](double, uint64_t) { control.cancel(); });
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> results =
+        showdown.calculateEquity(dists, CardSet(), PokerHandEvaluator::alloc("h"), &control);
+    EXPECT_TRUE(control.cancelled());
+    EXPECT_FALSE(control.complete());
+    EXPECT_EQ(31465, control.evaluations());
+    EXPECT_NEAR(31465.0/201376.0, control.coverage(), 1e-12);
+    EXPECT_NEAR(31465.0, totalShares(results), 1e-6);
+}
+
+TEST(EnumerationControl, CancelBetweenTuples) {
+    vector<CardDistribution> dists =
+        parseHands("AsAh,AsAd,AhAd,KsKh,KsKd,KhKd,AsKs,AhKh,AdKd",
+                   "QsQh,QsQd,QhQd,JsJh,JsJd,JhJd,QsJs,QhJh,QdJd,TsTh");
+    CardSet board("9c8c7h");
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    EnumerationControl control;
+    control.setProgressCallback([&](double coverage, uint64_t) {
+        if (coverage > 0.5)
+            control.cancel();
+    });
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> partial = showdown.calculateEquity(dists, board, peval, &control);
+    EXPECT_FALSE(control.complete());
+    EXPECT_GT(control.coverage(), 0.5);
+    EXPECT_LT(control.coverage(), 1.0);
+    EXPECT_NEAR(static_cast<double>(control.evaluations()), totalShares(partial), 1e-6);
+
+    vector<EquityResult> full = showdown.calculateEquity(dists, board, peval);
+    EXPECT_LT(totalShares(partial), totalShares(full));
+}
+
+TEST(EnumerationControl, PastDeadlineDoesNothing) {
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    EnumerationControl control;
+    control.setDeadline(EnumerationControl::Clock::now());
+    EXPECT_TRUE(control.expired());
+
+    ShowdownEnumerator showdown;
+    showdown.setNumThreads(2);
+    vector<EquityResult> results =
+        showdown.calculateEquity(dists, CardSet(), PokerHandEvaluator::alloc("h"), &control);
+    EXPECT_FALSE(control.complete());
+    EXPECT_EQ(0.0, control.coverage());
+    EXPECT_EQ(0, control.evaluations());
+    EXPECT_EQ(0.0, totalShares(results));
+
+    control.clearDeadline();
+    EXPECT_FALSE(control.expired());
+}
+
+TEST(EnumerationControl, RangeEnumeratorCancel) {
+    vector<CardDistribution> dists = parseHands("AsAh,KsKh,QsJs", "QdQh,JsTh");
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    EnumerationControl control;
+    RangeShowdownEnumerator ranges;
+    ranges.calculateEquity(dists, CardSet("9c"), peval, &control);
+    EXPECT_TRUE(control.complete());
+    EXPECT_EQ(1.0, control.coverage());
+
+    control.setProgressCallback([&](double, uint64_t) { control.cancel(); });
+    ranges.calculateEquity(dists, CardSet("9c"), peval, &control);
+    EXPECT_FALSE(control.complete());
+    EXPECT_GT(control.coverage(), 0.0);
+    EXPECT_LT(control.coverage(), 1.0);
+}
+
+TEST(EnumerationControl, DeadlineDropsUnfinishedTuples) {
+    // a three way preflop matchup with a random hand takes far longer
+    // than the limit, and a single one of its units already does
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    dists.push_back(CardDistribution());
+    EnumerationControl control;
+    control.setTimeLimit(0.05);
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> results =
+        showdown.calculateEquity(dists, CardSet(), PokerHandEvaluator::alloc("h"), &control);
+    EXPECT_TRUE(control.expired());
+    EXPECT_FALSE(control.complete());
+    EXPECT_LT(control.coverage(), 1.0);
+    EXPECT_NEAR(static_cast<double>(control.evaluations()), totalShares(results), 1e-6);
+}
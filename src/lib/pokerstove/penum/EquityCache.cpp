@@ -0,0 +1,390 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "EquityCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <boost/interprocess/exceptions.hpp>
+#include <pokerstove/peval/Suit.h>
+
+using namespace std;
+using namespace pokerstove;
+namespace bip = boost::interprocess;
+
+namespace
+{
+const char     MAGIC[8] = "PSEQCCH";
+const uint32_t VERSION  = 1;
+
+// how far along the table a lookup or store looks from its home slot
+const size_t PROBES = 8;
+
+uint64_t mix (uint64_t x)
+{
+    x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+}
+
+uint64_t fingerprint (const vector<uint64_t>& key, uint64_t seed)
+{
+    uint64_t h = mix (seed + key.size());
+    for (size_t i=0; i<key.size(); i++)
+        h = mix (h ^ (key[i] + UINT64_C(0x9e3779b97f4a7c15)));
+    return h;
+}
+
+// append the hands of the distributions, with their weights, after the
+// suit permutation perm, each distribution in sorted order
+void appendHands (const vector<CardDistribution>& dists, const int* perm,
+                  vector<uint64_t>& key, vector<pair<uint64_t,uint64_t> >& scratch)
+{
+    for (size_t i=0; i<dists.size(); i++)
+    {
+        const CardDistribution& dist = dists[i];
+        scratch.clear ();
+        for (size_t h=0; h<dist.size(); h++)
+        {
+            double weight = dist[dist[h]];
+            uint64_t bits;
+            memcpy (&bits, &weight, sizeof(bits));
+            CardSet image = dist[h].rotateSuits (perm[0], perm[1], perm[2], perm[3]);
+            scratch.push_back (make_pair (image.mask(), bits));
+        }
+        sort (scratch.begin(), scratch.end());
+        key.push_back (scratch.size());
+        for (size_t h=0; h<scratch.size(); h++)
+        {
+            key.push_back (scratch[h].first);
+            key.push_back (scratch[h].second);
+        }
+    }
+}
+}
+
+struct EquityCache::DiskHeader
+{
+    char     magic[8];              //!< "PSEQCCH"
+    uint32_t version;
+    uint32_t deckSize;              //!< STANDARD_DECK_SIZE of the build
+    uint32_t maxPlayers;            //!< MAX_DISK_PLAYERS of the build
+    uint32_t reserved;
+    uint64_t numSlots;
+    char     pad[32];
+};
+
+struct EquityCache::DiskSlot
+{
+    uint64_t fingerprint[2];
+    uint32_t used;
+    uint32_t nplayers;
+    double   shares[MAX_DISK_PLAYERS][4];   //!< win, tie, equity, equity2
+};
+
+size_t EquityCache::KeyHash::operator() (const Key& key) const
+{
+    return static_cast<size_t>(fingerprint (key, 0));
+}
+
+EquityCache::EquityCache (size_t capacity, size_t nshards)
+    : _shardCapacity(max<size_t>(1, capacity/max<size_t>(1, nshards)))
+    , _diskHeader(NULL)
+    , _diskSlots(NULL)
+{
+    for (size_t i=0; i<max<size_t>(1, nshards); i++)
+        _shards.push_back (boost::shared_ptr<Shard>(new Shard));
+}
+
+ShowdownEnumerator& EquityCache::enumerator ()
+{
+    return _enumerator;
+}
+
+vector<uint64_t> EquityCache::canonicalKey (const vector<CardDistribution>& dists,
+                                            const CardSet& board,
+                                            const PokerHandEvaluator& peval,
+                                            const CardSet& dead)
+{
+    // the game, packed eight characters to a word
+    Key key;
+    const string& id = peval.id();
+    key.push_back (id.size() << 1 | (peval.usesSuits() ? 1 : 0));
+    for (size_t i=0; i<id.size(); i+=8)
+    {
+        uint64_t word = 0;
+        memcpy (&word, id.data()+i, min<size_t>(8, id.size()-i));
+        key.push_back (word);
+    }
+    CardSet cboard = board.canonize();
+    key.push_back (cboard.mask());
+    const size_t prefix = key.size();
+
+    // of the permutations which canonize the board, keep the one which
+    // gives the smallest dead cards and hands
+    Key best;
+    vector<pair<uint64_t,uint64_t> > scratch;
+    int perm[Suit::NUM_SUIT] = {0, 1, 2, 3};
+    do
+    {
+        if (board.rotateSuits (perm[0], perm[1], perm[2], perm[3]) != cboard)
+            continue;
+        key.resize (prefix);
+        key.push_back (dead.rotateSuits (perm[0], perm[1], perm[2], perm[3]).mask());
+        key.push_back (dists.size());
+        appendHands (dists, perm, key, scratch);
+        if (best.empty() || key < best)
+            best.swap (key);
+    }
+    while (next_permutation (perm, perm+Suit::NUM_SUIT));
+    return best;
+}
+
+vector<EquityResult> EquityCache::calculateEquity (const vector<CardDistribution>& dists,
+                                                   const CardSet& board,
+                                                   boost::shared_ptr<PokerHandEvaluator> peval,
+                                                   const CardSet& dead)
+{
+    if (peval.get() == NULL)
+        throw runtime_error("EquityCache, null evaluator");
+
+    Key key = canonicalKey (dists, board, *peval, dead);
+    Shard& shard = *_shards[KeyHash()(key) % _shards.size()];
+    Results results;
+    if (lookupMemory (shard, key, results))
+        return results;
+    if (lookupDisk (key, results))
+    {
+        storeMemory (shard, key, results);
+        return results;
+    }
+
+    // no lock is held while enumerating, two threads which miss on the
+    // same scenario at once both enumerate it
+    ShowdownEnumerator showdown(_enumerator);
+    showdown.setDeadCards (dead);
+    results = showdown.calculateEquity (dists, board, peval);
+    storeMemory (shard, key, results);
+    storeDisk (key, results);
+    return results;
+}
+
+bool EquityCache::lookupMemory (Shard& shard, const Key& key, Results& results)
+{
+    lock_guard<mutex> guard(shard.lock);
+    unordered_map<Key, Shard::List::iterator, KeyHash>::iterator it = shard.index.find (key);
+    if (it == shard.index.end())
+    {
+        shard.stats.misses++;
+        return false;
+    }
+    shard.stats.hits++;
+    shard.lru.splice (shard.lru.begin(), shard.lru, it->second);
+    results = it->second->second;
+    return true;
+}
+
+void EquityCache::storeMemory (Shard& shard, const Key& key, const Results& results)
+{
+    lock_guard<mutex> guard(shard.lock);
+    if (shard.index.count (key) > 0)
+        return;
+    shard.lru.push_front (make_pair (key, results));
+    shard.index[key] = shard.lru.begin();
+    while (shard.lru.size() > _shardCapacity)
+    {
+        shard.index.erase (shard.lru.back().first);
+        shard.lru.pop_back ();
+        shard.stats.evictions++;
+    }
+}
+
+void EquityCache::openDiskStore (const string& filename, size_t nslots)
+{
+    lock_guard<mutex> guard(_diskLock);
+    _diskHeader = NULL;
+    _diskSlots  = NULL;
+    _diskRegion = bip::mapped_region();
+    _diskFile   = bip::file_mapping();
+
+    // create an empty store, the slots are left as a hole in the file
+    if (!ifstream(filename.c_str()).good())
+    {
+        if (nslots == 0)
+            throw runtime_error("EquityCache, empty disk store " + filename);
+        DiskHeader header;
+        memset (&header, 0, sizeof(header));
+        memcpy (header.magic, MAGIC, sizeof(MAGIC));
+        header.version    = VERSION;
+        header.deckSize   = STANDARD_DECK_SIZE;
+        header.maxPlayers = MAX_DISK_PLAYERS;
+        header.numSlots   = nslots;
+        ofstream out(filename.c_str(), ios::binary);
+        out.write (reinterpret_cast<const char*>(&header), sizeof(header));
+        out.seekp (sizeof(header) + nslots*sizeof(DiskSlot) - 1);
+        out.put (0);
+        if (!out)
+            throw runtime_error("EquityCache, can not create " + filename);
+    }
+
+    try
+    {
+        _diskFile   = bip::file_mapping(filename.c_str(), bip::read_write);
+        _diskRegion = bip::mapped_region(_diskFile, bip::read_write);
+    }
+    catch (const bip::interprocess_exception& e)
+    {
+        throw runtime_error("EquityCache, can not map " + filename + ": " + e.what());
+    }
+
+    if (_diskRegion.get_size() < sizeof(DiskHeader))
+        throw runtime_error("EquityCache, truncated disk store " + filename);
+    DiskHeader* header = static_cast<DiskHeader*>(_diskRegion.get_address());
+    if (memcmp (header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header->version != VERSION ||
+        header->deckSize != STANDARD_DECK_SIZE ||
+        header->maxPlayers != MAX_DISK_PLAYERS ||
+        header->numSlots == 0 ||
+        _diskRegion.get_size() < sizeof(DiskHeader) + header->numSlots*sizeof(DiskSlot))
+    {
+        _diskRegion = bip::mapped_region();
+        throw runtime_error("EquityCache, not a disk store for this build " + filename);
+    }
+    _diskHeader = header;
+    _diskSlots  = reinterpret_cast<DiskSlot*>(header+1);
+}
+
+void EquityCache::closeDiskStore ()
+{
+    lock_guard<mutex> guard(_diskLock);
+    if (_diskHeader)
+        _diskRegion.flush ();
+    _diskHeader = NULL;
+    _diskSlots  = NULL;
+    _diskRegion = bip::mapped_region();
+    _diskFile   = bip::file_mapping();
+}
+
+bool EquityCache::lookupDisk (const Key& key, Results& results)
+{
+    lock_guard<mutex> guard(_diskLock);
+    if (_diskHeader == NULL)
+        return false;
+
+    uint64_t fp0 = fingerprint (key, 0);
+    uint64_t fp1 = fingerprint (key, 1);
+    const uint64_t nslots = _diskHeader->numSlots;
+    for (size_t p=0; p<PROBES; p++)
+    {
+        const DiskSlot& slot = _diskSlots[(fp0+p) % nslots];
+        if (!slot.used)
+            break;
+        if (slot.fingerprint[0] != fp0 || slot.fingerprint[1] != fp1)
+            continue;
+        results.assign (slot.nplayers, EquityResult());
+        for (size_t i=0; i<slot.nplayers; i++)
+        {
+            results[i].winShares = slot.shares[i][0];
+            results[i].tieShares = slot.shares[i][1];
+            results[i].equity    = slot.shares[i][2];
+            results[i].equity2   = slot.shares[i][3];
+        }
+        _diskStats.diskHits++;
+        return true;
+    }
+    _diskStats.diskMisses++;
+    return false;
+}
+
+void EquityCache::storeDisk (const Key& key, const Results& results)
+{
+    lock_guard<mutex> guard(_diskLock);
+    if (_diskHeader == NULL || results.size() > MAX_DISK_PLAYERS)
+        return;
+
+    // take the first free or matching slot, or else push out the one
+    // at home
+    uint64_t fp0 = fingerprint (key, 0);
+    uint64_t fp1 = fingerprint (key, 1);
+    const uint64_t nslots = _diskHeader->numSlots;
+    DiskSlot* target = NULL;
+    for (size_t p=0; p<PROBES && target == NULL; p++)
+    {
+        DiskSlot& slot = _diskSlots[(fp0+p) % nslots];
+        if (!slot.used ||
+            (slot.fingerprint[0] == fp0 && slot.fingerprint[1] == fp1))
+            target = &slot;
+    }
+    if (target == NULL)
+    {
+        target = &_diskSlots[fp0 % nslots];
+        _diskStats.diskEvictions++;
+    }
+
+    memset (target, 0, sizeof(DiskSlot));
+    target->fingerprint[0] = fp0;
+    target->fingerprint[1] = fp1;
+    target->nplayers = static_cast<uint32_t>(results.size());
+    for (size_t i=0; i<results.size(); i++)
+    {
+        target->shares[i][0] = results[i].winShares;
+        target->shares[i][1] = results[i].tieShares;
+        target->shares[i][2] = results[i].equity;
+        target->shares[i][3] = results[i].equity2;
+    }
+    target->used = 1;
+    _diskStats.diskWrites++;
+}
+
+EquityCache::Stats EquityCache::stats () const
+{
+    Stats ret;
+    for (size_t i=0; i<_shards.size(); i++)
+    {
+        Shard& shard = *_shards[i];
+        lock_guard<mutex> guard(shard.lock);
+        ret.hits      += shard.stats.hits;
+        ret.misses    += shard.stats.misses;
+        ret.evictions += shard.stats.evictions;
+    }
+    lock_guard<mutex> guard(_diskLock);
+    ret.diskHits      = _diskStats.diskHits;
+    ret.diskMisses    = _diskStats.diskMisses;
+    ret.diskWrites    = _diskStats.diskWrites;
+    ret.diskEvictions = _diskStats.diskEvictions;
+    return ret;
+}
+
+void EquityCache::resetStats ()
+{
+    for (size_t i=0; i<_shards.size(); i++)
+    {
+        lock_guard<mutex> guard(_shards[i]->lock);
+        _shards[i]->stats = Stats();
+    }
+    lock_guard<mutex> guard(_diskLock);
+    _diskStats = Stats();
+}
+
+size_t EquityCache::size () const
+{
+    size_t ret = 0;
+    for (size_t i=0; i<_shards.size(); i++)
+    {
+        lock_guard<mutex> guard(_shards[i]->lock);
+        ret += _shards[i]->lru.size();
+    }
+    return ret;
+}
+
+void EquityCache::clear ()
+{
+    for (size_t i=0; i<_shards.size(); i++)
+    {
+        lock_guard<mutex> guard(_shards[i]->lock);
+        _shards[i]->lru.clear ();
+        _shards[i]->index.clear ();
+    }
+}
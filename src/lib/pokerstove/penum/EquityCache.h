@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PENUM_EQUITYCACHE_H_
+#define PENUM_EQUITYCACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/PokerHandEvaluator.h>
+#include "CardDistribution.h"
+#include "ShowdownEnumerator.h"
+
+namespace pokerstove
+{
+/**
+ * A cache of equity results in front of a ShowdownEnumerator.
+ *
+ * Scenarios are keyed by their canonical form under the suit
+ * permutations: the board is replaced by board.canonize(), and of the
+ * permutations which do that, the one which gives the smallest dead cards
+ * and hands is applied to them.  So scenarios which differ only by a
+ * renaming of the suits share an entry.  The game id and the weights of
+ * the hands are part of the key, and the results are per player, so they
+ * do not need to be mapped back.
+ *
+ * There are two tiers:
+ * - memory: an LRU map, split into shards with a lock each, so that
+ *   threads looking up different scenarios seldom wait on each other
+ * - disk:   optional, a fixed size open addressing table in a memory
+ *   mapped file, which outlives the process.  Entries are found by a 128
+ *   bit fingerprint of the key rather than the key itself, and results
+ *   are stored for at most MAX_DISK_PLAYERS players.
+ *
+ * A memory miss looks on disk, and a disk miss enumerates and stores the
+ * results in both tiers.  The counters say how often each of these
+ * happens, and how often entries are pushed out.
+ */
+class EquityCache
+{
+public:
+    static const size_t MAX_DISK_PLAYERS = 10;
+
+    struct Stats
+    {
+        Stats ()
+            : hits(0), misses(0), evictions(0)
+            , diskHits(0), diskMisses(0), diskWrites(0), diskEvictions(0)
+        {}
+
+        uint64_t hits;              //!< found in memory
+        uint64_t misses;            //!< not in memory
+        uint64_t evictions;         //!< pushed out of memory
+        uint64_t diskHits;
+        uint64_t diskMisses;
+        uint64_t diskWrites;
+        uint64_t diskEvictions;     //!< overwritten on disk
+    };
+
+    /**
+     * a cache which holds at most capacity scenarios in memory, split
+     * across nshards shards
+     */
+    explicit EquityCache (size_t capacity=65536, size_t nshards=16);
+
+    /**
+     * Use a disk store, creating it with room for nslots scenarios if
+     * the file does not exist.  An existing store keeps its size.  Throws
+     * std::runtime_error if the file can not be created or mapped, or is
+     * not a store.
+     */
+    void openDiskStore (const std::string& filename, size_t nslots=1<<20);
+    void closeDiskStore ();
+
+    /**
+     * the enumerator used for misses, its dead cards are ignored
+     */
+    ShowdownEnumerator& enumerator ();
+
+    /**
+     * the equity of a scenario, from the cache if it is there, safe to
+     * call from several threads at once
+     */
+    std::vector<EquityResult> calculateEquity (const std::vector<CardDistribution>& dists,
+                                               const CardSet& board,
+                                               boost::shared_ptr<PokerHandEvaluator> peval,
+                                               const CardSet& dead=CardSet());
+
+    /**
+     * the key a scenario is cached under
+     */
+    static std::vector<uint64_t> canonicalKey (const std::vector<CardDistribution>& dists,
+                                               const CardSet& board,
+                                               const PokerHandEvaluator& peval,
+                                               const CardSet& dead=CardSet());
+
+    Stats  stats () const;
+    void   resetStats ();
+    size_t size () const;       //!< scenarios in memory
+    void   clear ();            //!< empties the memory tier
+
+private:
+    typedef std::vector<uint64_t> Key;
+    typedef std::vector<EquityResult> Results;
+
+    struct KeyHash
+    {
+        size_t operator() (const Key& key) const;
+    };
+
+    struct Shard
+    {
+        typedef std::list<std::pair<Key,Results> > List;
+
+        std::mutex lock;
+        List lru;                                   //!< most recent first
+        std::unordered_map<Key, List::iterator, KeyHash> index;
+        Stats stats;
+    };
+
+    struct DiskHeader;
+    struct DiskSlot;
+
+    bool lookupMemory (Shard& shard, const Key& key, Results& results);
+    void storeMemory (Shard& shard, const Key& key, const Results& results);
+    bool lookupDisk (const Key& key, Results& results);
+    void storeDisk (const Key& key, const Results& results);
+
+    EquityCache (const EquityCache&);
+    EquityCache& operator= (const EquityCache&);
+
+    size_t _shardCapacity;
+    std::vector<boost::shared_ptr<Shard> > _shards;
+    ShowdownEnumerator _enumerator;
+
+    mutable std::mutex _diskLock;       //!< guards the disk tier
+    boost::interprocess::file_mapping  _diskFile;
+    boost::interprocess::mapped_region _diskRegion;
+    DiskHeader* _diskHeader;
+    DiskSlot*   _diskSlots;
+    Stats       _diskStats;
+};
+}
+
+#endif  // PENUM_EQUITYCACHE_H_
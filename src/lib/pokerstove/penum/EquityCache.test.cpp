@@ -0,0 +1,133 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "EquityCache.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+vector<CardDistribution> parseHands(const char* a, const char* b)
+{
+    vector<CardDistribution> dists(2);
+    dists[0].parse(a);
+    dists[1].parse(b);
+    return dists;
+}
+
+void expectSameResults(const vector<EquityResult>& a,
+                       const vector<EquityResult>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i=0; i<a.size(); i++)
+    {
+        EXPECT_DOUBLE_EQ(a[i].winShares, b[i].winShares);
+        EXPECT_DOUBLE_EQ(a[i].tieShares, b[i].tieShares);
+    }
+}
+}
+
+TEST(EquityCache, SuitPermutedScenariosShareAKey) {
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    // clubs and spades swapped, then hearts and diamonds
+    vector<uint64_t> a = EquityCache::canonicalKey(parseHands("AsKs,QdQh", "JcTc"),
+                                                   CardSet("9s8c7h"), *peval, CardSet("6d"));
+    vector<uint64_t> b = EquityCache::canonicalKey(parseHands("QhQd,AcKc", "JsTs"),
+                                                   CardSet("9c8s7d"), *peval, CardSet("6h"));
+    EXPECT_EQ(a, b);
+
+    // a different dead card, weight, or game is a different scenario
+    EXPECT_NE(a, EquityCache::canonicalKey(parseHands("AsKs,QdQh", "JcTc"),
+                                           CardSet("9s8c7h"), *peval, CardSet("6c")));
+    EXPECT_NE(a, EquityCache::canonicalKey(parseHands("AsKs=2,QdQh", "JcTc"),
+                                           CardSet("9s8c7h"), *peval, CardSet("6d")));
+    EXPECT_NE(a, EquityCache::canonicalKey(parseHands("AsKs,QdQh", "JcTc"),
+                                           CardSet("9s8c7h"), *PokerHandEvaluator::alloc("r"),
+                                           CardSet("6d")));
+}
+
+TEST(EquityCache, HitsMatchShowdownEnumerator) {
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    EquityCache cache;
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh,JdJh");
+    vector<EquityResult> expected =
+        ShowdownEnumerator().calculateEquity(dists, CardSet("9s8c7h"), peval);
+
+    expectSameResults(expected, cache.calculateEquity(dists, CardSet("9s8c7h"), peval));
+    vector<EquityResult> permuted = cache.calculateEquity(parseHands("AhKh", "QdQs,JdJs"),
+                                                          CardSet("9h8c7s"), peval);
+    expectSameResults(expected, permuted);
+
+    EquityCache::Stats stats = cache.stats();
+    EXPECT_EQ(1, stats.hits);
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(0, stats.evictions);
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST(EquityCache, DeadCards) {
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    vector<CardDistribution> dists = parseHands("KsQs", "JdJh");
+    ShowdownEnumerator showdown;
+    showdown.setDeadCards(CardSet("As9c8c"));
+    vector<EquityResult> expected = showdown.calculateEquity(dists, CardSet("Ts9s8s7h"), peval);
+
+    EquityCache cache;
+    expectSameResults(expected, cache.calculateEquity(dists, CardSet("Ts9s8s7h"), peval,
+                                                      CardSet("As9c8c")));
+    EXPECT_EQ(0, cache.stats().hits);
+    cache.calculateEquity(dists, CardSet("Ts9s8s7h"), peval);
+    EXPECT_EQ(0, cache.stats().hits);
+    EXPECT_EQ(2, cache.size());
+}
+
+TEST(EquityCache, EvictsLeastRecentlyUsed) {
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    EquityCache cache(2, 1);
+    const char* boards[] = { "9s8c7hTd6c", "9s8c7hTd6d", "9s8c7hTdJc" };
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    cache.calculateEquity(dists, CardSet(boards[0]), peval);
+    cache.calculateEquity(dists, CardSet(boards[1]), peval);
+    cache.calculateEquity(dists, CardSet(boards[0]), peval);
+    cache.calculateEquity(dists, CardSet(boards[2]), peval);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(1, cache.stats().evictions);
+
+    // boards[1] was the least recently used
+    cache.resetStats();
+    cache.calculateEquity(dists, CardSet(boards[0]), peval);
+    EXPECT_EQ(1, cache.stats().hits);
+    cache.calculateEquity(dists, CardSet(boards[1]), peval);
+    EXPECT_EQ(1, cache.stats().misses);
+}
+
+TEST(EquityCache, DiskStoreOutlivesTheCache) {
+    const string filename = "EquityCache.test.bin";
+    remove(filename.c_str());
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    vector<EquityResult> expected;
+    {
+        EquityCache cache;
+        cache.openDiskStore(filename, 64);
+        expected = cache.calculateEquity(dists, CardSet("9s8c7h"), peval);
+        EXPECT_EQ(1, cache.stats().diskWrites);
+    }
+    {
+        EquityCache cache;
+        cache.openDiskStore(filename);
+        expectSameResults(expected, cache.calculateEquity(dists, CardSet("9s8c7h"), peval));
+        EquityCache::Stats stats = cache.stats();
+        EXPECT_EQ(1, stats.misses);
+        EXPECT_EQ(1, stats.diskHits);
+        EXPECT_EQ(0, stats.diskWrites);
+    }
+    remove(filename.c_str());
+
+    FILE* f = fopen(filename.c_str(), "wb");
+    fputs("not a store", f);
+    fclose(f);
+    EquityCache cache;
+    EXPECT_THROW(cache.openDiskStore(filename), runtime_error);
+    remove(filename.c_str());
+}
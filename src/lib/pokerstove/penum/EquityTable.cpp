@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "EquityTable.h"
+
+#include <algorithm>
+#include <pokerstove/util/choose.h>
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const MappedTable::Format FORMAT =
+    { "EquityTable", "an equity table", "PSEQTBL", EquityTable::VERSION };
+}
+
+EquityTable::EquityTable (const string& filename)
+    : _table(FORMAT, filename, sizeof(Header))
+    , _header(&_table.header<Header>())
+    , _entries(NULL)
+{
+    uint64_t n = numHands();
+    uint64_t expected = (opponent() == RANDOM ? n : n*n);
+    _table.require (_header->opponent <= RANDOM && _header->numEntries == expected,
+                    "corrupt table");
+    _entries = static_cast<const Entry*>(_table.data (sizeof(Header), expected*sizeof(Entry)));
+}
+
+string EquityTable::game () const
+{
+    const char* game = _header->game;
+    return string(game, find (game, game+sizeof(_header->game), '\0'));
+}
+
+bool EquityTable::matches (const PokerHandEvaluator& peval) const
+{
+    // the id is cut to fit the header, as write left it
+    return (peval.evaluationSize() == 1 &&
+            peval.id().substr(0, sizeof(_header->game)-1) == game() &&
+            peval.handSize() == handSize() &&
+            peval.boardSize() == boardSize());
+}
+
+bool EquityTable::lookup (const CardSet& hand, const CardSet& other,
+                          EquityResult& hero, EquityResult& villain,
+                          double weight) const
+{
+    if (hand.size() != handSize())
+        return false;
+
+    const Entry* e;
+    if (opponent() == RANDOM)
+    {
+        if (other.size() != 0)
+            return false;
+        e = &_entries[index(hand)];
+    }
+    else
+    {
+        if (other.size() != handSize() || !hand.disjoint(other))
+            return false;
+        e = &_entries[index(hand)*numHands() + index(other)];
+    }
+
+    double win = e->winShares;
+    double tie = e->tieShares;
+    hero.winShares    += win*weight;
+    hero.tieShares    += tie*weight;
+    villain.winShares += (total() - win - 2*tie)*weight;
+    villain.tieShares += tie*weight;
+    return true;
+}
+
+size_t EquityTable::numHands () const
+{
+    return numHands (handSize());
+}
+
+size_t EquityTable::numHands (size_t handSize)
+{
+    return choose (STANDARD_DECK_SIZE, handSize);
+}
+
+size_t EquityTable::index (const CardSet& hand)
+{
+    uint64_t mask = hand.mask();
+    size_t ret = 0;
+    size_t k = 0;
+    for (size_t b=0; mask != 0; b++, mask >>= 1)
+        if (mask & 0x01)
+            ret += choose (b, ++k);
+    return ret;
+}
+
+void EquityTable::write (const string& filename, Header header,
+                         const vector<Entry>& entries)
+{
+    header.numEntries = entries.size();
+    MappedTable::write (FORMAT, filename, header, sizeof(header), entries);
+}
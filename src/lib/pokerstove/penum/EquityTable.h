@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PENUM_EQUITYTABLE_H_
+#define PENUM_EQUITYTABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/MappedTable.h>
+#include <pokerstove/peval/PokerHandEvaluator.h>
+
+namespace pokerstove
+{
+/**
+ * A precomputed table of heads up, empty board equities, memory mapped
+ * from a file.  Hands are indexed by the colex index of their cards, so a
+ * lookup is a couple of multiplies and a load.
+ *
+ * There are two kinds of table:
+ * - HAND:   every hand against every other hand, numHands() squared
+ *           entries, row is the hero, column the villain
+ * - RANDOM: every hand against a random hand, numHands() entries
+ *
+ * Each entry holds the hero's win and tie shares.  The villain's shares
+ * follow from total(), the number of showdowns behind each entry.  Tables
+ * built by sampling have a non-zero samples(), and their shares are the
+ * sampled fractions scaled up to total().  ShowdownEnumerator only answers
+ * from such a table when told that estimates will do.
+ *
+ * File layout: a Header followed by the entries, in native byte order.
+ */
+class EquityTable
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    enum Opponent
+    {
+        HAND   = 0,
+        RANDOM = 1
+    };
+
+    struct Header
+    {
+        MappedTable::Prefix prefix; //!< "PSEQTBL", VERSION
+        uint32_t handSize;          //!< cards per hand
+        uint32_t boardSize;         //!< cards on a full board
+        uint32_t opponent;          //!< HAND or RANDOM
+        uint32_t reserved;
+        char     game[8];           //!< evaluator id used to build it
+        uint64_t numEntries;
+        uint64_t samples;           //!< zero for exact tables
+        double   total;             //!< showdowns per entry
+    };
+
+    struct Entry
+    {
+        float winShares;
+        float tieShares;
+    };
+
+    /**
+     * map a table file, throws std::runtime_error if it can not be read or
+     * was not built for this deck and version
+     */
+    explicit EquityTable (const std::string& filename);
+
+    const Header& header () const { return *_header; }
+    size_t   handSize () const    { return _header->handSize; }
+    size_t   boardSize () const   { return _header->boardSize; }
+    Opponent opponent () const    { return static_cast<Opponent>(_header->opponent); }
+    uint64_t samples () const     { return _header->samples; }
+    double   total () const       { return _header->total; }
+    bool     exact () const       { return _header->samples == 0; }
+
+    /**
+     * the id of the evaluator the table was built with
+     */
+    std::string game () const;
+
+    /**
+     * true if the table can answer showdowns for this evaluator, the
+     * evaluator must be high only, have the id the table was built with,
+     * and match the table's hand and board sizes
+     */
+    bool matches (const PokerHandEvaluator& peval) const;
+
+    /**
+     * Look up hand against other, which must be empty for RANDOM tables.
+     * The shares are added to hero and villain, scaled by weight.  Returns
+     * false, leaving the results alone, if the table can not answer.
+     */
+    bool lookup (const CardSet& hand, const CardSet& other,
+                 EquityResult& hero, EquityResult& villain,
+                 double weight=1.0) const;
+
+    /**
+     * the number of hands of the table's hand size
+     */
+    size_t numHands () const;
+
+    /**
+     * the colex index of a set of cards among the sets of the same size
+     */
+    static size_t index (const CardSet& hand);
+
+    /**
+     * number of hands of the given size
+     */
+    static size_t numHands (size_t handSize);
+
+    /**
+     * write a table, the header prefix and numEntries are filled in
+     */
+    static void write (const std::string& filename, Header header,
+                       const std::vector<Entry>& entries);
+
+private:
+    MappedTable   _table;
+    const Header* _header;
+    const Entry*  _entries;
+};
+}
+
+#endif  // PENUM_EQUITYTABLE_H_
@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "EquityTable.h"
+#include "ShowdownEnumerator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const char* TABLE_FILE = "equitytable_test.eqt";
+
+vector<CardDistribution> parseHands(const string& a, const string& b)
+{
+    vector<CardDistribution> dists(2);
+    dists[0].parse(a);
+    dists[1].parse(b);
+    return dists;
+}
+}
+
+TEST(EquityTable, IndexIsColex) {
+    EXPECT_EQ(630, EquityTable::numHands(2));
+    EXPECT_EQ(58905, EquityTable::numHands(4));
+    EXPECT_EQ(0, EquityTable::index(CardSet(UINT64_C(0x3))));
+    EXPECT_EQ(629, EquityTable::index(CardSet(UINT64_C(0x3) << 34)));
+}
+
+TEST(EquityTable, LookupMatchesEnumeration) {
+    // a hand table with a single matchup filled in from the enumerator
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    ShowdownEnumerator showdown;
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    vector<EquityResult> exact = showdown.calculateEquity(dists, CardSet(), peval);
+
+    EquityTable::Header header = EquityTable::Header();
+    header.handSize = 2;
+    header.boardSize = 5;
+    header.opponent = EquityTable::HAND;
+    header.total = 201376;
+    strcpy(header.game, "h");
+    vector<EquityTable::Entry> entries(630*630);
+    EquityTable::Entry& e = entries[EquityTable::index(CardSet("AsKs"))*630 +
+                                    EquityTable::index(CardSet("QdQh"))];
+    e.winShares = static_cast<float>(exact[0].winShares);
+    e.tieShares = static_cast<float>(exact[0].tieShares);
+    EquityTable::write(TABLE_FILE, header, entries);
+
+    boost::shared_ptr<const EquityTable> table(new EquityTable(TABLE_FILE));
+    EXPECT_TRUE(table->exact());
+    EXPECT_TRUE(table->matches(*peval));
+    EXPECT_FALSE(table->matches(*PokerHandEvaluator::alloc("O")));
+    showdown.setEquityTable(table);
+
+    vector<EquityResult> looked = showdown.calculateEquity(dists, CardSet(), peval);
+    for (size_t i=0; i<2; i++)
+    {
+        EXPECT_EQ(exact[i].winShares, looked[i].winShares);
+        EXPECT_EQ(exact[i].tieShares, looked[i].tieShares);
+    }
+
+    // a board means the table does not apply
+    looked = showdown.calculateEquity(dists, CardSet("9c8c7h"), peval);
+    EXPECT_NE(0.0, looked[1].winShares + looked[1].tieShares);
+    remove(TABLE_FILE);
+}
+
+TEST(EquityTable, SampledTableIsOptIn) {
+    // a sampled table whose one entry is far from the exact answer
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+    ShowdownEnumerator showdown;
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    vector<EquityResult> exact = showdown.calculateEquity(dists, CardSet(), peval);
+
+    EquityTable::Header header = EquityTable::Header();
+    header.handSize = 2;
+    header.boardSize = 5;
+    header.opponent = EquityTable::HAND;
+    header.samples = 1000;
+    header.total = 201376;
+    strcpy(header.game, "h");
+    vector<EquityTable::Entry> entries(630*630);
+    entries[EquityTable::index(CardSet("AsKs"))*630 +
+            EquityTable::index(CardSet("QdQh"))].winShares = 201376;
+    EquityTable::write(TABLE_FILE, header, entries);
+
+    boost::shared_ptr<const EquityTable> table(new EquityTable(TABLE_FILE));
+    EXPECT_FALSE(table->exact());
+    EXPECT_TRUE(table->matches(*peval));
+
+    // by default the query is still enumerated
+    showdown.setEquityTable(table);
+    vector<EquityResult> looked = showdown.calculateEquity(dists, CardSet(), peval);
+    for (size_t i=0; i<2; i++)
+    {
+        EXPECT_EQ(exact[i].winShares, looked[i].winShares);
+        EXPECT_EQ(exact[i].tieShares, looked[i].tieShares);
+    }
+
+    showdown.setEquityTable(table, true);
+    looked = showdown.calculateEquity(dists, CardSet(), peval);
+    EXPECT_EQ(201376, looked[0].winShares);
+    EXPECT_EQ(0, looked[1].winShares);
+    remove(TABLE_FILE);
+}
+
+TEST(EquityTable, MatchesOnlyItsGame) {
+    // draw high and A-5 lowball both deal five cards and no board
+    EquityTable::Header header = EquityTable::Header();
+    header.handSize = 5;
+    header.boardSize = 0;
+    header.opponent = EquityTable::RANDOM;
+    strcpy(header.game, "d");
+    EquityTable::write(TABLE_FILE, header,
+                       vector<EquityTable::Entry>(EquityTable::numHands(5)));
+
+    EquityTable table(TABLE_FILE);
+    EXPECT_EQ("d", table.game());
+    EXPECT_TRUE(table.matches(*PokerHandEvaluator::alloc("d")));
+    EXPECT_FALSE(table.matches(*PokerHandEvaluator::alloc("l")));
+    EXPECT_FALSE(table.matches(*PokerHandEvaluator::alloc("k")));
+    remove(TABLE_FILE);
+}
+
+TEST(EquityTable, RejectsBadFiles) {
+    {
+        ofstream out(TABLE_FILE, ios::binary);
+        out << "this is not an equity table, but it is long enough to have a header";
+    }
+    EXPECT_THROW(EquityTable table(TABLE_FILE), runtime_error);
+    remove(TABLE_FILE);
+    EXPECT_THROW(EquityTable table(TABLE_FILE), runtime_error);
+}
@@ -81,6 +81,30 @@ public:
         return _odom[i];
     }
 
+    /**
+     * position the odometer on the nth tuple of the enumeration order,
+     * this allows ranges of tuples to be enumerated independently
+     */
+    void seek (size_t n)
+    {
+        for (int i=static_cast<int>(_odom.size())-1; i>=0; i--)
+        {
+            _odom[i] = static_cast<int>(n % _extents[i]);
+            n /= _extents[i];
+        }
+    }
+
+    /**
+     * the total number of tuples enumerated
+     */
+    size_t count () const
+    {
+        size_t ret = 1;
+        for (size_t i=0; i<_extents.size(); i++)
+            ret *= _extents[i];
+        return ret;
+    }
+
 private:
 
     bool flip (int n)
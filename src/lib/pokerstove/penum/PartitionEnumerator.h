@@ -6,8 +6,11 @@
 #define COMMON_ENUM_PARTITIONENUMERATOR_H_
 
 #include <cstdint>
+#include <map>
 #include <vector>
 #include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/util/choose.h>
 #include <pokerstove/util/combinations.h>
 
 namespace pokerstove
@@ -58,15 +61,64 @@ public:
         , _pcombos()
         , _subsets()
         , _masks(partitions.size())
+        , _pinned(partitions.size())
+        , _lead(0)
     {
-        int used = 0;
-        for (size_t i=0; i<_parts.size(); i++)
+        init ();
+    }
+
+    /**
+     * create a partition enumerator which only visits the partitions in
+     * which the lowest index of the first non-empty part is lead.  The
+     * leads [0..numLeads()) split the full enumeration into disjoint
+     * pieces, which can then be enumerated independently.
+     */
+    PartitionEnumerator2 (size_t setSize, const std::vector<size_t> partitions,
+                          size_t lead)
+        : _setSize(setSize)
+        , _parts(partitions)
+        , _pcombos()
+        , _subsets()
+        , _masks(partitions.size())
+        , _pinned(partitions.size())
+        , _lead(lead)
+    {
+        for (size_t i=0; i<_parts.size() && _pinned == _parts.size(); i++)
+            if (_parts[i] > 0)
+                _pinned = i;
+        init ();
+    }
+
+    /**
+     * the number of distinct leads for the given partitions
+     */
+    static size_t numLeads (size_t setSize, const std::vector<size_t>& partitions)
+    {
+        for (size_t i=0; i<partitions.size(); i++)
+            if (partitions[i] > 0)
+                return (setSize >= partitions[i] ? setSize-partitions[i]+1 : 0);
+        return 1;
+    }
+
+    /**
+     * the fraction of the partitions which have the given lead.  Of the
+     * C(n,k) subsets of the first non-empty part, C(n-1-lead,k-1) start
+     * at lead.
+     */
+    static double leadShare (size_t setSize, const std::vector<size_t>& partitions,
+                             size_t lead)
+    {
+        for (size_t i=0; i<partitions.size(); i++)
         {
-            _pcombos.push_back (Combos(_setSize-used, _parts[i]));
-            _subsets.push_back (std::vector<size_t>(_setSize-used));
-            used += _parts[i];
-            setup (static_cast<int>(i));
+            const size_t k = partitions[i];
+            if (k == 0)
+                continue;
+            if (lead+k > setSize)
+                return 0.0;
+            return (static_cast<double>(chooseSmall (setSize-1-lead, k-1)) /
+                    static_cast<double>(chooseSmall (setSize, k)));
         }
+        return (lead == 0 ? 1.0 : 0.0);
     }
 
     /**
@@ -153,12 +205,35 @@ public:
         return incr ();
     }
 
+    /**
+     * go back to the first partition, without reallocating
+     */
+    void reset ()
+    {
+        for (size_t i=0; i<_parts.size(); i++)
+            setup (static_cast<int>(i));
+    }
+
 private:
     size_t _setSize;
     std::vector<size_t> _parts;
     std::vector<Combos> _pcombos;
     std::vector<std::vector<size_t> > _subsets;
     mutable std::vector<uint64_t> _masks;
+    size_t _pinned;                     //!< part whose lead is fixed
+    size_t _lead;                       //!< lowest index of the pinned part
+
+    void init ()
+    {
+        int used = 0;
+        for (size_t i=0; i<_parts.size(); i++)
+        {
+            _pcombos.push_back (Combos(_setSize-used, _parts[i]));
+            _subsets.push_back (std::vector<size_t>(_setSize-used));
+            used += _parts[i];
+            setup (static_cast<int>(i));
+        }
+    }
 
     bool incr ()
     {
@@ -198,6 +273,10 @@ private:
         {
             if (_pcombos[n].next())
             {
+                // the pinned part may not move past its lead, and the
+                // parts before it are empty, so we are done
+                if (static_cast<size_t>(n) == _pinned && _pcombos[n][0] != _lead)
+                    return false;
                 makeMask (n);
                 while (++n < _parts.size())
                     setup (static_cast<int>(n));
@@ -234,9 +313,54 @@ private:
                 *it = i++;
         }
         _pcombos[n].reset ();
+        if (static_cast<size_t>(n) == _pinned)
+        {
+            size_t * c = _pcombos[n].begin();
+            for (size_t i=0; i<_parts[n]; i++)
+                c[i] = _lead+i;
+        }
         makeMask (n);
     }
 };
+
+/**
+ * Keeps the partition enumerators built for each shape of partitions,
+ * so that loops which see the same few shapes over and over build each
+ * one only once, and then just reset it.
+ */
+class PartitionEnumeratorCache
+{
+public:
+    // the lead of enumerators which visit all of the partitions
+    static const size_t ALL_LEADS = static_cast<size_t>(-1);
+
+    /**
+     * an enumerator over the partitions, with the given lead, reset to
+     * its first partition
+     */
+    PartitionEnumerator2& get (size_t setSize, const std::vector<size_t>& partitions,
+                               size_t lead=ALL_LEADS)
+    {
+        _key.assign (partitions.begin(), partitions.end());
+        _key.push_back (setSize);
+        _key.push_back (lead);
+        boost::shared_ptr<PartitionEnumerator2>& pe = _enumerators[_key];
+        if (!pe)
+        {
+            if (lead == ALL_LEADS)
+                pe.reset (new PartitionEnumerator2(setSize, partitions));
+            else
+                pe.reset (new PartitionEnumerator2(setSize, partitions, lead));
+        }
+        else
+            pe->reset ();
+        return *pe;
+    }
+
+private:
+    std::vector<size_t> _key;
+    std::map<std::vector<size_t>, boost::shared_ptr<PartitionEnumerator2> > _enumerators;
+};
 } // namespace pokerstove
 
 #endif  // COMMON_ENUM_PARTITIONENUMERATOR_H_
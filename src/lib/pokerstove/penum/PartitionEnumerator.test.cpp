@@ -82,3 +82,56 @@ TEST(PartitionEnumerator, end_game_ofcp_draws_A) {
     while (walker.next());
     EXPECT_EQ(328860, visits);        // 328,860
 }
+
+TEST(PartitionEnumerator, leads_split_enumeration) {
+    // the leads should split the enumeration into disjoint pieces which
+    // together cover the whole thing, an empty first part is skipped
+    std::vector<size_t> partitions;
+    partitions.push_back(0);
+    partitions.push_back(2);
+    partitions.push_back(1);
+    partitions.push_back(2);
+
+    size_t nleads = PartitionEnumerator2::numLeads(30, partitions);
+    EXPECT_EQ(29, nleads);
+
+    const uint64_t total = 435*28*351;  // 4,275,180
+    uint64_t visits = 0;
+    for (size_t lead=0; lead<nleads; lead++)
+    {
+        PartitionEnumerator2 walker(30, partitions, lead);
+        uint64_t leadVisits = 0;
+        do {
+            EXPECT_EQ(lead, walker.getIndex(1,0));
+            leadVisits += 1;
+        }
+        while (walker.next());
+        EXPECT_DOUBLE_EQ(static_cast<double>(leadVisits)/total,
+                         PartitionEnumerator2::leadShare(30, partitions, lead));
+        visits += leadVisits;
+    }
+    EXPECT_EQ(total, visits);
+    EXPECT_EQ(0.0, PartitionEnumerator2::leadShare(30, partitions, nleads));
+}
+
+TEST(PartitionEnumerator, reset_restarts_enumeration) {
+    std::vector<size_t> partitions;
+    partitions.push_back(2);
+    partitions.push_back(3);
+
+    PartitionEnumerator2 walker(10, partitions, 4);
+    std::vector<std::string> first;
+    do {
+        first.push_back(walker.str());
+    }
+    while (walker.next());
+
+    walker.reset();
+    std::vector<std::string> second;
+    do {
+        second.push_back(walker.str());
+    }
+    while (walker.next());
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(5*56, first.size());
+}
@@ -0,0 +1,302 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "RangeShowdownEnumerator.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <pokerstove/util/combinations.h>
+#include "PartitionEnumerator.h"
+#include "ShowdownEnumerator.h"
+#include "SimpleDeck.hpp"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+namespace pokerstove {
+
+namespace
+{
+// how often a controlled enumeration polls its control, in boards
+const size_t POLL_INTERVAL = 64;
+
+/**
+ * The hands of the distributions which can appear with the board, along
+ * with their weights.
+ */
+struct Ranges
+{
+    vector<vector<CardSet> > hands;
+    vector<vector<double> >  weights;
+};
+
+/**
+ * Enumerates the boards with a given lead card, evaluating each live hand
+ * once per board.  Each worker thread gets its own.
+ */
+class BoardWorker
+{
+public:
+    BoardWorker (const Ranges& ranges,
+                 const CardSet& board,
+                 const PokerHandEvaluator& peval)
+        : _ranges(ranges)
+        , _board(board)
+        , _peval(peval)
+        , _ndists(ranges.hands.size())
+        , _evals(_ndists)
+        , _live(_ndists)
+        , _tuple(_ndists)
+        , _evaluations(0)
+    {
+        for (size_t i=0; i<_ndists; i++)
+        {
+            _evals[i].resize (ranges.hands[i].size());
+            _live[i].reserve (ranges.hands[i].size());
+        }
+        _deck.remove (board);
+        _parts.push_back (peval.boardSize()-board.size());
+    }
+
+    /**
+     * the number of leads, or work units, to split the boards into
+     */
+    size_t numLeads () const
+    {
+        return PartitionEnumerator2::numLeads (_deck.size(), _parts);
+    }
+
+    /**
+     * the fraction of the boards which have the given lead card
+     */
+    double leadShare (size_t lead) const
+    {
+        return PartitionEnumerator2::leadShare (_deck.size(), _parts, lead);
+    }
+
+    /**
+     * the number of hands evaluated so far
+     */
+    uint64_t evaluations () const
+    {
+        return _evaluations;
+    }
+
+    /**
+     * Enumerate all the boards with the given lead card.  With a control,
+     * returns false and leaves the results alone if it asked to stop part
+     * way through.
+     */
+    bool enumerate (size_t lead, EquityResult* results,
+                    const EnumerationControl* control=NULL)
+    {
+        EquityResult* shares = results;
+        if (control)
+        {
+            _scratch.assign (_ndists, EquityResult());
+            shares = &_scratch[0];
+        }
+
+        uint64_t before = _evaluations;
+        size_t nboards = 0;
+        PartitionEnumerator2 pe(_deck.size(), _parts, lead);
+        do
+        {
+            if (control && nboards++ % POLL_INTERVAL == 0 && control->stopRequested())
+            {
+                _evaluations = before;
+                return false;
+            }
+            CardSet board = _board | _deck.peek (pe.getMask (0));
+            evaluate (board);
+            settle (0, CardSet(), 1.0, shares);
+        }
+        while (pe.next ());
+
+        if (control)
+            for (size_t i=0; i<_ndists; i++)
+                results[i] += _scratch[i];
+        return true;
+    }
+
+private:
+    // evaluate every hand which does not collide with the board
+    void evaluate (const CardSet& board)
+    {
+        for (size_t i=0; i<_ndists; i++)
+        {
+            const vector<CardSet>& hands = _ranges.hands[i];
+            _live[i].clear ();
+            for (size_t h=0; h<hands.size(); h++)
+            {
+                if (!hands[h].disjoint (board))
+                    continue;
+                _evals[i][h] = _peval.evaluateHand (hands[h], board);
+                _live[i].push_back (h);
+                _evaluations++;
+            }
+        }
+    }
+
+    // walk the tuples of live hands which do not share cards, and award
+    // the pot for each
+    void settle (size_t p, const CardSet& used, double weight, EquityResult* results)
+    {
+        if (p == _ndists)
+        {
+            PokerHandEvaluator::awardShares (&_tuple[0], _ndists, results, weight);
+            return;
+        }
+        const vector<CardSet>& hands = _ranges.hands[p];
+        const vector<double>& weights = _ranges.weights[p];
+        const vector<size_t>& live = _live[p];
+        for (size_t l=0; l<live.size(); l++)
+        {
+            size_t h = live[l];
+            if (!used.disjoint (hands[h]))
+                continue;
+            _tuple[p] = _evals[p][h];
+            settle (p+1, used | hands[h], weight*weights[h], results);
+        }
+    }
+
+    const Ranges& _ranges;
+    const CardSet& _board;
+    const PokerHandEvaluator& _peval;
+    const size_t _ndists;
+
+    SimpleDeck                           _deck;
+    vector<size_t>                       _parts;
+    vector<vector<PokerHandEvaluation> > _evals;    //!< by dist, then hand
+    vector<vector<size_t> >              _live;     //!< hands off the board
+    vector<PokerHandEvaluation>          _tuple;
+    vector<EquityResult>                 _scratch;  //!< shares of the lead
+    uint64_t                             _evaluations;
+};
+
+/**
+ * collect the hands and weights of the distributions, expanding random
+ * distributions, returns false if there is a partial hand
+ */
+bool collectRanges (const vector<CardDistribution>& dists,
+                    const CardSet& board,
+                    size_t handsize,
+                    Ranges& ranges)
+{
+    ranges.hands.resize (dists.size());
+    ranges.weights.resize (dists.size());
+    for (size_t i=0; i<dists.size(); i++)
+    {
+        const CardDistribution& dist = dists[i];
+        if (dist.size() == 1 && dist[0].size() == 0)
+        {
+            double weight = dist[dist[0]];
+            combinations cards(STANDARD_DECK_SIZE, handsize);
+            do
+            {
+                uint64_t mask = 0;
+                for (size_t c=0; c<handsize; c++)
+                    mask |= UINT64_C(1) << cards[c];
+                if (board.disjoint (CardSet(mask)))
+                {
+                    ranges.hands[i].push_back (CardSet(mask));
+                    ranges.weights[i].push_back (weight);
+                }
+            }
+            while (cards.next ());
+            continue;
+        }
+
+        for (size_t h=0; h<dist.size(); h++)
+        {
+            const CardSet& hand = dist[h];
+            if (hand.size() != handsize)
+                return false;
+            double weight = dist[hand];
+            if (weight == 0.0 || !board.disjoint (hand))
+                continue;
+            ranges.hands[i].push_back (hand);
+            ranges.weights[i].push_back (weight);
+        }
+    }
+    return true;
+}
+}
+
+RangeShowdownEnumerator::RangeShowdownEnumerator ()
+    : _numThreads(1)
+{
+}
+
+void RangeShowdownEnumerator::setNumThreads (size_t nthreads)
+{
+    _numThreads = nthreads;
+}
+
+size_t RangeShowdownEnumerator::numThreads () const
+{
+    return _numThreads;
+}
+
+vector<EquityResult> RangeShowdownEnumerator::calculateEquity (const vector<CardDistribution>& dists,
+                                                               const CardSet& board,
+                                                               boost::shared_ptr<PokerHandEvaluator> peval,
+                                                               EnumerationControl* control) const
+{
+    if (peval.get() == NULL)
+        throw runtime_error("RangeShowdownEnumerator, null evaluator");
+    assert(dists.size() > 0);
+    const size_t ndists = dists.size();
+
+    Ranges ranges;
+    if (peval->boardSize() == 0 || board.size() > peval->boardSize() ||
+        !collectRanges (dists, board, peval->handSize(), ranges))
+    {
+        ShowdownEnumerator showdown;
+        showdown.setNumThreads (_numThreads);
+        return showdown.calculateEquity (dists, board, peval, control);
+    }
+
+    // The boards are split into work units by their lowest card, and each
+    // worker accumulates into its own padded stretch of shares.  Once the
+    // control asks to stop, the units not yet started are skipped, and
+    // those in progress are dropped.
+    if (control)
+        control->start ();
+    WorkStealingPool pool(_numThreads);
+    const size_t nthreads = pool.size();
+    const size_t stride = paddedStride<EquityResult>(ndists);
+    vector<EquityResult> shares(stride*nthreads, EquityResult());
+    vector<boost::shared_ptr<BoardWorker> > workers(nthreads);
+    BoardWorker planner(ranges, board, *peval);
+    atomic<bool> stopped(false);
+    pool.run (planner.numLeads(), [&](size_t lead, size_t w)
+    {
+        if (control && control->stopRequested())
+        {
+            stopped = true;
+            return;
+        }
+        if (!workers[w])
+            workers[w].reset (new BoardWorker(ranges, board, *peval));
+        uint64_t before = workers[w]->evaluations();
+        if (!workers[w]->enumerate (lead, &shares[w*stride], control))
+        {
+            stopped = true;
+            return;
+        }
+        if (control)
+            control->report (workers[w]->leadShare(lead),
+                             workers[w]->evaluations()-before);
+    });
+    if (control)
+        control->finish (!stopped);
+
+    vector<EquityResult> results(ndists, EquityResult());
+    for (size_t w=0; w<nthreads; w++)
+        for (size_t i=0; i<ndists; i++)
+            results[i] += shares[w*stride+i];
+    return results;
+}
+
+}
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PENUM_RANGESHOWDOWNENUMERATOR_H_
+#define PENUM_RANGESHOWDOWNENUMERATOR_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/peval/PokerHandEvaluator.h>
+#include "CardDistribution.h"
+#include "EnumerationControl.h"
+
+namespace pokerstove
+{
+/**
+ * An enumerator for range vs range showdowns in board games such as
+ * hold'em and omaha.  Where the ShowdownEnumerator loops over the tuples
+ * of hands and then over the boards, this one loops over the boards
+ * first.  On each board every live hand of every distribution is
+ * evaluated once, and all of the matchups are then settled from those
+ * evaluations, skipping the tuples which share cards.  With ranges of n
+ * and m hands that is n+m evaluations per board, instead of 2nm.
+ *
+ * The results are the same as those of ShowdownEnumerator.  Scenarios it
+ * can not handle, games without a board or distributions with partial
+ * hands, are passed on to a ShowdownEnumerator.  A random distribution
+ * is expanded to all of the hands.
+ */
+class RangeShowdownEnumerator
+{
+public:
+    RangeShowdownEnumerator ();
+
+    /**
+     * enumerate a poker scenario, with board support, and optionally
+     * under the control of an EnumerationControl
+     */
+    std::vector<EquityResult> calculateEquity (const std::vector<CardDistribution>& dists,
+                                               const CardSet& board,
+                                               boost::shared_ptr<PokerHandEvaluator> peval,
+                                               EnumerationControl* control=NULL) const;
+
+    /**
+     * set the number of threads calculateEquity uses, zero means one per
+     * core.  The default is a single thread.
+     */
+    void setNumThreads (size_t nthreads);
+    size_t numThreads () const;
+
+private:
+    size_t _numThreads;
+};
+}
+
+#endif  // PENUM_RANGESHOWDOWNENUMERATOR_H_
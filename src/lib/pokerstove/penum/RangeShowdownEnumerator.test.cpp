@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "RangeShowdownEnumerator.h"
+#include "ShowdownEnumerator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+void expectSameAsShowdown(const vector<string>& hands,
+                          const string& board,
+                          const string& game,
+                          size_t nthreads=1)
+{
+    vector<CardDistribution> dists(hands.size());
+    for (size_t i=0; i<hands.size(); i++)
+        dists[i].parse(hands[i]);
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc(game);
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> expected = showdown.calculateEquity(dists, CardSet(board), peval);
+    RangeShowdownEnumerator ranges;
+    ranges.setNumThreads(nthreads);
+    vector<EquityResult> actual = ranges.calculateEquity(dists, CardSet(board), peval);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i=0; i<expected.size(); i++)
+    {
+        EXPECT_NEAR(expected[i].winShares, actual[i].winShares, 1e-9*expected[i].winShares);
+        EXPECT_NEAR(expected[i].tieShares, actual[i].tieShares, 1e-9*expected[i].tieShares);
+    }
+}
+}
+
+TEST(RangeShowdownEnumerator, HoldemRangesMatchShowdownEnumerator) {
+    vector<string> hands;
+    hands.push_back("AsAh,AsAd=0.5,KsKh,AsKs,QdJd");
+    hands.push_back("QsQh,QsQd=2,JsJh,QsJs,TsTh,AhKh");
+    expectSameAsShowdown(hands, "9c8c7h", "h");
+    expectSameAsShowdown(hands, "9c8c7h", "h", 3);
+
+    hands.push_back("Th9h,6c6d");
+    expectSameAsShowdown(hands, "9c8c7h", "h");
+}
+
+TEST(RangeShowdownEnumerator, RandomHandIsExpanded) {
+    vector<string> hands;
+    hands.push_back("AsAh,KsKh");
+    hands.push_back(".");
+    expectSameAsShowdown(hands, "9c8c7hTd", "h");
+}
+
+TEST(RangeShowdownEnumerator, SplitPotsMatchShowdownEnumerator) {
+    vector<string> hands;
+    hands.push_back("AsAh6c7c,KsKhJdTd");
+    hands.push_back("QsQh8d9d,6s7s8s9h");
+    expectSameAsShowdown(hands, "9c8c7hTs", "o");
+    expectSameAsShowdown(hands, "9c8c7hTs", "O");
+}
+
+TEST(RangeShowdownEnumerator, PartialHandsFallBack) {
+    vector<string> hands;
+    hands.push_back("As");
+    hands.push_back("QsQh");
+    expectSameAsShowdown(hands, "9c8c7h", "h");
+}
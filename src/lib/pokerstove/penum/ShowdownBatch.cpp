@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "ShowdownBatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include "PartitionEnumerator.h"
+#include "SimpleDeck.hpp"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+namespace pokerstove {
+
+namespace
+{
+// aim for this many runs of scenarios per thread
+const size_t UNITS_PER_THREAD = 16;
+
+const size_t NUM_GAMES = 256;
+
+typedef const PokerHandEvaluator* EvaluatorTable[NUM_GAMES];
+
+void badScenario (size_t index, const string& why)
+{
+    throw invalid_argument("ShowdownBatch, scenario " +
+                           boost::lexical_cast<string>(index) + ": " + why);
+}
+
+/**
+ * The scratch space for enumerating scenarios, one per worker thread,
+ * reused from one scenario to the next.
+ */
+class BatchWorker
+{
+public:
+    BatchWorker ()
+        : _ehands(ShowdownScenario::MAX_PLAYERS+1)
+        , _cardPartitions(ShowdownScenario::MAX_PLAYERS+1)
+    {
+        _parts.reserve (ShowdownScenario::MAX_PLAYERS+1);
+        _evals.reserve (ShowdownScenario::MAX_PLAYERS);
+    }
+
+    void enumerate (const ShowdownScenario& s, const PokerHandEvaluator& peval,
+                    ShowdownBatchResult& result)
+    {
+        const size_t nplayers = s.nplayers;
+        const size_t nboards  = (peval.boardSize() > 0 ? 1 : 0);
+        const size_t nparts   = nplayers+nboards;
+
+        _parts.resize (nparts);
+        _evals.resize (nplayers);
+        for (size_t i=0; i<nplayers; i++)
+        {
+            _cardPartitions[i] = s.hands[i];
+            _parts[i]          = peval.handSize()-s.hands[i].size();
+        }
+        if (nboards > 0)
+        {
+            _cardPartitions[nplayers] = s.board;
+            _parts[nplayers]          = peval.boardSize()-s.board.size();
+        }
+
+        CardSet dead = s.dead | s.board;
+        for (size_t i=0; i<nplayers; i++)
+            dead |= s.hands[i];
+        _deck = _fresh;
+        _deck.remove (dead);
+
+        PartitionEnumerator2& pe = _enumerators.get (_deck.size(), _parts);
+        const size_t ncopy = nparts*sizeof(CardSet);
+        do
+        {
+            memcpy (&_ehands[0], &_cardPartitions[0], ncopy);
+            for (size_t p=0; p<nparts; p++)
+                _ehands[p] |= _deck.peek (pe.getMask (p));
+            if (nboards > 0)
+                peval.evaluateShowdown (_ehands, _ehands[nplayers], _evals, result.shares);
+            else
+                peval.evaluateShowdown (_ehands, s.board, _evals, result.shares);
+        }
+        while (pe.next ());
+    }
+
+private:
+    const SimpleDeck            _fresh;         //!< in order
+    SimpleDeck                  _deck;
+    vector<CardSet>             _ehands;
+    vector<size_t>              _parts;
+    vector<CardSet>             _cardPartitions;
+    vector<PokerHandEvaluation> _evals;
+    PartitionEnumeratorCache    _enumerators;
+};
+
+void checkScenario (const ShowdownScenario& s, size_t index,
+                    const PokerHandEvaluator& peval)
+{
+    if (s.nplayers == 0 || s.nplayers > ShowdownScenario::MAX_PLAYERS)
+        badScenario (index, "bad number of players");
+
+    CardSet used = s.dead;
+    size_t ncards = s.dead.size();
+    size_t ndeal = 0;
+    for (size_t i=0; i<s.nplayers; i++)
+    {
+        if (s.hands[i].size() > peval.handSize())
+            badScenario (index, "hand too large: " + s.hands[i].str());
+        used |= s.hands[i];
+        ncards += s.hands[i].size();
+        ndeal += peval.handSize()-s.hands[i].size();
+    }
+    if (peval.boardSize() > 0)
+    {
+        if (s.board.size() > peval.boardSize())
+            badScenario (index, "board too large: " + s.board.str());
+        ndeal += peval.boardSize()-s.board.size();
+    }
+    used |= s.board;
+    ncards += s.board.size();
+
+    if (used.size() != ncards)
+        badScenario (index, "cards used more than once");
+    if (ndeal > STANDARD_DECK_SIZE-ncards)
+        badScenario (index, "not enough cards to deal");
+}
+}
+
+ShowdownBatch::ShowdownBatch ()
+    : _numThreads(1)
+{
+}
+
+void ShowdownBatch::setNumThreads (size_t nthreads)
+{
+    _numThreads = nthreads;
+}
+
+size_t ShowdownBatch::numThreads () const
+{
+    return _numThreads;
+}
+
+vector<ShowdownBatchResult>
+ShowdownBatch::calculateEquity (const vector<ShowdownScenario>& scenarios) const
+{
+    vector<ShowdownBatchResult> results(scenarios.size());
+    if (!scenarios.empty())
+        calculateEquity (&scenarios[0], scenarios.size(), &results[0]);
+    return results;
+}
+
+void ShowdownBatch::calculateEquity (const ShowdownScenario* scenarios, size_t n,
+                                     ShowdownBatchResult* results) const
+{
+    // one evaluator per game, and the scenarios in game order, so that
+    // each run of scenarios stays with one evaluator
+    vector<boost::shared_ptr<PokerHandEvaluator> > owned;
+    EvaluatorTable evaluators = {};
+    vector<size_t> order(n);
+    for (size_t i=0; i<n; i++)
+    {
+        unsigned char g = static_cast<unsigned char>(scenarios[i].game);
+        if (evaluators[g] == NULL)
+        {
+            try
+            {
+                owned.push_back (PokerHandEvaluator::alloc (string(1, scenarios[i].game)));
+            }
+            catch (const runtime_error& e)
+            {
+                badScenario (i, e.what());
+            }
+            evaluators[g] = owned.back().get();
+        }
+        checkScenario (scenarios[i], i, *evaluators[g]);
+        results[i] = ShowdownBatchResult();
+        order[i] = i;
+    }
+    stable_sort (order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return (static_cast<unsigned char>(scenarios[a].game) <
+                static_cast<unsigned char>(scenarios[b].game));
+    });
+
+    // each scenario writes only its own result, so the workers share
+    // nothing but the evaluators, which are const
+    WorkStealingPool pool(_numThreads);
+    const size_t nthreads = pool.size();
+    const size_t nunits = min(n, nthreads*UNITS_PER_THREAD);
+    vector<boost::shared_ptr<BatchWorker> > workers(nthreads);
+    pool.run (nunits, [&](size_t unit, size_t w)
+    {
+        if (!workers[w])
+            workers[w].reset (new BatchWorker);
+        for (size_t k=n*unit/nunits; k<n*(unit+1)/nunits; k++)
+        {
+            const ShowdownScenario& s = scenarios[order[k]];
+            const PokerHandEvaluator& peval =
+                *evaluators[static_cast<unsigned char>(s.game)];
+            workers[w]->enumerate (s, peval, results[order[k]]);
+        }
+    });
+}
+
+}
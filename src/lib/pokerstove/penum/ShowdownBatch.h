@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PENUM_SHOWDOWNBATCH_H_
+#define PENUM_SHOWDOWNBATCH_H_
+
+#include <cstdint>
+#include <vector>
+#include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/PokerHandEvaluator.h>
+
+namespace pokerstove
+{
+/**
+ * A small showdown to enumerate: a game, one hand per player, a board and
+ * some dead cards.  Hands and the board may be partial, or empty, and are
+ * completed by the enumeration.  Dead cards are never dealt.  It is plain
+ * data of a fixed size, so that batches of them can be laid out in one
+ * contiguous block.
+ */
+struct ShowdownScenario
+{
+    static const size_t MAX_PLAYERS = 10;
+
+    ShowdownScenario ()
+        : game('h')
+        , nplayers(0)
+    {}
+
+    char    game;                   //!< game id, as for PokerHandEvaluator::alloc
+    uint8_t nplayers;
+    CardSet hands[MAX_PLAYERS];
+    CardSet board;
+    CardSet dead;
+};
+
+/**
+ * the shares of each player of a ShowdownScenario
+ */
+struct ShowdownBatchResult
+{
+    EquityResult shares[ShowdownScenario::MAX_PLAYERS];
+};
+
+/**
+ * Enumerates many small showdowns, such as turn and river spots, for
+ * which the set up of a ShowdownEnumerator call would cost more than the
+ * enumeration itself.  The scenarios are ordered by game, so that each
+ * evaluator is allocated once and used for a run of scenarios, and the
+ * runs are spread across the threads.  Each thread keeps its deck, hand
+ * buffers and partition enumerators from one scenario to the next.
+ *
+ * The shares are the same as those ShowdownEnumerator gives for the same
+ * hands and board, when there are no dead cards.
+ */
+class ShowdownBatch
+{
+public:
+    ShowdownBatch ();
+
+    /**
+     * enumerate the n scenarios, and write their shares to results, which
+     * must have room for n.  Throws std::invalid_argument if a scenario
+     * has too many players or cards, or cards which are used twice.
+     */
+    void calculateEquity (const ShowdownScenario* scenarios, size_t n,
+                          ShowdownBatchResult* results) const;
+
+    std::vector<ShowdownBatchResult>
+    calculateEquity (const std::vector<ShowdownScenario>& scenarios) const;
+
+    /**
+     * set the number of threads calculateEquity uses, zero means one per
+     * core.  The default is a single thread.
+     */
+    void setNumThreads (size_t nthreads);
+    size_t numThreads () const;
+
+private:
+    size_t _numThreads;
+};
+}
+
+#endif  // PENUM_SHOWDOWNBATCH_H_
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "ShowdownBatch.h"
+#include "ShowdownEnumerator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+ShowdownScenario scenario(char game, const char* a, const char* b,
+                          const char* board, const char* dead="")
+{
+    ShowdownScenario s;
+    s.game = game;
+    s.nplayers = 2;
+    s.hands[0] = CardSet(a);
+    s.hands[1] = CardSet(b);
+    s.board = CardSet(board);
+    s.dead = CardSet(dead);
+    return s;
+}
+
+void expectSameShares(const vector<EquityResult>& expected,
+                      const ShowdownBatchResult& actual)
+{
+    for (size_t i=0; i<expected.size(); i++)
+    {
+        EXPECT_DOUBLE_EQ(expected[i].winShares, actual.shares[i].winShares);
+        EXPECT_DOUBLE_EQ(expected[i].tieShares, actual.shares[i].tieShares);
+    }
+}
+
+vector<ShowdownScenario> mixedScenarios()
+{
+    vector<ShowdownScenario> scenarios;
+    scenarios.push_back(scenario('h', "AsKs", "QdQh", "9s8s7h"));
+    scenarios.push_back(scenario('O', "AsKsQhJh", "TdTc9d9c", "8s7s6h"));
+    scenarios.push_back(scenario('h', "AsKs", "QdQh", "9s8s7hTd"));
+    scenarios.push_back(scenario('s', "AsKsQsJs9c8c", "AhKhQh6d6c6h", ""));
+    scenarios.push_back(scenario('h', "AsKs", "", "9s8s7hTd6c"));
+    scenarios.push_back(scenario('h', "AsKs", "QdQh", "9s8s7hTdJs"));
+    scenarios.push_back(scenario('O', "AsKsQhJh", "TdTc9d9c", "8s7s6hKd"));
+    return scenarios;
+}
+}
+
+TEST(ShowdownBatch, MatchesShowdownEnumerator) {
+    vector<ShowdownScenario> scenarios = mixedScenarios();
+    ShowdownEnumerator showdown;
+    vector<vector<EquityResult> > expected;
+    for (size_t i=0; i<scenarios.size(); i++)
+    {
+        const ShowdownScenario& s = scenarios[i];
+        vector<CardDistribution> dists;
+        for (size_t p=0; p<s.nplayers; p++)
+            dists.push_back(CardDistribution(s.hands[p]));
+        expected.push_back(showdown.calculateEquity(dists, s.board,
+                           PokerHandEvaluator::alloc(string(1, s.game))));
+    }
+
+    for (size_t nthreads=1; nthreads<4; nthreads++)
+    {
+        ShowdownBatch batch;
+        batch.setNumThreads(nthreads);
+        vector<ShowdownBatchResult> results = batch.calculateEquity(scenarios);
+        ASSERT_EQ(scenarios.size(), results.size());
+        for (size_t i=0; i<scenarios.size(); i++)
+            expectSameShares(expected[i], results[i]);
+    }
+}
+
+TEST(ShowdownBatch, DeadCardsAreNotDealt) {
+    // the rivers which are not dead, as a board distribution
+    CardSet dead("As9c8c");
+    CardSet turn("Ts9s8s7h");
+    CardSet live;
+    live.fill();
+    live.remove(dead | turn | CardSet("KsQsJdJh"));
+    CardDistribution rivers;
+    rivers.fill(live, 1);
+    string list;
+    for (size_t i=0; i<rivers.size(); i++)
+        list += (i ? "," : "") + (rivers[i] | turn).str();
+    CardDistribution boards;
+    ASSERT_TRUE(boards.parse(list));
+    ASSERT_EQ(STANDARD_DECK_SIZE-11, boards.size());
+
+    vector<CardDistribution> dists;
+    dists.push_back(CardDistribution(CardSet("KsQs")));
+    dists.push_back(CardDistribution(CardSet("JdJh")));
+    vector<EquityResult> expected = ShowdownEnumerator().calculateEquity(
+        dists, boards, PokerHandEvaluator::alloc("h"));
+
+    vector<ShowdownScenario> scenarios(1, scenario('h', "KsQs", "JdJh", "Ts9s8s7h", "As9c8c"));
+    vector<ShowdownBatchResult> results = ShowdownBatch().calculateEquity(scenarios);
+    expectSameShares(expected, results[0]);
+    EXPECT_DOUBLE_EQ(STANDARD_DECK_SIZE-11.0,
+                     results[0].shares[0].winShares + results[0].shares[0].tieShares +
+                     results[0].shares[1].winShares + results[0].shares[1].tieShares);
+}
+
+TEST(ShowdownBatch, RejectsBadScenarios) {
+    ShowdownBatch batch;
+    vector<ShowdownScenario> scenarios(1, scenario('h', "AsKs", "AsQs", ""));
+    EXPECT_THROW(batch.calculateEquity(scenarios), invalid_argument);
+    scenarios[0] = scenario('h', "AsKs", "QsJs", "", "Ks");
+    EXPECT_THROW(batch.calculateEquity(scenarios), invalid_argument);
+    scenarios[0] = scenario('z', "AsKs", "QsJs", "");
+    EXPECT_THROW(batch.calculateEquity(scenarios), invalid_argument);
+    scenarios[0] = scenario('h', "AsKsQs", "JsTs", "");
+    EXPECT_THROW(batch.calculateEquity(scenarios), invalid_argument);
+    scenarios[0].nplayers = 0;
+    EXPECT_THROW(batch.calculateEquity(scenarios), invalid_argument);
+}
@@ -3,14 +3,18 @@
  */
 #include "ShowdownEnumerator.h"
 
+#include "DisjointOdometer.h"
 #include "Odometer.h"
 #include "PartitionEnumerator.h"
 #include "SimpleDeck.hpp"
+#include "SuitSymmetry.h"
+#include "WorkStealingPool.h"
 #include <boost/algorithm/string.hpp>
-#include <boost/math/special_functions/binomial.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
+#include <atomic>
+#include <stdexcept>
 #include <pokerstove/util/combinations.h>
 #include <pokerstove/peval/Card.h>
 #include <pokerstove/peval/Suit.h>
@@ -20,13 +24,71 @@
 namespace pokerstove {
 
 ShowdownEnumerator::ShowdownEnumerator ()
+    : _numThreads(1)
+    , _suitIsomorphism(false)
+    , _allowSampledTable(false)
 {
 
 }
 
+void ShowdownEnumerator::setNumThreads (size_t nthreads)
+{
+    _numThreads = nthreads;
+}
+
+size_t ShowdownEnumerator::numThreads () const
+{
+    return _numThreads;
+}
+
+void ShowdownEnumerator::setSuitIsomorphism (bool use)
+{
+    _suitIsomorphism = use;
+}
+
+bool ShowdownEnumerator::suitIsomorphism () const
+{
+    return _suitIsomorphism;
+}
+
+void ShowdownEnumerator::setEquityTable (boost::shared_ptr<const EquityTable> table,
+                                         bool allowSampled)
+{
+    _equityTable = table;
+    _allowSampledTable = allowSampled;
+}
+
+boost::shared_ptr<const EquityTable> ShowdownEnumerator::equityTable () const
+{
+    return _equityTable;
+}
+
+void ShowdownEnumerator::setDeadCards (const CardSet& dead)
+{
+    _deadCards = dead;
+}
+
+const CardSet& ShowdownEnumerator::deadCards () const
+{
+    return _deadCards;
+}
+
 vector<EquityResult> ShowdownEnumerator::calculateEquityFuzz (const vector<string>& inputs,
                                                               const CardSet& board,
                                                               boost::shared_ptr<PokerHandEvaluator> peval) const
+{
+    // calcuate the results and print them
+    return calculateEquity(parseFuzzDistributions(inputs), board, peval);
+}
+
+vector<EquityResult> ShowdownEnumerator::calculateEquityFuzz (const vector<string>& inputs,
+                                                              const CardDistribution& boards,
+                                                              boost::shared_ptr<PokerHandEvaluator> peval) const
+{
+    return calculateEquity(parseFuzzDistributions(inputs), boards, peval);
+}
+
+vector<CardDistribution> ShowdownEnumerator::parseFuzzDistributions (const vector<string>& inputs) const
 {
     vector<CardDistribution> handDists;
     for (const string& input : inputs) {
@@ -34,9 +96,7 @@ vector<EquityResult> ShowdownEnumerator::calculateEquityFuzz (const vector<strin
         handDists.emplace_back();
         handDists.back().parse(hand);
     }
-
-    // calcuate the results and print them
-    return calculateEquity(handDists, board, peval);
+    return handDists;
 }
 
 string ShowdownEnumerator::parseFuzzInput(const std::string& input) const
@@ -171,96 +231,375 @@ set<CardSet> ShowdownEnumerator::extendHandCard(const std::string& hand) const
     return handCards;
 }
 
+namespace
+{
+// aim for this many work units per thread, so that there is something
+// left to steal when the units turn out to be uneven
+const size_t UNITS_PER_THREAD = 16;
+
+// marks a work unit which covers all of the board partitions
+const size_t ALL_LEADS = PartitionEnumeratorCache::ALL_LEADS;
+
+// how often a controlled enumeration polls its control within a tuple,
+// in runouts, a power of two
+const uint64_t POLL_INTERVAL = 4096;
+
+/**
+ * The inner loop of a showdown enumeration along with its scratch space.
+ * Each worker thread gets its own, so nothing touched in the loop is
+ * shared between threads.
+ *
+ * The odometer runs over the boards first and then the hands, so that
+ * all of the tuples on one board come together.  The deck without the
+ * board is built once per board, and the partition enumerators are kept
+ * by the shape of their partitions, so each one is built once per class
+ * of boards and only reset for the tuples after that.
+ */
+class ShowdownWorker
+{
+public:
+    /**
+     * levels holds the board distribution followed by the hand
+     * distributions, board is the fixed board of games without one, and
+     * the dead cards are never dealt
+     */
+    ShowdownWorker (const vector<CardDistribution>& levels,
+                    const CardSet& board,
+                    const CardSet& dead,
+                    const PokerHandEvaluator& peval,
+                    bool suitIsomorphism)
+        : _levels(levels)
+        , _board(board)
+        , _dead(dead)
+        , _peval(peval)
+        , _ndists(levels.size()-1)
+        , _nboards(peval.boardSize() > 0 ? 1 : 0)
+        , _handsize(peval.handSize())
+        , _boardsize(peval.boardSize())
+        , _suitIsomorphism(suitIsomorphism)
+        , _ehands(_ndists+_nboards)
+        , _parts(_ndists+_nboards)
+        , _cardPartitions(_ndists+_nboards)
+        , _evals(_ndists)                    // NO BOARD
+        , _odometer(levels, dead)
+        , _boardIndex(levels[0].size())
+        , _evaluations(0)
+        , _stopped(false)
+    {}
+
+    /**
+     * enumerate the tuples [first..last) in odometer order, visiting only
+     * the board partitions with the given lead, unless the lead is
+     * ALL_LEADS.  The shares are accumulated in results.
+     *
+     * With a control, the enumeration stops when asked to, and the shares
+     * of the tuple it was in are dropped, so that the results are exact
+     * for the tuples before it.  Returns how much of the space the
+     * results cover, in tuples.
+     */
+    double enumerate (size_t first, size_t last, size_t lead, EquityResult* results,
+                      const EnumerationControl* control=NULL)
+    {
+        _stopped = false;
+
+        // the odometer only stops on tuples of hands which do not share
+        // any cards with each other or the board, a lead of a tuple which
+        // is skipped covers an even share of it
+        const double skipped = (lead == ALL_LEADS ? last-first : 1.0/STANDARD_DECK_SIZE);
+        if (!_odometer.seek (first) || _odometer.index() >= last)
+            return skipped;
+
+        // controlled tuples are accumulated on the side until they finish
+        EquityResult* shares = results;
+        if (control)
+        {
+            _scratch.assign (_ndists, EquityResult());
+            shares = &_scratch[0];
+        }
+        for (;;)
+        {
+
+            if (_odometer[0] != _boardIndex)
+                setupBoard (_odometer[0]);
+
+            CardSet hands;
+            for (size_t i=0; i<_ndists; i++)
+            {
+                _cardPartitions[i] = _levels[i+1][_odometer[i+1]];
+                _parts[i]          = _handsize-_cardPartitions[i].size();
+                hands |= _cardPartitions[i];
+            }
+
+            // find the suit permutations which leave the dealt and dead
+            // cards alone, the runouts they relate only need to be
+            // evaluated once
+            if (_suitIsomorphism)
+            {
+                _fixedSets.assign (_cardPartitions.begin(), _cardPartitions.end());
+                _fixedSets.push_back (_dead);
+                _symmetry.reset (&_fixedSets[0], _fixedSets.size());
+            }
+
+            // the deck starts in order for each tuple, so that the order
+            // of the live cards, and so the boards each lead covers, does
+            // not depend on what this worker did before
+            _deck = SimpleDeck();
+            _deck.remove (hands | _boardDead);
+            size_t nleads = PartitionEnumerator2::numLeads (_deck.size(), _parts);
+            uint64_t before = _evaluations;
+            if ((lead == ALL_LEADS || lead < nleads) &&
+                !showdowns (_enumerators.get (_deck.size(), _parts, lead), _odometer.weight(), shares, control))
+            {
+                _stopped = true;
+                _evaluations = before;
+                return (lead == ALL_LEADS ? _odometer.index()-first : 0.0);
+            }
+            if (control)
+            {
+                for (size_t i=0; i<_ndists; i++)
+                    results[i] += _scratch[i];
+                _scratch.assign (_ndists, EquityResult());
+            }
+            if (lead != ALL_LEADS)
+                return PartitionEnumerator2::leadShare (_deck.size(), _parts, lead);
+
+            if (!_odometer.next () || _odometer.index() >= last)
+                break;
+        }
+        return static_cast<double>(last-first);
+    }
+
+    /**
+     * true if the last call to enumerate was stopped by its control
+     */
+    bool stopped () const
+    {
+        return _stopped;
+    }
+
+    /**
+     * the number of runouts evaluated so far, not counting those of
+     * dropped tuples
+     */
+    uint64_t evaluations () const
+    {
+        return _evaluations;
+    }
+
+private:
+    // the set up shared by all of the tuples on a board
+    void setupBoard (size_t index)
+    {
+        _boardIndex = index;
+        _boardDead = _dead;
+        if (_nboards > 0)
+        {
+            const CardSet& board = _levels[0][index];
+            _cardPartitions[_ndists] = board;
+            _parts[_ndists]          = _boardsize-board.size();
+            _boardDead |= board;
+        }
+    }
+
+    // returns false if the control asked to stop part way through
+    bool showdowns (PartitionEnumerator2& pe, double weight, EquityResult* results,
+                    const EnumerationControl* control)
+    {
+        // copy quickness
+        CardSet * copydest = &_ehands[0];
+        CardSet * copysrc = &_cardPartitions[0];
+        size_t ncopy = (_ndists+_nboards)*sizeof(CardSet);
+        bool symmetric = _suitIsomorphism && _symmetry.order() > 1;
+        double w = weight;
+        do
+        {
+            // we use memcpy here for a little speed bonus
+            memcpy (copydest, copysrc, ncopy);
+            for (size_t p=0; p<_ndists+_nboards; p++)
+                _ehands[p] |= _deck.peek(pe.getMask (p));
+
+            // only evaluate the canonical runout of each suit class, and
+            // weight it by the size of the class
+            if (symmetric)
+            {
+                size_t m = _symmetry.multiplicity (&_ehands[0], _ndists+_nboards);
+                if (m == 0)
+                    continue;
+                w = weight*m;
+            }
+
+            if (control && (_evaluations & (POLL_INTERVAL-1)) == 0 &&
+                control->stopRequested())
+                return false;
+
+            // TODO: do we need this if/else, or can we just use the if
+            // clause? A: need to rework tracking of whether a board is needed
+            _evaluations++;
+            if (_nboards > 0)
+                _peval.evaluateShowdown (_ehands, _ehands[_ndists], _evals, results, w);
+            else
+                _peval.evaluateShowdown (_ehands, _board, _evals, results, w);
+        }
+        while (pe.next ());
+        return true;
+    }
+
+    const vector<CardDistribution>& _levels;
+    const CardSet& _board;
+    const CardSet& _dead;
+    const PokerHandEvaluator& _peval;
+    const size_t _ndists;
+    const size_t _nboards;
+    const size_t _handsize;
+    const size_t _boardsize;
+    const bool _suitIsomorphism;
+
+    // for the most part, these are allocated here to avoid contant stack
+    // reallocation as we cycle through the inner loops
+    SimpleDeck                  _deck;
+    CardSet                     _boardDead;     //!< the board and dead cards
+    vector<CardSet>             _ehands;
+    vector<size_t>              _parts;
+    vector<CardSet>             _cardPartitions;
+    vector<PokerHandEvaluation> _evals;
+    SuitSymmetry                _symmetry;
+    vector<CardSet>             _fixedSets;     //!< what _symmetry leaves alone
+    DisjointOdometer            _odometer;
+    size_t                      _boardIndex;    //!< board of the set up
+    uint64_t                    _evaluations;
+    bool                        _stopped;
+    vector<EquityResult>        _scratch;       //!< shares of the tuple
+    PartitionEnumeratorCache    _enumerators;
+};
+}
+
 vector<EquityResult> ShowdownEnumerator::calculateEquity (const vector<CardDistribution>& dists,
                                                           const CardSet& board,
-                                                          boost::shared_ptr<PokerHandEvaluator> peval) const
+                                                          boost::shared_ptr<PokerHandEvaluator> peval,
+                                                          EnumerationControl* control) const
+{
+    return calculateEquity (dists, CardDistribution(board), peval, control);
+}
+
+vector<EquityResult> ShowdownEnumerator::calculateEquity (const vector<CardDistribution>& dists,
+                                                          const CardDistribution& boards,
+                                                          boost::shared_ptr<PokerHandEvaluator> peval,
+                                                          EnumerationControl* control) const
 {
     if (peval.get() == NULL)
         throw runtime_error("ShowdownEnumerator, null evaluator");
     assert(dists.size() > 0);
     const size_t ndists = dists.size();
     vector<EquityResult> results(ndists, EquityResult());
-    size_t handsize = peval->handSize();
+    if (control)
+        control->start ();
 
-    // the dsizes vector is a list of the sizes of the player hand
-    // distributions
-    vector<size_t> dsizes;
-    for (size_t i=0; i<ndists; i++)
+    // games without a board take the one board as it is, and do not
+    // enumerate it
+    CardSet board;
+    vector<CardDistribution> levels(1, boards);
+    if (peval->boardSize() == 0)
     {
-        assert(dists[i].size() > 0);
-        dsizes.push_back (dists[i].size());
+        if (boards.size() != 1)
+            throw invalid_argument("ShowdownEnumerator, board distribution for a game without a board");
+        board = boards[0];
+        levels[0] = CardDistribution();
     }
+    else
+    {
+        for (size_t i=0; i<boards.size(); i++)
+            if (boards[i].size() > peval->boardSize())
+                throw invalid_argument("ShowdownEnumerator, board too large: " + boards[i].str());
+        if (boards.size() == 1)
+            board = boards[0];
+    }
+    levels.insert (levels.end(), dists.begin(), dists.end());
 
-    // need to figure out the board stuff, we'll be rolling the board into
-    // the partitions to make enumeration easier down the line.
-    size_t nboards = 0;
-    size_t boardsize = peval->boardSize();
-    if (boardsize > 0)
-        nboards++;
-
-    // for the most part, these are allocated here to avoid contant stack
-    // reallocation as we cycle through the inner loops
-    SimpleDeck deck;
-    CardSet dead;
-    double weight;
-    vector<CardSet>             ehands         (ndists+nboards);
-    vector<size_t>              parts          (ndists+nboards);
-    vector<CardSet>             cardPartitions (ndists+nboards);
-    vector<PokerHandEvaluation> evals          (ndists);         // NO BOARD
-
-    // copy quickness
-    CardSet * copydest = &ehands[0];
-    CardSet * copysrc = &cardPartitions[0];
-    size_t ncopy = (ndists+nboards)*sizeof(CardSet);
-    Odometer o(dsizes);
-    do
+    // heads up queries with single hands and no board may be in the table,
+    // sampled tables answer only when asked to
+    if (_equityTable && (_equityTable->exact() || _allowSampledTable) &&
+        ndists == 2 && boards.size() == 1 && board.size() == 0 &&
+        _deadCards.size() == 0 &&
+        dists[0].size() == 1 && dists[1].size() == 1 &&
+        _equityTable->matches(*peval))
     {
-        // colect all the cards being used by the players, skip out in the
-        // case of card duplication
-        bool disjoint = true;
-        dead.clear ();
-        weight = 1.0;
-        for (size_t i=0; i<ndists+nboards; i++)
+        const CardSet& a = dists[0][0];
+        const CardSet& b = dists[1][0];
+        double weight = dists[0][a]*dists[1][b]*boards[board];
+        if (_equityTable->lookup(a, b, results[0], results[1], weight) ||
+            _equityTable->lookup(b, a, results[1], results[0], weight))
         {
-            if (i<ndists)
-            {
-                cardPartitions[i] = dists[i][o[i]];
-                parts[i]          = handsize-cardPartitions[i].size();
-                weight           *= dists[i][cardPartitions[i]];
-            }
-            else
-            {
-                // this allows us to have board distributions in the future
-                cardPartitions[i] = board;
-                parts[i]          = boardsize-cardPartitions[i].size();
-            }
-            disjoint = disjoint && dead.disjoint(cardPartitions[i]);
-            dead |= cardPartitions[i];
+            if (control)
+                control->finish (true);
+            return results;
         }
+    }
+
+    // the dsizes vector is a list of the sizes of the board and player
+    // hand distributions
+    vector<size_t> dsizes;
+    for (size_t i=0; i<levels.size(); i++)
+    {
+        assert(levels[i].size() > 0);
+        dsizes.push_back (levels[i].size());
+    }
+    const size_t ntuples = Odometer(dsizes).count();
+
+    WorkStealingPool pool(_numThreads);
+    const size_t nthreads = pool.size();
+    if (nthreads == 1 && control == NULL)
+    {
+        ShowdownWorker worker(levels, board, _deadCards, *peval, _suitIsomorphism);
+        worker.enumerate (0, ntuples, ALL_LEADS, &results[0]);
+        return results;
+    }
 
-        if (disjoint)
+    // The work units are ranges of hand tuples.  When there are too few
+    // tuples to keep the threads busy, each tuple is split further by the
+    // lead card of its board partitions.  Those units are numbered lead
+    // first, since the low leads have the most boards to enumerate.
+    const size_t target = nthreads*UNITS_PER_THREAD;
+    const bool splitBoards = ntuples < target;
+    const size_t nunits = splitBoards ? ntuples*STANDARD_DECK_SIZE : target;
+
+    // each worker accumulates into its own stretch of shares, separated
+    // by at least a cache line so that the workers never share one
+    const size_t stride = paddedStride<EquityResult>(ndists);
+    vector<EquityResult> shares(stride*nthreads, EquityResult());
+
+    // workers are created by the thread which uses them.  Once the
+    // control asks to stop, the units not yet started are skipped, and
+    // those in progress drop the tuple they are in.
+    vector<boost::shared_ptr<ShowdownWorker> > workers(nthreads);
+    atomic<bool> stopped(false);
+    pool.run (nunits, [&](size_t unit, size_t w)
+    {
+        if (control && control->stopRequested())
         {
-            deck.reset ();
-            deck.remove (dead);
-            PartitionEnumerator2 pe(deck.size(), parts);
-            do
-            {
-                // we use memcpy here for a little speed bonus
-                memcpy (copydest, copysrc, ncopy);
-                for (size_t p=0; p<ndists+nboards; p++)
-                    ehands[p] |= deck.peek(pe.getMask (p));
-
-                // TODO: do we need this if/else, or can we just use the if
-                // clause? A: need to rework tracking of whether a board is needed
-                if (nboards > 0)
-                    peval->evaluateShowdown (ehands, ehands[ndists], evals, results, weight);
-                else
-                    peval->evaluateShowdown (ehands, board, evals, results, weight);
-            }
-            while (pe.next ());
+            stopped = true;
+            return;
         }
-    }
-    while (o.next ());
+        if (!workers[w])
+            workers[w].reset (new ShowdownWorker(levels, board, _deadCards, *peval, _suitIsomorphism));
+        uint64_t before = workers[w]->evaluations();
+        double covered;
+        if (splitBoards)
+            covered = workers[w]->enumerate (unit%ntuples, unit%ntuples+1,
+                                             unit/ntuples, &shares[w*stride], control);
+        else
+            covered = workers[w]->enumerate (ntuples*unit/nunits, ntuples*(unit+1)/nunits,
+                                             ALL_LEADS, &shares[w*stride], control);
+        if (workers[w]->stopped())
+            stopped = true;
+        if (control)
+            control->report (covered/ntuples, workers[w]->evaluations()-before);
+    });
+    if (control)
+        control->finish (!stopped);
+
+    for (size_t w=0; w<nthreads; w++)
+        for (size_t i=0; i<ndists; i++)
+            results[i] += shares[w*stride+i];
 
     return results;
 }
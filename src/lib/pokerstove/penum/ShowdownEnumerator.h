@@ -11,6 +11,8 @@
 #include <pokerstove/peval/Suit.h>
 #include <pokerstove/peval/Rank.h>
 #include "CardDistribution.h"
+#include "EnumerationControl.h"
+#include "EquityTable.h"
 
 #include <set>
 
@@ -24,11 +26,27 @@ namespace pokerstove
             ShowdownEnumerator ();
 
             /**
-             * enumerate a poker scenario, with board support
+             * enumerate a poker scenario, with board support.  With a
+             * control the enumeration reports its progress, and may be
+             * cut short, in which case the results cover only part of the
+             * scenario, see EnumerationControl.
              */
             vector<EquityResult> calculateEquity (const std::vector<CardDistribution>& dists,
                                                        const CardSet& board,
-                                                       boost::shared_ptr<PokerHandEvaluator> peval) const;
+                                                       boost::shared_ptr<PokerHandEvaluator> peval,
+                                                       EnumerationControl* control=NULL) const;
+
+            /**
+             * enumerate a poker scenario over a weighted distribution of
+             * partial boards, such as the flops with a flush draw.  Each
+             * board is completed by the enumeration, and its showdowns are
+             * scaled by its weight.  Games without a board only accept a
+             * single board.
+             */
+            vector<EquityResult> calculateEquity (const std::vector<CardDistribution>& dists,
+                                                       const CardDistribution& boards,
+                                                       boost::shared_ptr<PokerHandEvaluator> peval,
+                                                       EnumerationControl* control=NULL) const;
 
             /**
              * enumerate a poker scenario, with board support and fuzz input
@@ -37,6 +55,61 @@ namespace pokerstove
                                                        const CardSet& board,
                                                        boost::shared_ptr<PokerHandEvaluator> peval) const;
 
+            /**
+             * enumerate a poker scenario, with a board distribution and
+             * fuzz input
+             */
+            vector<EquityResult> calculateEquityFuzz (const vector<std::string>& dists,
+                                                       const CardDistribution& boards,
+                                                       boost::shared_ptr<PokerHandEvaluator> peval) const;
+
+            /**
+             * translate fuzz input into card distributions
+             */
+            vector<CardDistribution> parseFuzzDistributions (const vector<std::string>& inputs) const;
+
+            /**
+             * set the number of threads calculateEquity uses, zero means
+             * one per core.  The default is a single thread.
+             */
+            void setNumThreads (size_t nthreads);
+
+            /**
+             * the number of threads calculateEquity uses, zero means one
+             * per core.
+             */
+            size_t numThreads () const;
+
+            /**
+             * When set, calculateEquity evaluates only one runout from each
+             * set of runouts which are the same up to a permutation of the
+             * suits the dealt cards leave interchangeable, and weights it
+             * by the size of the set.  Off by default.
+             */
+            void setSuitIsomorphism (bool use);
+            bool suitIsomorphism () const;
+
+            /**
+             * Use a precomputed table to answer heads up queries with a
+             * single hand per player (or a hand against random) and an
+             * empty board, for evaluators which the table matches.  Pass
+             * a null pointer to go back to enumerating everything.
+             *
+             * Only exact tables stand in for the enumeration by default.
+             * The shares of a sampled table, one which is not exact(), are
+             * estimates, so it answers only if allowSampled is set.
+             */
+            void setEquityTable (boost::shared_ptr<const EquityTable> table,
+                                 bool allowSampled=false);
+            boost::shared_ptr<const EquityTable> equityTable () const;
+
+            /**
+             * cards which are out of play, they are never dealt, and hands
+             * which hold them are skipped.  None by default.
+             */
+            void setDeadCards (const CardSet& dead);
+            const CardSet& deadCards () const;
+
         private:
             /**
              * translate input into fuzz match hands cards.
@@ -52,6 +125,12 @@ namespace pokerstove
              * generate the cardset within the range.
              */
             set<CardSet> generateRange(Rank a, Rank l, Rank r, char m, bool pair) const;
+
+            size_t _numThreads;
+            bool _suitIsomorphism;
+            boost::shared_ptr<const EquityTable> _equityTable;
+            bool _allowSampledTable;
+            CardSet _deadCards;
     };
 }
 
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include "ShowdownBatch.h"
+#include "ShowdownEnumerator.h"
+#include "SuitSymmetry.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+vector<EquityResult> threadedEquity(const vector<string>& hands,
+                                    const string& board,
+                                    size_t nthreads,
+                                    bool iso=false)
+{
+    vector<CardDistribution> dists(hands.size());
+    for (size_t i=0; i<hands.size(); i++)
+        dists[i].parse(hands[i]);
+    ShowdownEnumerator showdown;
+    showdown.setNumThreads(nthreads);
+    showdown.setSuitIsomorphism(iso);
+    return showdown.calculateEquity(dists, CardSet(board),
+                                    PokerHandEvaluator::alloc("h"));
+}
+
+void expectSameResults(const vector<EquityResult>& a,
+                       const vector<EquityResult>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i=0; i<a.size(); i++)
+    {
+        EXPECT_NEAR(a[i].winShares, b[i].winShares, 1e-6*a[i].winShares);
+        EXPECT_NEAR(a[i].tieShares, b[i].tieShares, 1e-6*a[i].tieShares);
+    }
+}
+}
+
+TEST(ShowdownEnumerator, ThreadedPreflopMatchesSingleThread) {
+    // a single matchup, so the boards are split across the threads
+    vector<string> hands;
+    hands.push_back("AsKs");
+    hands.push_back("QdQh");
+    vector<EquityResult> single = threadedEquity(hands, "", 1);
+    EXPECT_NEAR(201376.0,
+                single[0].winShares + single[0].tieShares +
+                single[1].winShares + single[1].tieShares, 1e-6);
+    expectSameResults(single, threadedEquity(hands, "", 3));
+}
+
+TEST(ShowdownEnumerator, ThreadedRangesMatchSingleThread) {
+    // enough matchups that whole ranges of them are handed out
+    vector<string> hands;
+    hands.push_back("AsAh,AsAd,AhAd,KsKh,KsKd,KhKd,AsKs,AhKh,AdKd");
+    hands.push_back("QsQh,QsQd,QhQd,JsJh,JsJd,JhJd,QsJs,QhJh,QdJd,TsTh");
+    vector<EquityResult> single = threadedEquity(hands, "9c8c7h", 1);
+    expectSameResults(single, threadedEquity(hands, "9c8c7h", 4));
+    expectSameResults(single, threadedEquity(hands, "9c8c7h", 0));
+}
+
+TEST(ShowdownEnumerator, ThreadedFewRangesMatchSingleThread) {
+    // few matchups with different dead cards, so each worker splits
+    // several of them by lead card
+    vector<string> hands;
+    hands.push_back("AsAh,KsKh,QsJs");
+    hands.push_back("QdQh,JsTh");
+    vector<EquityResult> single = threadedEquity(hands, "9c8c", 1);
+    for (size_t t=2; t<6; t++)
+        expectSameResults(single, threadedEquity(hands, "9c8c", t));
+}
+
+TEST(ShowdownEnumerator, ThreadedHandVsRangeMatchesSingleThread) {
+    // a hand against a few hands, so the boards are split, and a worker
+    // runs tuples with different dead cards one after another
+    vector<string> hands;
+    hands.push_back("AsKs");
+    hands.push_back("QsQh,QsQd,QsQc,QhQd,QhQc,QdQc");
+    vector<EquityResult> single = threadedEquity(hands, "", 1);
+    for (size_t t=2; t<=8; t*=2)
+        expectSameResults(single, threadedEquity(hands, "", t));
+
+    hands.push_back("JsJh,JdJc,TsTh");
+    single = threadedEquity(hands, "", 1);
+    expectSameResults(single, threadedEquity(hands, "", 8));
+}
+
+TEST(ShowdownEnumerator, SuitSymmetryGroupOrder) {
+    SuitSymmetry sym;
+    vector<CardSet> suited;
+    suited.push_back(CardSet("AhKh"));
+    suited.push_back(CardSet("QsQc"));
+    sym.reset(&suited[0], suited.size());
+    EXPECT_EQ(2, sym.order());
+
+    vector<CardSet> alone;
+    alone.push_back(CardSet("AhKh"));
+    sym.reset(&alone[0], alone.size());
+    EXPECT_EQ(6, sym.order());
+
+    vector<CardSet> offsuit;
+    offsuit.push_back(CardSet("AhKd"));
+    offsuit.push_back(CardSet("QsQc"));
+    sym.reset(&offsuit[0], offsuit.size());
+    EXPECT_EQ(2, sym.order());
+}
+
+TEST(ShowdownEnumerator, SuitIsomorphismMatchesFullEnumeration) {
+    vector<string> hands;
+    hands.push_back("AhKh");
+    hands.push_back("QsQc");
+    expectSameResults(threadedEquity(hands, "", 1),
+                      threadedEquity(hands, "", 1, true));
+    expectSameResults(threadedEquity(hands, "", 1),
+                      threadedEquity(hands, "", 2, true));
+
+    hands.push_back("7d6d");
+    expectSameResults(threadedEquity(hands, "Ts", 1),
+                      threadedEquity(hands, "Ts", 1, true));
+
+    hands.clear();
+    hands.push_back("AsAh,AsAd,AhAd,KsKh");
+    hands.push_back(".");
+    expectSameResults(threadedEquity(hands, "9c8c7h", 1),
+                      threadedEquity(hands, "9c8c7h", 1, true));
+}
+
+TEST(ShowdownEnumerator, BoardDistributionIsWeightedSumOfBoards) {
+    // boards of several sizes, one of which collides with a hand
+    const char* boards[] = { "9c8c7h", "9c8c", "KdTsJs", "As" };
+    const double weights[] = { 2.0, 1.0, 0.5, 1.5 };
+    CardDistribution dist;
+    dist.parse("9c8c7h=2,9c8c,KdTsJs=0.5,As=1.5");
+    ASSERT_EQ(4, dist.size());
+
+    vector<CardDistribution> dists(2);
+    dists[0].parse("AsAh,KsKh,QsJs");
+    dists[1].parse("QdQh,JsTh");
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> expected(2, EquityResult());
+    for (size_t b=0; b<4; b++)
+    {
+        vector<EquityResult> r = showdown.calculateEquity(dists, CardSet(boards[b]), peval);
+        for (size_t i=0; i<2; i++)
+        {
+            expected[i].winShares += r[i].winShares*weights[b];
+            expected[i].tieShares += r[i].tieShares*weights[b];
+        }
+    }
+    expectSameResults(expected, showdown.calculateEquity(dists, dist, peval));
+
+    showdown.setNumThreads(3);
+    expectSameResults(expected, showdown.calculateEquity(dists, dist, peval));
+}
+
+TEST(ShowdownEnumerator, BoardDistributionChecksBoards) {
+    vector<CardDistribution> dists(2);
+    dists[0].parse("AsAh");
+    dists[1].parse("QdQh");
+    CardDistribution boards;
+    boards.parse("9c8c7h6h6d6c");
+    ShowdownEnumerator showdown;
+    EXPECT_THROW(showdown.calculateEquity(dists, boards, PokerHandEvaluator::alloc("h")),
+                 invalid_argument);
+}
+
+TEST(ShowdownEnumerator, DeadCardsMatchBatch) {
+    vector<CardDistribution> dists(2);
+    dists[0].parse("KsQs");
+    dists[1].parse("JdJh");
+    ShowdownEnumerator showdown;
+    showdown.setDeadCards(CardSet("As9c8c"));
+    vector<EquityResult> results =
+        showdown.calculateEquity(dists, CardSet("Ts9s8s7h"), PokerHandEvaluator::alloc("h"));
+
+    ShowdownScenario s;
+    s.nplayers = 2;
+    s.hands[0] = CardSet("KsQs");
+    s.hands[1] = CardSet("JdJh");
+    s.board = CardSet("Ts9s8s7h");
+    s.dead = CardSet("As9c8c");
+    ShowdownBatchResult batch;
+    ShowdownBatch().calculateEquity(&s, 1, &batch);
+    for (size_t i=0; i<2; i++)
+    {
+        EXPECT_DOUBLE_EQ(batch.shares[i].winShares, results[i].winShares);
+        EXPECT_DOUBLE_EQ(batch.shares[i].tieShares, results[i].tieShares);
+    }
+
+    // the dead cards may not be in a hand or on the board
+    showdown.setDeadCards(CardSet("Ks"));
+    vector<EquityResult> none =
+        showdown.calculateEquity(dists, CardSet("Ts9s8s7h"), PokerHandEvaluator::alloc("h"));
+    EXPECT_DOUBLE_EQ(0, none[0].winShares + none[0].tieShares +
+                        none[1].winShares + none[1].tieShares);
+}
@@ -0,0 +1,334 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "ShowdownSampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+namespace pokerstove {
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+// the samples are drawn from this many independent streams, each with its
+// own generator, which are spread across the threads
+const size_t NUM_STREAMS = 16;
+
+// the stopping rules are checked after each round of this many samples
+const uint64_t SAMPLES_PER_ROUND = 16*1024;
+
+// how often a stream looks at the clock, in samples
+const uint64_t DEADLINE_POLL = 256;
+
+// give up if the distributions keep colliding, they are probably disjoint
+const uint64_t MAX_REJECTIONS = 1000000;
+
+uint64_t splitmix64 (uint64_t& x)
+{
+    uint64_t z = (x += UINT64_C(0x9e3779b97f4a7c15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+}
+
+/**
+ * xorshift128+, small, fast, and plenty good enough for dealing cards
+ */
+class FastRandom
+{
+public:
+    explicit FastRandom (uint64_t seed)
+    {
+        _s[0] = splitmix64 (seed);
+        _s[1] = splitmix64 (seed);
+    }
+
+    uint64_t next ()
+    {
+        uint64_t s1 = _s[0];
+        const uint64_t s0 = _s[1];
+        _s[0] = s0;
+        s1 ^= s1 << 23;
+        _s[1] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+        return _s[1] + s0;
+    }
+
+    // uniform in [0..n), n must be less than 2^32
+    size_t below (size_t n)
+    {
+        return static_cast<size_t>(((next() >> 32) * n) >> 32);
+    }
+
+    // uniform in [0..1)
+    double uniform ()
+    {
+        return static_cast<double>(next() >> 11) * (1.0/9007199254740992.0);
+    }
+
+private:
+    uint64_t _s[2];
+};
+
+/**
+ * One stream of samples, with its own generator, scratch space and
+ * running sums.
+ */
+class SampleStream
+{
+public:
+    SampleStream (const vector<CardDistribution>& dists,
+                  const vector<vector<double> >& cumulative,
+                  const CardSet& board,
+                  const PokerHandEvaluator& peval,
+                  uint64_t seed)
+        : totals(dists.size(), EquityResult())
+        , _dists(dists)
+        , _cumulative(cumulative)
+        , _board(board)
+        , _peval(peval)
+        , _ndists(dists.size())
+        , _nboards(peval.boardSize() > 0 ? 1 : 0)
+        , _random(seed)
+        , _ehands(_ndists+_nboards)
+        , _evals(_ndists)
+        , _scratch(_ndists, EquityResult())
+    {}
+
+    /**
+     * draw up to n samples, stopping early once the deadline passes.
+     * returns the number of samples drawn.
+     */
+    uint64_t draw (uint64_t n, const Clock::time_point* deadline)
+    {
+        const size_t handsize = _peval.handSize();
+        const size_t boardsize = _peval.boardSize();
+        uint64_t k = 0;
+        for (; k<n; k++)
+        {
+            if (deadline && k%DEADLINE_POLL == 0 && Clock::now() >= *deadline)
+                break;
+
+            // pick a hand from each distribution, starting over if any
+            // two collide, so that each disjoint tuple is drawn in
+            // proportion to the product of its weights
+            CardSet dead;
+            uint64_t rejections = 0;
+            for (bool disjoint=false; !disjoint; )
+            {
+                dead = _board;
+                disjoint = true;
+                for (size_t i=0; disjoint && i<_ndists; i++)
+                {
+                    _ehands[i] = pick (i);
+                    disjoint = dead.disjoint (_ehands[i]);
+                    dead |= _ehands[i];
+                }
+                if (!disjoint && ++rejections > MAX_REJECTIONS)
+                    throw runtime_error("ShowdownSampler, distributions rarely disjoint");
+            }
+
+            // deal the rest of the cards from the live ones
+            _nlive = 0;
+            for (size_t c=0; c<STANDARD_DECK_SIZE; c++)
+                if (((dead.mask() >> c) & 0x01) == 0)
+                    _live[_nlive++] = static_cast<uint8_t>(c);
+            _dealt = 0;
+            for (size_t i=0; i<_ndists; i++)
+                _ehands[i] |= deal (handsize - _ehands[i].size());
+            if (_nboards > 0)
+                _ehands[_ndists] = _board | deal (boardsize - _board.size());
+
+            fill (_scratch.begin(), _scratch.end(), EquityResult());
+            _peval.evaluateShowdown (_ehands, _nboards > 0 ? _ehands[_ndists] : _board,
+                                     _evals, &_scratch[0]);
+
+            for (size_t i=0; i<_ndists; i++)
+            {
+                double e = _scratch[i].winShares + _scratch[i].tieShares;
+                totals[i].winShares += _scratch[i].winShares;
+                totals[i].tieShares += _scratch[i].tieShares;
+                totals[i].equity    += e;
+                totals[i].equity2   += e*e;
+            }
+        }
+        return k;
+    }
+
+    vector<EquityResult> totals;        //!< sums, not means
+
+private:
+    CardSet pick (size_t i)
+    {
+        const vector<double>& cum = _cumulative[i];
+        if (cum.size() == 1)
+            return _dists[i][0];
+        double u = _random.uniform() * cum.back();
+        size_t index = upper_bound (cum.begin(), cum.end(), u) - cum.begin();
+        return _dists[i][min(index, cum.size()-1)];
+    }
+
+    // a partial Fisher-Yates shuffle of the live cards
+    CardSet deal (size_t ncards)
+    {
+        if (_dealt+ncards > _nlive)
+            throw runtime_error("ShowdownSampler, not enough cards to deal");
+        uint64_t mask = 0;
+        for (size_t i=0; i<ncards; i++, _dealt++)
+        {
+            size_t j = _dealt + _random.below (_nlive-_dealt);
+            swap (_live[_dealt], _live[j]);
+            mask |= UINT64_C(1) << _live[_dealt];
+        }
+        return CardSet(mask);
+    }
+
+    const vector<CardDistribution>& _dists;
+    const vector<vector<double> >& _cumulative;
+    const CardSet& _board;
+    const PokerHandEvaluator& _peval;
+    const size_t _ndists;
+    const size_t _nboards;
+
+    FastRandom                  _random;
+    vector<CardSet>             _ehands;
+    vector<PokerHandEvaluation> _evals;
+    vector<EquityResult>        _scratch;
+    uint8_t                     _live[STANDARD_DECK_SIZE];
+    size_t                      _nlive;
+    size_t                      _dealt;
+};
+
+double standardErrorOf (const EquityResult& mean, uint64_t samples)
+{
+    if (samples == 0)
+        return 0.0;
+    double variance = max(0.0, mean.equity2 - mean.equity*mean.equity);
+    return sqrt(variance/static_cast<double>(samples));
+}
+}
+
+ShowdownSampler::ShowdownSampler ()
+    : _numThreads(1)
+    , _targetStandardError(0.0)
+    , _timeBudget(0.0)
+    , _maxSamples(1000000)
+    , _seed(UINT64_C(0x5eed))
+    , _samples(0)
+{
+}
+
+void     ShowdownSampler::setNumThreads (size_t nthreads)   { _numThreads = nthreads; }
+size_t   ShowdownSampler::numThreads () const               { return _numThreads; }
+void     ShowdownSampler::setTargetStandardError (double se) { _targetStandardError = se; }
+double   ShowdownSampler::targetStandardError () const      { return _targetStandardError; }
+void     ShowdownSampler::setTimeBudget (double seconds)    { _timeBudget = seconds; }
+double   ShowdownSampler::timeBudget () const               { return _timeBudget; }
+void     ShowdownSampler::setMaxSamples (uint64_t n)        { _maxSamples = n; }
+uint64_t ShowdownSampler::maxSamples () const               { return _maxSamples; }
+void     ShowdownSampler::setSeed (uint64_t seed)           { _seed = seed; }
+uint64_t ShowdownSampler::seed () const                     { return _seed; }
+uint64_t ShowdownSampler::samples () const                  { return _samples; }
+
+double ShowdownSampler::standardError (const EquityResult& result) const
+{
+    return standardErrorOf (result, _samples);
+}
+
+pair<double,double> ShowdownSampler::confidenceInterval (const EquityResult& result,
+                                                         double z) const
+{
+    double delta = z*standardError (result);
+    return make_pair (result.equity-delta, result.equity+delta);
+}
+
+vector<EquityResult> ShowdownSampler::calculateEquity (const vector<CardDistribution>& dists,
+                                                       const CardSet& board,
+                                                       boost::shared_ptr<PokerHandEvaluator> peval)
+{
+    if (peval.get() == NULL)
+        throw runtime_error("ShowdownSampler, null evaluator");
+    if (dists.empty())
+        throw invalid_argument("ShowdownSampler, no distributions");
+    const size_t ndists = dists.size();
+    if (ndists*peval->handSize() + peval->boardSize() > STANDARD_DECK_SIZE)
+        throw invalid_argument("ShowdownSampler, too many players for the deck");
+
+    // the cumulative weights are used to pick hands in proportion to
+    // their weights
+    vector<vector<double> > cumulative(ndists);
+    for (size_t i=0; i<ndists; i++)
+    {
+        double total = 0.0;
+        for (size_t j=0; j<dists[i].size(); j++)
+        {
+            total += dists[i][dists[i][j]];
+            cumulative[i].push_back (total);
+        }
+        if (!(total > 0.0))
+            throw invalid_argument("ShowdownSampler, distribution without weight");
+    }
+
+    uint64_t seeder = _seed;
+    vector<boost::shared_ptr<SampleStream> > streams;
+    for (size_t s=0; s<NUM_STREAMS; s++)
+        streams.push_back (boost::shared_ptr<SampleStream>(
+            new SampleStream(dists, cumulative, board, *peval, splitmix64(seeder))));
+
+    Clock::time_point deadline = Clock::now() +
+        chrono::duration_cast<Clock::duration>(chrono::duration<double>(_timeBudget));
+    const Clock::time_point* pdeadline = (_timeBudget > 0.0 ? &deadline : NULL);
+
+    WorkStealingPool pool(_numThreads);
+    vector<EquityResult> results;
+    _samples = 0;
+    for (;;)
+    {
+        uint64_t round = min(SAMPLES_PER_ROUND, _maxSamples-_samples);
+        if (round == 0)
+            break;
+
+        vector<uint64_t> drawn(NUM_STREAMS, 0);
+        pool.run (NUM_STREAMS, [&](size_t s, size_t)
+        {
+            uint64_t n = round*(s+1)/NUM_STREAMS - round*s/NUM_STREAMS;
+            drawn[s] = streams[s]->draw (n, pdeadline);
+        });
+        for (size_t s=0; s<NUM_STREAMS; s++)
+            _samples += drawn[s];
+
+        // turn the sums into means
+        results.assign (ndists, EquityResult());
+        for (size_t s=0; s<NUM_STREAMS; s++)
+            for (size_t i=0; i<ndists; i++)
+                results[i] += streams[s]->totals[i];
+        for (size_t i=0; _samples > 0 && i<ndists; i++)
+        {
+            results[i].equity  /= static_cast<double>(_samples);
+            results[i].equity2 /= static_cast<double>(_samples);
+        }
+
+        if (pdeadline && Clock::now() >= deadline)
+            break;
+        if (_targetStandardError > 0.0)
+        {
+            double worst = 0.0;
+            for (size_t i=0; i<ndists; i++)
+                worst = max(worst, standardErrorOf (results[i], _samples));
+            if (worst <= _targetStandardError)
+                break;
+        }
+    }
+
+    if (results.empty())
+        results.assign (ndists, EquityResult());
+    return results;
+}
+
+}
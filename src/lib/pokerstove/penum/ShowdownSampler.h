@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PENUM_SHOWDOWNSAMPLER_H_
+#define PENUM_SHOWDOWNSAMPLER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/peval/PokerHandEvaluator.h>
+#include "CardDistribution.h"
+
+namespace pokerstove
+{
+/**
+ * A Monte Carlo alternative to the ShowdownEnumerator, for scenarios which
+ * are too large to enumerate.  Hands are drawn from the distributions in
+ * proportion to their weights, and the rest of the cards are dealt at
+ * random.  Sampling stops at the first of these to happen:
+ *
+ * - the standard error of every player's equity is below the target
+ * - the time budget is used up
+ * - the maximum number of samples has been drawn
+ *
+ * In the returned results winShares and tieShares are summed over all of
+ * the samples, equity is the mean equity per sample, and equity2 is the
+ * mean of the squared equity per sample.
+ *
+ * Each of a fixed number of streams has its own random number generator,
+ * so for a given seed the results do not depend on the number of threads,
+ * unless a time budget cuts the run short.
+ */
+class ShowdownSampler
+{
+public:
+    ShowdownSampler ();
+
+    /**
+     * sample a poker scenario, with board support
+     */
+    std::vector<EquityResult> calculateEquity (const std::vector<CardDistribution>& dists,
+                                               const CardSet& board,
+                                               boost::shared_ptr<PokerHandEvaluator> peval);
+
+    void   setNumThreads (size_t nthreads);         //!< zero means one per core
+    size_t numThreads () const;
+
+    void   setTargetStandardError (double se);      //!< zero to disable
+    double targetStandardError () const;
+
+    void   setTimeBudget (double seconds);          //!< zero to disable
+    double timeBudget () const;
+
+    void     setMaxSamples (uint64_t n);
+    uint64_t maxSamples () const;
+
+    void     setSeed (uint64_t seed);
+    uint64_t seed () const;
+
+    /**
+     * the number of samples drawn by the last call to calculateEquity
+     */
+    uint64_t samples () const;
+
+    /**
+     * the standard error of the mean equity of a result of the last call
+     * to calculateEquity
+     */
+    double standardError (const EquityResult& result) const;
+
+    /**
+     * the normal approximation confidence interval of the equity of a
+     * result of the last call to calculateEquity, z=1.96 gives 95%
+     */
+    std::pair<double,double> confidenceInterval (const EquityResult& result,
+                                                 double z=1.96) const;
+
+private:
+    size_t   _numThreads;
+    double   _targetStandardError;
+    double   _timeBudget;
+    uint64_t _maxSamples;
+    uint64_t _seed;
+    uint64_t _samples;
+};
+}
+
+#endif  // PENUM_SHOWDOWNSAMPLER_H_
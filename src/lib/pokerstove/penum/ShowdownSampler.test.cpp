@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "ShowdownEnumerator.h"
+#include "ShowdownSampler.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+vector<CardDistribution> parseHands(const string& a, const string& b)
+{
+    vector<CardDistribution> dists(2);
+    dists[0].parse(a);
+    dists[1].parse(b);
+    return dists;
+}
+}
+
+TEST(ShowdownSampler, AgreesWithEnumeration) {
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+
+    ShowdownEnumerator showdown;
+    vector<EquityResult> exact = showdown.calculateEquity(dists, CardSet(), peval);
+    double total = 0.0;
+    for (size_t i=0; i<exact.size(); i++)
+        total += exact[i].winShares + exact[i].tieShares;
+
+    ShowdownSampler sampler;
+    sampler.setMaxSamples(50000);
+    vector<EquityResult> sampled = sampler.calculateEquity(dists, CardSet(), peval);
+    EXPECT_EQ(50000, sampler.samples());
+    for (size_t i=0; i<sampled.size(); i++)
+    {
+        double equity = (exact[i].winShares + exact[i].tieShares)/total;
+        EXPECT_NEAR(equity, sampled[i].equity, 5*sampler.standardError(sampled[i]));
+        EXPECT_NEAR(sampled[i].equity*50000,
+                    sampled[i].winShares + sampled[i].tieShares, 1e-6);
+        EXPECT_GE(sampled[i].equity2, sampled[i].equity*sampled[i].equity);
+        pair<double,double> ci = sampler.confidenceInterval(sampled[i]);
+        EXPECT_LT(ci.first, sampled[i].equity);
+        EXPECT_GT(ci.second, sampled[i].equity);
+    }
+}
+
+TEST(ShowdownSampler, ResultsDoNotDependOnThreads) {
+    vector<CardDistribution> dists = parseHands("AsAh,KsKh,QsQh", ".");
+    boost::shared_ptr<PokerHandEvaluator> peval = PokerHandEvaluator::alloc("h");
+
+    ShowdownSampler sampler;
+    sampler.setMaxSamples(20000);
+    sampler.setSeed(42);
+    vector<EquityResult> single = sampler.calculateEquity(dists, CardSet("9c8c7h"), peval);
+    sampler.setNumThreads(3);
+    vector<EquityResult> threaded = sampler.calculateEquity(dists, CardSet("9c8c7h"), peval);
+    for (size_t i=0; i<single.size(); i++)
+    {
+        EXPECT_EQ(single[i].winShares, threaded[i].winShares);
+        EXPECT_EQ(single[i].tieShares, threaded[i].tieShares);
+        EXPECT_EQ(single[i].equity2, threaded[i].equity2);
+    }
+}
+
+TEST(ShowdownSampler, StopsAtTargetStandardError) {
+    vector<CardDistribution> dists = parseHands("AsKs", "QdQh");
+    ShowdownSampler sampler;
+    sampler.setMaxSamples(10000000);
+    sampler.setTargetStandardError(0.005);
+    vector<EquityResult> results =
+        sampler.calculateEquity(dists, CardSet(), PokerHandEvaluator::alloc("h"));
+    EXPECT_LT(sampler.samples(), 10000000);
+    for (size_t i=0; i<results.size(); i++)
+        EXPECT_LE(sampler.standardError(results[i]), 0.005);
+}
+
+TEST(ShowdownSampler, RejectsDisjointDistributions) {
+    vector<CardDistribution> dists = parseHands("AsKs", "AsQs");
+    ShowdownSampler sampler;
+    EXPECT_THROW(sampler.calculateEquity(dists, CardSet(), PokerHandEvaluator::alloc("h")),
+                 runtime_error);
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ * $Id$
+ */
+#ifndef PENUM_SUITSYMMETRY_H_
+#define PENUM_SUITSYMMETRY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/Rank.h>
+#include <pokerstove/peval/Suit.h>
+
+namespace pokerstove
+{
+/**
+ * Tracks the suit permutations which leave a list of card sets unchanged,
+ * each set mapping onto itself.  Any two runouts related by one of these
+ * permutations give the same showdown, so only the smallest of each class
+ * needs to be evaluated, weighted by the number of runouts in the class.
+ *
+ * usage example:
+ *
+ *   SuitSymmetry sym;
+ *   sym.reset (fixed, nparts);             // hands and board as dealt
+ *   ...
+ *   size_t m = sym.multiplicity (runout, nparts);
+ *   if (m > 0)
+ *       evaluate runout with weight*m
+ */
+class SuitSymmetry
+{
+public:
+    SuitSymmetry ()
+    {
+        _perms.reserve (24);
+    }
+
+    /**
+     * find the permutations which fix each of the n card sets
+     */
+    void reset (const CardSet* sets, size_t n)
+    {
+        _perms.clear ();
+        int p[Suit::NUM_SUIT] = {0, 1, 2, 3};
+
+        // skip the identity, it is always in the group
+        while (std::next_permutation (p, p+Suit::NUM_SUIT))
+        {
+            Permutation perm(p);
+            bool fixes = true;
+            for (size_t i=0; fixes && i<n; i++)
+                fixes = (perm.apply (sets[i].mask()) == sets[i].mask());
+            if (fixes)
+                _perms.push_back (perm);
+        }
+    }
+
+    /**
+     * the number of permutations in the group, identity included
+     */
+    size_t order () const
+    {
+        return _perms.size()+1;
+    }
+
+    /**
+     * If the n card sets are the lexicographically smallest of all their
+     * images under the group, return the number of distinct images,
+     * otherwise return zero.
+     */
+    size_t multiplicity (const CardSet* sets, size_t n) const
+    {
+        size_t stabilizer = 1;
+        for (size_t i=0; i<_perms.size(); i++)
+        {
+            const Permutation& p = _perms[i];
+            int cmp = 0;
+            for (size_t j=0; cmp == 0 && j<n; j++)
+            {
+                uint64_t mask  = sets[j].mask();
+                uint64_t image = p.apply (mask);
+                if (image < mask)
+                    cmp = -1;
+                else if (mask < image)
+                    cmp = 1;
+            }
+            if (cmp < 0)
+                return 0;
+            if (cmp == 0)
+                stabilizer++;
+        }
+        return order()/stabilizer;
+    }
+
+private:
+    struct Permutation
+    {
+        explicit Permutation (const int* p)
+        {
+            for (size_t s=0; s<Suit::NUM_SUIT; s++)
+                shift[s] = p[s]*Rank::NUM_RANK;
+        }
+
+        // same as CardSet::rotateSuits, but cheap enough for the inner loop
+        uint64_t apply (uint64_t mask) const
+        {
+            const uint64_t SUIT_MASK = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+            return (( mask                      & SUIT_MASK) << shift[0] |
+                    ((mask >>   Rank::NUM_RANK) & SUIT_MASK) << shift[1] |
+                    ((mask >> 2*Rank::NUM_RANK) & SUIT_MASK) << shift[2] |
+                    ((mask >> 3*Rank::NUM_RANK) & SUIT_MASK) << shift[3]);
+        }
+
+        unsigned shift[Suit::NUM_SUIT]; //!< new bit offset of each suit
+    };
+
+    std::vector<Permutation> _perms;    //!< the group, less the identity
+};
+} // namespace pokerstove
+
+#endif  // PENUM_SUITSYMMETRY_H_
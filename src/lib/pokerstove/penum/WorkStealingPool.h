@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ * $Id$
+ */
+#ifndef PENUM_WORKSTEALINGPOOL_H_
+#define PENUM_WORKSTEALINGPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pokerstove
+{
+// used to keep data written by different threads on separate cache lines
+const size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * The distance between per thread arrays of n T's laid out in one block,
+ * such that there is at least a cache line between any two of them.
+ */
+template <class T>
+size_t paddedStride (size_t n)
+{
+    const size_t line = std::max<size_t>(1, CACHE_LINE_SIZE/sizeof(T));
+    return ((n+line-1)/line + 1)*line;
+}
+
+/**
+ * A simple work stealing scheduler for a fixed set of work units.
+ *
+ * The units [0..n) are split into one contiguous block per worker.  Each
+ * worker takes units from the front of its own block, and when it runs
+ * dry it steals the back half of the largest block left.  Units are known
+ * only by their index, so callers should number them from the most to the
+ * least expensive when they can, which keeps the tail of the run short.
+ *
+ * usage example:
+ *
+ *   WorkStealingPool pool(4);
+ *   pool.run(nunits, [&](size_t unit, size_t worker) { ... });
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * create a pool with nthreads workers, zero means one per core
+     */
+    explicit WorkStealingPool (size_t nthreads)
+        : _nthreads(nthreads == 0 ? hardwareThreads() : nthreads)
+    {}
+
+    static size_t hardwareThreads ()
+    {
+        size_t n = std::thread::hardware_concurrency();
+        return (n > 0 ? n : 1);
+    }
+
+    /**
+     * the number of workers in the pool
+     */
+    size_t size () const
+    {
+        return _nthreads;
+    }
+
+    /**
+     * Call f(unit, worker) for every unit in [0..nunits), and block until
+     * they are all done.  worker is in [0..size()) and no two calls with
+     * the same worker run at the same time, so it can be used to index
+     * per thread scratch space.  If a unit throws, the remaining units are
+     * abandoned and the first exception is rethrown here.
+     */
+    template <class Func>
+    void run (size_t nunits, Func f) const
+    {
+        size_t nworkers = std::min(_nthreads, nunits);
+        if (nworkers <= 1)
+        {
+            for (size_t u=0; u<nunits; u++)
+                f(u, 0);
+            return;
+        }
+
+        std::vector<Block> blocks(nworkers);
+        for (size_t w=0; w<nworkers; w++)
+        {
+            blocks[w].begin = nunits*w/nworkers;
+            blocks[w].end   = nunits*(w+1)/nworkers;
+        }
+
+        std::atomic<bool> abort(false);
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        std::vector<std::thread> threads;
+        for (size_t w=0; w<nworkers; w++)
+        {
+            threads.push_back(std::thread([&, w]()
+            {
+                try
+                {
+                    size_t unit;
+                    while (!abort.load(std::memory_order_relaxed) &&
+                           (pop(blocks, w, unit) || steal(blocks, w, unit)))
+                        f(unit, w);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> guard(errorLock);
+                    if (!error)
+                        error = std::current_exception();
+                    abort = true;
+                }
+            }));
+        }
+        for (size_t w=0; w<nworkers; w++)
+            threads[w].join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    // a range of units owned by one worker, padded so that the locks of
+    // different workers do not share a cache line
+    struct Block
+    {
+        Block() : begin(0), end(0) {}
+
+        std::mutex lock;
+        size_t begin;
+        size_t end;
+        char pad[CACHE_LINE_SIZE];
+    };
+
+    static bool pop (std::vector<Block>& blocks, size_t w, size_t& unit)
+    {
+        std::lock_guard<std::mutex> guard(blocks[w].lock);
+        if (blocks[w].begin >= blocks[w].end)
+            return false;
+        unit = blocks[w].begin++;
+        return true;
+    }
+
+    static bool steal (std::vector<Block>& blocks, size_t w, size_t& unit)
+    {
+        for (;;)
+        {
+            // find the victim with the most work left
+            size_t victim = blocks.size();
+            size_t most = 0;
+            for (size_t v=0; v<blocks.size(); v++)
+            {
+                if (v == w)
+                    continue;
+                std::lock_guard<std::mutex> guard(blocks[v].lock);
+                size_t left = blocks[v].end - blocks[v].begin;
+                if (left > most)
+                {
+                    most = left;
+                    victim = v;
+                }
+            }
+            if (victim == blocks.size())
+                return false;
+
+            // take the back half of its block, the victim may have been
+            // drained in the meantime, in which case we look again
+            size_t first, last;
+            {
+                std::lock_guard<std::mutex> guard(blocks[victim].lock);
+                size_t left = blocks[victim].end - blocks[victim].begin;
+                if (left == 0)
+                    continue;
+                last  = blocks[victim].end;
+                first = last - (left+1)/2;
+                blocks[victim].end = first;
+            }
+
+            std::lock_guard<std::mutex> guard(blocks[w].lock);
+            unit = first;
+            blocks[w].begin = first+1;
+            blocks[w].end   = last;
+            return true;
+        }
+    }
+
+    size_t _nthreads;
+};
+} // namespace pokerstove
+
+#endif  // PENUM_WORKSTEALINGPOOL_H_
@@ -5,6 +5,7 @@
 #ifndef PEVAL_BADUGIHANDEVALUATOR_H_
 #define PEVAL_BADUGIHANDEVALUATOR_H_
 
+#include "BadugiTable.h"
 #include "PokerHandEvaluator.h"
 
 namespace pokerstove
@@ -17,12 +18,13 @@ class BadugiHandEvaluator : public PokerHandEvaluator
 public:
     BadugiHandEvaluator()
         : PokerHandEvaluator()
+        , _table(BadugiTable::shared())
         , _numDraws(0)
     {}
 
     virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
     {
-        return PokerHandEvaluation(hand.evaluateBadugi());
+        return PokerHandEvaluation(_table.evaluate(hand));
     }
 
     virtual PokerEvaluation evaluateRanks(const CardSet& hand, const CardSet& board=CardSet(0)) const
@@ -42,6 +44,7 @@ public:
     virtual void setNumDraws(size_t sz) { _numDraws = sz; }
 
 private:
+    const BadugiTable& _table;
     size_t _numDraws;
 };
 
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "BadugiTable.h"
+
+#include <algorithm>
+#include <pokerstove/util/choose.h>
+#include <pokerstove/util/combinations.h>
+
+using namespace std;
+using namespace pokerstove;
+
+const size_t BadugiTable::MAX_CARDS;
+
+BadugiTable::BadugiTable ()
+{
+    for (size_t c=0; c<STANDARD_DECK_SIZE; c++)
+        for (size_t i=0; i<=MAX_CARDS; i++)
+            _choose[c][i] = choose (c, i+1);
+    for (size_t n=0, offset=0; n<=MAX_CARDS; n++)
+    {
+        _offsets[n] = offset;
+        offset += choose (STANDARD_DECK_SIZE, n);
+    }
+
+    // evaluate every hand, then number the distinct codes
+    vector<int> codes(numHands());
+    for (size_t n=0; n<=MAX_CARDS; n++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, n);
+        do
+        {
+            CardSet hand(hands.getMask());
+            size_t index = 0;
+            size_t i = 0;
+            for (uint64_t mask=hand.mask(); mask != 0; mask &= mask-1, i++)
+                index += _choose[lastbit64 (mask)][i];
+            codes[_offsets[n] + index] = hand.evaluateBadugi().code();
+        }
+        while (hands.next());
+    }
+
+    _codes = codes;
+    sort (_codes.begin(), _codes.end());
+    _codes.erase (unique (_codes.begin(), _codes.end()), _codes.end());
+    _classes.resize (codes.size());
+    for (size_t i=0; i<codes.size(); i++)
+        _classes[i] = static_cast<uint16_t>(
+            lower_bound (_codes.begin(), _codes.end(), codes[i]) - _codes.begin());
+}
+
+size_t BadugiTable::numHands ()
+{
+    size_t ret = 0;
+    for (size_t n=0; n<=MAX_CARDS; n++)
+        ret += choose (STANDARD_DECK_SIZE, n);
+    return ret;
+}
+
+const BadugiTable& BadugiTable::shared ()
+{
+    static const BadugiTable table;
+    return table;
+}
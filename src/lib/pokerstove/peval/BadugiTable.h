@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_BADUGITABLE_H_
+#define PEVAL_BADUGITABLE_H_
+
+#include <cstdint>
+#include <vector>
+#include <pokerstove/util/lastbit.h>
+#include "CardSet.h"
+#include "PokerEvaluation.h"
+
+namespace pokerstove
+{
+/**
+ * The badugi evaluation, CardSet::evaluateBadugi, of every hand of up to
+ * MAX_CARDS cards, so that an evaluation is one lookup in place of the
+ * search over the orders of the suits.
+ *
+ * A hand is compressed to its colex index among the hands of the same
+ * size, which is the sum of C(card, i+1) over its cards in increasing
+ * order, i counting from zero, plus an offset for the size.  There are
+ * only a few hundred badugi classes, so the table holds a uint16_t class
+ * per hand and a second table maps the classes back to codes, for about
+ * 130KB in all.
+ *
+ * Hands of more than MAX_CARDS cards are passed on to evaluateBadugi.
+ */
+class BadugiTable
+{
+public:
+    static const size_t MAX_CARDS = 4;
+
+    /**
+     * build the tables, which takes a few milliseconds
+     */
+    BadugiTable ();
+
+    PokerEvaluation evaluate (const CardSet& cards) const
+    {
+        uint64_t mask = cards.mask();
+        size_t index = 0;
+        size_t i = 0;
+        for (; mask != 0 && i <= MAX_CARDS; mask &= mask-1, i++)
+            index += _choose[lastbit64 (mask)][i];
+        if (i > MAX_CARDS)
+            return cards.evaluateBadugi();
+        return PokerEvaluation(_codes[_classes[_offsets[i] + index]]);
+    }
+
+    /**
+     * the number of hands of up to MAX_CARDS cards, the size of the class
+     * table
+     */
+    static size_t numHands ();
+
+    /**
+     * the number of distinct badugi evaluations
+     */
+    size_t numClasses () const { return _codes.size(); }
+
+    /**
+     * a table shared by the whole process, built on first use
+     */
+    static const BadugiTable& shared ();
+
+private:
+    size_t                _choose[STANDARD_DECK_SIZE][MAX_CARDS+1];  //!< C(card, i+1)
+    size_t                _offsets[MAX_CARDS+1];
+    std::vector<uint16_t> _classes;
+    std::vector<int>      _codes;
+};
+}
+
+#endif  // PEVAL_BADUGITABLE_H_
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <pokerstove/util/combinations.h>
+#include "BadugiTable.h"
+#include "PokerHandEvaluator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+TEST(BadugiTable, MatchesEvaluateBadugi) {
+    const BadugiTable& table = BadugiTable::shared();
+    for (size_t k=0; k<=BadugiTable::MAX_CARDS; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        size_t mismatches = 0;
+        do
+        {
+            CardSet hand(hands.getMask());
+            if (table.evaluate(hand) != hand.evaluateBadugi())
+                mismatches++;
+        }
+        while (hands.next());
+        EXPECT_EQ(0, mismatches) << k << " cards";
+    }
+
+    // larger hands are passed on
+    CardSet big("As9h8d7cKs");
+    EXPECT_EQ(big.evaluateBadugi(), table.evaluate(big));
+}
+
+TEST(BadugiTable, Sizes) {
+    EXPECT_EQ(1+36+630+7140+58905, BadugiTable::numHands());
+
+    // the empty hand, and each set of one to four ranks
+    EXPECT_EQ(1+9+36+84+126, BadugiTable::shared().numClasses());
+}
+
+TEST(BadugiTable, UsedByEvaluator) {
+    boost::shared_ptr<PokerHandEvaluator> eval = PokerHandEvaluator::alloc("b");
+    CardSet hand("Ac6d7h8s");
+    EXPECT_EQ(hand.evaluateBadugi(), eval->evaluateHand(hand, CardSet()).high());
+}
@@ -13,14 +13,16 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/math/special_functions/binomial.hpp>
+#include <pokerstove/util/choose.h>
 #include <pokerstove/util/combinations.h>
 #include "Rank.h"
 #include "Suit.h"
 #include "Card.h"
 #include "CardSet.h"
+#include "CardSetBitops.h"
 #include "PokerEvaluation.h"
 #include "PokerEvaluationTables.h"
+#include "SuitPermutation.h"
 
 using namespace std;
 using namespace boost;
@@ -126,24 +128,12 @@ size_t CardSet::countSuits() const
 
 size_t CardSet::countMaxSuit() const
 {
-    vector<size_t> suit(Suit::NUM_SUIT);
-    suit[0] = (nRanksTable[SMASK(0)]);
-    suit[1] = (nRanksTable[SMASK(1)]);
-    suit[2] = (nRanksTable[SMASK(2)]);
-    suit[3] = (nRanksTable[SMASK(3)]);
-
-    return *std::max_element(suit.begin(),suit.end());
+    return CardSetBitops::best().countMaxSuit(_cardmask);
 }
 
 size_t CardSet::size() const
 {
-    uint64_t v = _cardmask;
-    size_t c;
-    for (c = 0; v; c++)
-    {
-        v &= v - 1; // clear the least significant bit set
-    }
-    return c;
+    return CardSetBitops::best().size(_cardmask);
 }
 
 void CardSet::fromString(const string& instr)
@@ -184,91 +174,59 @@ void CardSet::flipSuits() {
 }
 
 CardSet CardSet::canonize() const {
-  int smasks[Suit::NUM_SUIT];
-  int i = 0;
-  for (Suit s = Suit::begin(); s < Suit::end(); ++s)
-    smasks[i++] = suitMask(s);
-
-  sort(smasks, smasks + Suit::NUM_SUIT);
-
-  return CardSet(
-          static_cast<uint64_t>(smasks[3]) |
-          static_cast<uint64_t>(smasks[2]) << Rank::NUM_RANK |
-          static_cast<uint64_t>(smasks[1]) << Rank::NUM_RANK * 2 |
-          static_cast<uint64_t>(smasks[0]) << Rank::NUM_RANK * 3);
+  return CardSet(canonizeSuits(_cardmask));
 }
 
 CardSet CardSet::canonize(const CardSet& other) const
 {
-    CardSet cother = other.canonize();
-    vector<int> perms = findSuitPermutation(other, cother);
-    CardSet hand = *this;
-    CardSet chand = hand.rotateSuits(perms[0],perms[1],perms[2],perms[3]);
-    return chand;
+    SuitPermutation perm;
+    canonizeSuits(other._cardmask, &perm);
+    return CardSet(permuteSuits(_cardmask, perm));
 }
 
-// This is super slow, make it faster
+// Each rank of rset is added to the free suits of that rank, lowest suit
+// first.  need[k] holds the ranks which still need more than k cards, and
+// each suit takes one card of each needed rank it has free, which moves
+// those ranks down a count.  There are no branches on the cards.
 bool CardSet::insertRanks(const CardSet& rset)
 {
-    // try the fastest way first
-    if ((_cardmask & rset._cardmask) == 0)
-    {
-        _cardmask |= rset._cardmask;
-        return true;
-    }
-
-    // now try shifting by flipping around suits
-    for (size_t s=1; s< Suit::NUM_SUIT; s++)
+    const uint64_t canon = rset.canonizeRanks()._cardmask;
+    int need[Suit::NUM_SUIT+1];
+    for (size_t k=0; k<Suit::NUM_SUIT; k++)
+        need[k] = static_cast<int>(canon >> k*Rank::NUM_RANK) & 0x1FF;
+    need[Suit::NUM_SUIT] = 0;
+
+    uint64_t added = 0;
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
     {
-        CardSet flipped(rset);
-        flipped.flipSuits();
-        if ((_cardmask & flipped._cardmask) == 0)
-        {
-            _cardmask |= flipped._cardmask;
-            return true;
-        }
+        const int add = need[0] & ~SMASK(s);
+        for (size_t k=0; k<Suit::NUM_SUIT; k++)
+            need[k] = (need[k] & ~add) | (need[k+1] & add);
+        added |= static_cast<uint64_t>(add) << s*Rank::NUM_RANK;
     }
 
-    // ok, just do it the slow way
-    for (Rank r=Rank::Six(); r<=Rank::Ace(); ++r)
-    {
-        size_t nrin = rset.count(r);
-        if (nrin == 0)
-            continue;
-
-        if (count(r) + nrin > Suit::NUM_SUIT)
-            return false;
-
-        for (Suit s=Suit::Clubs(); s<=Suit::Spades(); ++s)
-            //for (Suit s=Suit::Spades(); s>=Suit::Spades(); --s)
-        {
-            Card c(r,s);
-            if (!contains(c))
-            {
-                insert(c);
-                nrin--;
-            }
-            if (nrin == 0)
-                break;
-        }
-    }
+    // some rank would be held more than four times
+    if (need[0] != 0)
+        return false;
+    _cardmask |= added;
     return true;
 }
 
+// a rank held n times goes in the first n suits, so suit k holds the
+// ranks held more than k times
 CardSet CardSet::canonizeRanks() const {
-    // this is very slow, optimize if it winds up in an inner loop
-    CardSet ret;
-    string ranks = rankstr();
-    for (size_t i = 0; i < ranks.size(); i++) {
-        for (Suit s = Suit::Clubs(); s <= Suit::Spades(); ++s) {
-            Card candidate(Rank(ranks.substr(i, 1)), s);
-            if (!ret.contains(candidate)) {
-                ret.insert(candidate);
-                break;
-            }
-        }
-    }
-    return ret;
+    const uint64_t c = C();
+    const uint64_t d = D();
+    const uint64_t h = H();
+    const uint64_t s = S();
+    const uint64_t one   = c | d | h | s;
+    const uint64_t two   = (c&d) | (c&h) | (c&s) | (d&h) | (d&s) | (h&s);
+    const uint64_t three = (c & d & (h|s)) | (h & s & (c|d));
+    const uint64_t four  = c & d & h & s;
+    return CardSet(one |
+                   two   <<   Rank::NUM_RANK |
+                   three << 2*Rank::NUM_RANK |
+                   four  << 3*Rank::NUM_RANK);
 }
 
 CardSet& CardSet::insert(const Card& c)
@@ -349,7 +307,7 @@ int CardSet::rankMask() const
 
 size_t CardSet::countRanks() const
 {
-    return nRanksTable[C() | D() | H() | S()];
+    return CardSetBitops::best().countRanks(_cardmask);
 }
 
 int CardSet::suitMask(const Suit& s) const
@@ -402,163 +360,11 @@ bool CardSet::hasStraight() const
     return false;
 }
 
-// this is a rough draft of the evaluateHigh routine, the idea is that
-// it should be AFAP.  However, this is a general 1-7 card evaluator, so
-// it cannot be too fast.  We could unwrap the method calls here for the
-// PokerHand, maybe it would speed things up.
-//
-// note, there are no function calls in this function
 PokerEvaluation CardSet::evaluateHigh() const
 {
-    // first the easy stuff
-    int c = C();
-    int d = D();
-    int h = H();
-    int s = S();
-    int rankmask = c | d | h | s;
-    
-    // print for debugging. --bk
-    // cout << _cardmask << ":" << c << " " << d << " " << h << " " << s << ",";
-    
-    if (nRanksTableNo2TO5[rankmask] >= 5)
-    {
-        int sranks = 0;
-        int suitindex=-1;
-        if (nRanksTableNo2TO5[c] >= 5)
-        {
-            suitindex = Suit::ClubVal();
-            sranks = c;
-        }
-        else if (nRanksTableNo2TO5[d] >= 5)
-        {
-            suitindex = Suit::DiamondVal();
-            sranks = d;
-        }
-        else if (nRanksTableNo2TO5[h] >= 5)
-        {
-            suitindex = Suit::HeartVal();
-            sranks = h;
-        }
-        else if (nRanksTableNo2TO5[s] >= 5)
-        {
-            suitindex = Suit::SpadeVal();
-            sranks = s;
-        }
-        if (suitindex >= 0)
-        {
-            int strval = straightTableNo2TO5[sranks];
-            if (strval > 0)
-                return PokerEvaluation((STRAIGHT_FLUSH<<VSHIFT) ^ strval<<MAJOR_SHIFT);
-            else
-                return PokerEvaluation((FLUSH<<VSHIFT) ^ topFiveRanksTable[sranks]);
-        }
-        int strval = straightTableNo2TO5[rankmask];
-        if (strval > 0)
-            return PokerEvaluation((STRAIGHT<<VSHIFT) ^(strval<<MAJOR_SHIFT));
-    }
-
-    int ncards = nRanksTableNo2TO5[c] + nRanksTableNo2TO5[d] + nRanksTableNo2TO5[h] + nRanksTableNo2TO5[s];
-    int ndups = ncards - nRanksTableNo2TO5[rankmask];
-
-    switch (ndups)
-    {
-        case 0:     // no pair
-        {
-            return PokerEvaluation((NO_PAIR<<VSHIFT) ^ topFiveRanksTableNo2To5[rankmask]);
-        }
-        break;
-
-        case 1:     // one pair
-        {
-            int two_mask = rankmask ^(c ^ d ^ h ^ s);
-            int topind = topRankTableNo2To5[two_mask];
-            int kickers = topThreeRanksTableNo2To5[rankmask ^(0x01<<topind)];
-            return PokerEvaluation((ONE_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^ kickers);
-        }
-        break;
-
-        case 2:
-        {
-            int two_mask = rankmask ^(c ^ d ^ h ^ s);
-
-            if (two_mask)   // two pair
-            {
-                int topind = topRankTableNo2To5[two_mask];
-                int botind = botRankTableNo2To5[two_mask];
-                int kicker = topRankTableNo2To5[rankmask ^ two_mask];
-                if (kicker >= 0)
-                    return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT) ^(0x01<<kicker));
-                else
-                    return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
-            }
-            else
-            {
-                int three_mask =
-                    ((c&d)|(h&s)) &
-                    ((c&h)|(d&s));
-                int topind = topRankTableNo2To5[three_mask];
-                int kickers = rankmask ^(0x01<<topind);
-                int kbits = 0;
-                if (kickers > 0)
-                    kbits   = 0x01<<topRankTableNo2To5[kickers];
-                if (kbits >= 0 && ((kickers^kbits) > 0))
-                    kbits      ^= 0x01<<topRankTableNo2To5[kickers^kbits];
-                return PokerEvaluation((THREE_OF_A_KIND<<VSHIFT) ^(topind << MAJOR_SHIFT) ^ kbits);
-            }
-        }
-        break;
-
-        default:
-        {
-            int four_mask = c & d & h & s;
-            if (four_mask)
-            {
-                int topind = topRankTableNo2To5[four_mask];
-                int kicker = rankmask;
-                kicker ^= (0x01<<topind);
-                kicker  = topRankTableNo2To5[kicker];
-                if (kicker >= 0)
-                    return PokerEvaluation((FOUR_OF_A_KIND<<VSHIFT) ^(topind<<MAJOR_SHIFT) ^(0x01<<kicker));
-                else
-                    return PokerEvaluation((FOUR_OF_A_KIND<<VSHIFT) ^(topind<<MAJOR_SHIFT));
-            }
-
-            int two_mask = rankmask ^(c ^ d ^ h ^ s);
-            if (nRanksTableNo2TO5[two_mask] != ndups)
-            {
-                int three_mask =
-                    ((c&d)|(h&s)) &
-                    ((c&h)|(d&s));
-                int topind = topRankTableNo2To5[three_mask];
-                if (two_mask > 0)
-                {
-                    int botind = topRankTableNo2To5[two_mask];
-                    return PokerEvaluation((FULL_HOUSE<<VSHIFT) ^(topind<<MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
-                }
-                else
-                {
-                    int botind = topRankTableNo2To5[three_mask ^ 0x01<<topind];
-                    return PokerEvaluation((FULL_HOUSE<<VSHIFT) ^(topind<<MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
-                }
-            }
-
-            int topind = topRankTableNo2To5[two_mask];
-            int botind = topRankTableNo2To5[two_mask ^ 0x01<<topind];
-            int kicker = rankmask ^ 0x01<<topind ^ 0x01<<botind;
-            kicker  = topRankTableNo2To5[kicker];
-            if (kicker >= 0)
-                return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT) ^(0x01<<kicker));
-            else
-                return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
-        }
-        break;
-    }
-
-    cerr << "oops\n";
-    return PokerEvaluation(0);
+    return CardSetBitops::best().evaluateHigh(_cardmask);
 }
 
-
 // same as evaluateHigh, but with the non-flush logic
 // elided
 PokerEvaluation CardSet::evaluateHighFlush() const
@@ -1295,7 +1101,7 @@ bool CardSet::isTripped() const         // returns true if trips or quads
 
 size_t CardSet::count(const Suit& s) const
 {
-    return nRanksTable[SMASK(s.code())];
+    return CardSetBitops::best().countSuit(_cardmask, s.code());
 }
 
 Rank CardSet::flushRank(const Suit& s) const
@@ -1313,13 +1119,6 @@ Rank CardSet::bottomRank() const
     return Rank(botRankTable[RMASK()]);
 }
 
-double clampedChoose(int n, int m)
-{
-    if (n < m)
-        return 0;
-    return static_cast<size_t>(boost::math::binomial_coefficient<double>(n,m));
-}
-
 int CardSet::evaluateStraightOuts() const
 {
     int sval = straightTable[RMASK()];
@@ -1334,28 +1133,10 @@ int CardSet::evaluateStraightOuts() const
     return 0;
 }
 
-// original version in r2488
+// original version in r2488, now in CardSet_Bitops.cpp
 size_t CardSet::rankColex() const
 {
-    size_t ret  = 0;
-    int slot = 0;
-    int sz   = 1;
-    int c    = C();
-    int d    = D();
-    int h    = H();
-    int s    = S();
-    int rbit = 0x01;
-
-    for (int i=0; i<13; i++)
-    {
-        if (rbit&c) ret += clampedChoose(slot++,sz++);
-        if (rbit&d) ret += clampedChoose(slot++,sz++);
-        if (rbit&h) ret += clampedChoose(slot++,sz++);
-        if (rbit&s) ret += clampedChoose(slot++,sz++);
-        slot++;
-        rbit <<= 1;
-    }
-    return ret;
+    return CardSetBitops::best().rankColex(_cardmask);
 }
 
 std::ostream& operator<<(std::ostream& sout, const pokerstove::CardSet& e)
@@ -1386,10 +1167,9 @@ vector<int> pokerstove::findSuitPermutation(const CardSet& source, const CardSet
 
 CardSet pokerstove::canonizeToBoard(const CardSet& board, const CardSet& hand)
 {
-    CardSet cboard = board.canonize();
-    vector<int> perms = findSuitPermutation(board, cboard);
-    CardSet chand = hand.rotateSuits(perms[0],perms[1],perms[2],perms[3]);
-    return chand;
+    SuitPermutation perm;
+    canonizeSuits(board.mask(), &perm);
+    return CardSet(permuteSuits(hand.mask(), perm));
 }
 
 // some suit mask macros
@@ -1400,17 +1180,12 @@ CardSet pokerstove::canonizeToBoard(const CardSet& board, const CardSet& hand)
 #undef RMASK
 #undef SUITMASK
 
+// the sum of C(code, i+1) over the cards in increasing order, with
+// integer binomials and one pass over the bits
 size_t CardSet::colex() const {
-    vector<Card> cards = this->cards();
     size_t value = 0;
-    for (size_t i = 0; i < cards.size(); i++) {
-        size_t code = cards[i].code();
-#ifdef __AP_MATH__
-        value += tchoose(code, i+1);
-#else
-        if (code >= i + 1)
-            value += static_cast<size_t>(boost::math::binomial_coefficient<double>(code, i + 1));
-#endif
-    }
+    size_t i = 0;
+    for (uint64_t mask = _cardmask; mask != 0; mask &= mask-1)
+        value += static_cast<size_t>(choose (lastbit64 (mask), ++i));
     return value;
 }
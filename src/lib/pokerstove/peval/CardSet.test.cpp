@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+#include <vector>
+#include <pokerstove/util/choose.h>
+#include <pokerstove/util/combinations.h>
+#include "Card.h"
 #include "CardSet.h"
 
 TEST(CardSetTest, StringConstructorToString) {
@@ -75,3 +79,71 @@ TEST(CardSetTest, fill) {
     all.fill();
     EXPECT_EQ(STANDARD_DECK_SIZE, all.size());
 }
+
+TEST(CardSetTest, CanonizeRanksCounts) {
+    using namespace pokerstove;
+    // every hand from the top three ranks, the canonical form holds each
+    // rank in its lowest suits
+    const uint64_t top = UINT64_C(0x1C0);
+    const uint64_t mask = top | top<<9 | top<<18 | top<<27;
+    for (uint64_t m=mask; ; m=(m-1)&mask)
+    {
+        CardSet hand(m);
+        CardSet canon = hand.canonizeRanks();
+        EXPECT_EQ(hand.size(), canon.size());
+        EXPECT_EQ(hand.rankColex(), canon.rankColex());
+        for (Rank r=Rank::Six(); r<=Rank::Ace(); ++r)
+        {
+            size_t n = hand.count(r);
+            for (Suit s=Suit::Clubs(); s<=Suit::Spades(); ++s, n = (n > 0 ? n-1 : 0))
+                EXPECT_EQ(n > 0, canon.contains(Card(r, s))) << hand.str();
+        }
+        if (m == 0)
+            break;
+    }
+}
+
+TEST(CardSetTest, InsertRanks) {
+    using namespace pokerstove;
+    CardSet hand("AcKd");
+    EXPECT_TRUE(hand.insertRanks(CardSet("AdAhQs")));
+    EXPECT_EQ(CardSet("AcKdAdAhQc"), hand);
+
+    // the ranks of the board go in the free suits, and the rank counts add
+    CardSet full("AcAdAhKc");
+    EXPECT_TRUE(full.insertRanks(CardSet("AsKcKd")));
+    EXPECT_EQ(4, full.count(Rank::Ace()));
+    EXPECT_EQ(3, full.count(Rank::King()));
+
+    // too many of a rank leaves the hand as it was
+    CardSet over("AcAdAh");
+    EXPECT_FALSE(over.insertRanks(CardSet("AcAdKh")));
+    EXPECT_EQ(CardSet("AcAdAh"), over);
+
+    CardSet empty;
+    EXPECT_TRUE(empty.insertRanks(CardSet("9c9d6s")));
+    EXPECT_EQ(CardSet("9c9d6s").canonizeRanks(), empty);
+}
+
+TEST(CardSetTest, Colex) {
+    using namespace pokerstove;
+    EXPECT_EQ(0u, CardSet().colex());
+
+    // the hands of each size are numbered from zero, in colex order
+    for (size_t k=1; k<=3; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        std::vector<bool> seen;
+        do
+        {
+            size_t index = CardSet(hands.getMask()).colex();
+            ASSERT_LT(index, choose(STANDARD_DECK_SIZE, k));
+            if (index >= seen.size())
+                seen.resize(index+1, false);
+            EXPECT_FALSE(seen[index]);
+            seen[index] = true;
+        }
+        while (hands.next());
+        EXPECT_EQ(choose(STANDARD_DECK_SIZE, k), seen.size());
+    }
+}
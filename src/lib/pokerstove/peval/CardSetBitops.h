@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_CARDSETBITOPS_H_
+#define PEVAL_CARDSETBITOPS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "PokerEvaluation.h"
+
+namespace pokerstove
+{
+/**
+ * The hot CardSet queries, as functions of the card mask, which CardSet
+ * calls through the table chosen by best():
+ * - portable:  counts bits with loops and the rank tables, runs anywhere
+ * - builtin:   compiled one function at a time for popcnt, lzcnt, tzcnt
+ *              and the bmi2 bit deposit, used when the cpu has them
+ *
+ * Both give the same answers for every mask.  The cpu is checked once,
+ * on first use, and only if the build found __builtin_cpu_supports (see
+ * HAVE_BUILTIN_CPU_SUPPORTS in Config.h).
+ */
+struct CardSetBitops
+{
+    const char* name;
+    size_t (*size)         (uint64_t mask);
+    size_t (*countRanks)   (uint64_t mask);
+    size_t (*countSuit)    (uint64_t mask, size_t suit);
+    size_t (*countMaxSuit) (uint64_t mask);
+    size_t (*rankColex)    (uint64_t mask);
+    PokerEvaluation (*evaluateHigh) (uint64_t mask);
+
+    static const CardSetBitops& portable ();
+
+    /**
+     * throws std::runtime_error if the build or the cpu lacks the
+     * instructions
+     */
+    static const CardSetBitops& builtin ();
+    static bool isBuiltinSupported ();
+
+    /**
+     * builtin if it is supported, else portable
+     */
+    static const CardSetBitops& best ();
+};
+}
+
+#endif  // PEVAL_CARDSETBITOPS_H_
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <pokerstove/util/combinations.h>
+#include "CardSet.h"
+#include "CardSetBitops.h"
+#include "Suit.h"
+
+using namespace pokerstove;
+using namespace std;
+
+TEST(CardSetBitops, BuiltinMatchesPortable) {
+    if (!CardSetBitops::isBuiltinSupported())
+        return;
+    const CardSetBitops& a = CardSetBitops::portable();
+    const CardSetBitops& b = CardSetBitops::builtin();
+    for (size_t k=0; k<=7; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        size_t mismatches = 0;
+        do
+        {
+            uint64_t m = hands.getMask();
+            if (a.evaluateHigh(m) != b.evaluateHigh(m) ||
+                a.size(m) != b.size(m) ||
+                a.countRanks(m) != b.countRanks(m) ||
+                a.countMaxSuit(m) != b.countMaxSuit(m) ||
+                a.countSuit(m, k%Suit::NUM_SUIT) != b.countSuit(m, k%Suit::NUM_SUIT))
+                mismatches++;
+            // rankColex is slow in the portable form
+            if (k <= 4 && a.rankColex(m) != b.rankColex(m))
+                mismatches++;
+        }
+        while (hands.next());
+        EXPECT_EQ(0, mismatches) << k << " cards";
+    }
+
+    uint64_t deck = CardSet("AsAhAdAcKsKhKdKcQsQhQd9c6s6h6d6c").mask();
+    EXPECT_EQ(a.rankColex(deck), b.rankColex(deck));
+    deck = UINT64_C(0xfffffffff);
+    EXPECT_EQ(36, b.size(deck));
+    EXPECT_EQ(a.evaluateHigh(deck), b.evaluateHigh(deck));
+    EXPECT_EQ(a.rankColex(deck), b.rankColex(deck));
+}
+
+TEST(CardSetBitops, CardSetUsesBest) {
+    CardSet hand("AsKsQsJsTs9h");
+    const CardSetBitops& best = CardSetBitops::best();
+    EXPECT_EQ(hand.size(), best.size(hand.mask()));
+    EXPECT_EQ(hand.evaluateHigh(), best.evaluateHigh(hand.mask()));
+    EXPECT_EQ(hand.rankColex(), CardSetBitops::portable().rankColex(hand.mask()));
+}
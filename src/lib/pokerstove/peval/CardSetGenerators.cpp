@@ -3,7 +3,12 @@
  */
 #include "CardSetGenerators.h"
 #include "Card.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <pokerstove/util/choose.h>
 #include <pokerstove/util/combinations.h>
+#include "PokerEvaluationTables.h"
 
 namespace pokerstove
 {
@@ -39,4 +44,165 @@ createCardSet(size_t numCards, Card::Grouping grouping)
     return ret;
 }
 
+namespace
+{
+const size_t NUM_SUIT_MASKS = 1 << Rank::NUM_RANK;
+
+void visitRankSuit(size_t numCards, const CardSetVisitor& visit,
+                   size_t part, size_t numParts)
+{
+    if (numCards == 0)
+    {
+        if (part == 0)
+            visit(CardSet(), 1);
+        return;
+    }
+    for (size_t first=part; first+numCards <= STANDARD_DECK_SIZE; first+=numParts)
+    {
+        const uint64_t low = UINT64_C(1) << first;
+        if (numCards == 1)
+        {
+            visit(CardSet(low), 1);
+            continue;
+        }
+        combinations rest(STANDARD_DECK_SIZE-first-1, numCards-1);
+        do
+            visit(CardSet(low | rest.getMask() << (first+1)), 1);
+        while (rest.next());
+    }
+}
+
+/**
+ * The canonical hands are four suit masks, each no greater than the one
+ * before, which is what canonize() makes.  The hands with the same masks
+ * in another order are the rest of the class.
+ */
+class CanonicalWalk
+{
+public:
+    CanonicalWalk(const CardSetVisitor& visit, size_t part, size_t numParts)
+        : _visit(visit)
+        , _part(part)
+        , _numParts(numParts)
+    {
+        int most = 0;
+        for (size_t m=NUM_SUIT_MASKS; m-- > 0; )
+            _bySize[rankMaskTable[m].nRanks].push_back(static_cast<int>(m));
+        for (size_t m=0; m<NUM_SUIT_MASKS; m++)
+        {
+            most = std::max(most, static_cast<int>(rankMaskTable[m].nRanks));
+            _mostRanks[m] = most;
+        }
+    }
+
+    void walk(size_t suit, size_t left, int bound)
+    {
+        const size_t last = Suit::NUM_SUIT-1;
+        for (size_t n=(suit == last ? left : 0); n<=std::min(left, size_t(Rank::NUM_RANK)); n++)
+        {
+            const std::vector<int>& masks = _bySize[n];
+            std::vector<int>::const_iterator it =
+                std::lower_bound(masks.begin(), masks.end(), bound, std::greater<int>());
+            for (; it != masks.end(); ++it)
+            {
+                const int m = *it;
+                if (suit == 0 && static_cast<size_t>(m) % _numParts != _part)
+                    continue;
+                // the later suits hold no more ranks than the largest
+                // mask below this one
+                if (left-n > (last-suit)*static_cast<size_t>(_mostRanks[m]))
+                    continue;
+                _masks[suit] = m;
+                if (suit == last)
+                    emit();
+                else
+                    walk(suit+1, left-n, m);
+            }
+        }
+    }
+
+private:
+    void emit()
+    {
+        uint64_t mask = 0;
+        size_t count = 24;          // 4!
+        size_t run = 1;
+        for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        {
+            mask |= static_cast<uint64_t>(_masks[s]) << (s*Rank::NUM_RANK);
+            run = (s > 0 && _masks[s] == _masks[s-1]) ? run+1 : 1;
+            count /= run;
+        }
+        _visit(CardSet(mask), count);
+    }
+
+    const CardSetVisitor& _visit;
+    size_t _part;
+    size_t _numParts;
+    std::vector<int> _bySize[Rank::NUM_RANK+1];     //!< decreasing
+    int _mostRanks[NUM_SUIT_MASKS];                 //!< over the masks <= m
+    int _masks[Suit::NUM_SUIT];
+};
+
+// the rank held n times goes in the first n suits, as canonizeRanks()
+void visitRanks(size_t rank, size_t left, uint64_t mask, size_t count, size_t key,
+                const CardSetVisitor& visit, size_t part, size_t numParts)
+{
+    if (rank == 2 && key % numParts != part)
+        return;
+    if (rank == Rank::NUM_RANK)
+    {
+        if (left == 0)
+            visit(CardSet(mask), count);
+        return;
+    }
+    uint64_t held = 0;
+    for (size_t n=0; n<=std::min(left, size_t(Suit::NUM_SUIT)); n++)
+    {
+        visitRanks(rank+1, left-n, mask | held, count*choose(Suit::NUM_SUIT, n),
+                   key*(Suit::NUM_SUIT+1) + n, visit, part, numParts);
+        held |= UINT64_C(1) << (n*Rank::NUM_RANK + rank);
+    }
+}
+}
+
+void visitCardSets(size_t numCards, Card::Grouping grouping,
+                   const CardSetVisitor& visit, size_t part, size_t numParts)
+{
+    if (numCards > STANDARD_DECK_SIZE)
+        return;
+    switch (grouping)
+    {
+    case Card::RANK_SUIT:
+        visitRankSuit(numCards, visit, part, numParts);
+        break;
+    case Card::SUIT_CANONICAL:
+    {
+        CanonicalWalk walk(visit, part, numParts);
+        walk.walk(0, numCards, NUM_SUIT_MASKS-1);
+        break;
+    }
+    case Card::RANK:
+        visitRanks(0, numCards, 0, 1, 0, visit, part, numParts);
+        break;
+    };
+}
+
+void visitCardSetsParallel(size_t numCards, Card::Grouping grouping,
+                           const CardSetPartVisitor& visit, size_t numParts)
+{
+    if (numParts == 0)
+        numParts = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t p=0; p<numParts; p++)
+        threads.push_back(std::thread([&, p]()
+        {
+            visitCardSets(numCards, grouping,
+                          [&](const CardSet& hand, size_t count) { visit(hand, count, p); },
+                          p, numParts);
+        }));
+    for (size_t p=0; p<numParts; p++)
+        threads[p].join();
+}
+
 }
@@ -4,6 +4,7 @@
 #ifndef PEVAL_CARDSETGENERATORS_H_
 #define PEVAL_CARDSETGENERATORS_H_
 
+#include <functional>
 #include <set>
 #include "Card.h"
 #include "CardSet.h"
@@ -34,6 +35,43 @@ namespace pokerstove
  */
 std::set<CardSet>
 createCardSet(size_t numCards, Card::Grouping grouping=Card::RANK_SUIT);
+
+/**
+ * Called with each hand a generator makes, and the number of hands of
+ * the deck it stands for.  The parallel form also gets the part of the
+ * work it is called from, so that it can keep its results per part.
+ */
+typedef std::function<void (const CardSet& hand, size_t count)> CardSetVisitor;
+typedef std::function<void (const CardSet& hand, size_t count, size_t part)> CardSetPartVisitor;
+
+/**
+ * Visit one hand of numCards cards of this deck for each class of the
+ * grouping, without building the set of them, so that spaces of five to
+ * seven cards stay cheap.  The hands are those canonize() (for
+ * SUIT_CANONICAL) or canonizeRanks() (for RANK) makes, each class is
+ * visited exactly once, and count is the number of hands in the class,
+ * so the counts add up to C(STANDARD_DECK_SIZE, numCards).  The order is
+ * not that of createCardSet.
+ *
+ * The canonical hands are made directly, as four suit masks in
+ * decreasing order, and the rank hands from the counts of each rank.
+ *
+ * The work splits into numParts parts on the first card: the lowest
+ * card for RANK_SUIT, the ranks of the first suit for SUIT_CANONICAL,
+ * and the counts of the two lowest ranks for RANK.  Only the hands of the
+ * given part are visited.
+ */
+void visitCardSets(size_t numCards, Card::Grouping grouping,
+                   const CardSetVisitor& visit,
+                   size_t part=0, size_t numParts=1);
+
+/**
+ * visitCardSets with the parts on numParts threads, zero for one per
+ * core.  visit is called from all of them at once.
+ */
+void visitCardSetsParallel(size_t numCards, Card::Grouping grouping,
+                           const CardSetPartVisitor& visit,
+                           size_t numParts=0);
 }
 
 #endif  // PEVAL_CARDSETGENERATORS_H_
@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+#include <map>
+#include <vector>
+#include <pokerstove/util/choose.h>
+#include <pokerstove/util/combinations.h>
 #include "CardSetGenerators.h"
 
 using namespace pokerstove;
@@ -24,3 +28,93 @@ TEST(CardSetGeneratorsTest, RankSetSizes)
     EXPECT_EQ(455, pokerstove::createCardSet(3, Card::RANK).size());
 }
 
+
+namespace
+{
+// the classes of the grouping and the number of hands in each, the slow way
+std::map<CardSet, size_t> countClasses(size_t numCards, Card::Grouping grouping)
+{
+    std::map<CardSet, size_t> ret;
+    combinations cards(STANDARD_DECK_SIZE, numCards);
+    do
+    {
+        CardSet hand(cards.getMask());
+        if (grouping == Card::SUIT_CANONICAL)
+            hand = hand.canonize();
+        else if (grouping == Card::RANK)
+            hand = hand.canonizeRanks();
+        ret[hand]++;
+    }
+    while (cards.next());
+    return ret;
+}
+}
+
+TEST(CardSetGeneratorsTest, VisitMatchesClasses)
+{
+    const Card::Grouping groupings[] = {Card::RANK_SUIT, Card::SUIT_CANONICAL, Card::RANK};
+    for (size_t g=0; g<3; g++)
+        for (size_t n=1; n<=4; n++)
+        {
+            std::map<CardSet, size_t> expected = countClasses(n, groupings[g]);
+            std::map<CardSet, size_t> visited;
+            size_t duplicates = 0;
+            visitCardSets(n, groupings[g], [&](const CardSet& hand, size_t count)
+            {
+                duplicates += visited.count(hand);
+                visited[hand] = count;
+            });
+            EXPECT_EQ(0, duplicates) << g << " " << n;
+            EXPECT_TRUE(visited == expected) << g << " " << n;
+
+            // the parts, on their own and on threads, cover it once
+            std::map<CardSet, size_t> parts;
+            for (size_t part=0; part<3; part++)
+                visitCardSets(n, groupings[g], [&](const CardSet& hand, size_t count)
+                {
+                    duplicates += parts.count(hand);
+                    parts[hand] = count;
+                }, part, 3);
+            EXPECT_EQ(0, duplicates) << g << " " << n;
+            EXPECT_TRUE(parts == expected) << g << " " << n;
+
+            std::vector<std::map<CardSet, size_t> > threads(4);
+            visitCardSetsParallel(n, groupings[g], [&](const CardSet& hand, size_t count, size_t part)
+            {
+                threads[part][hand] = count;
+            }, 4);
+            std::map<CardSet, size_t> merged;
+            size_t size = 0;
+            for (size_t part=0; part<threads.size(); part++)
+            {
+                merged.insert(threads[part].begin(), threads[part].end());
+                size += threads[part].size();
+            }
+            EXPECT_EQ(expected.size(), size) << g << " " << n;
+            EXPECT_TRUE(merged == expected) << g << " " << n;
+        }
+}
+
+TEST(CardSetGeneratorsTest, VisitSevenCards)
+{
+    // counted with Burnside's lemma over the renamings of the suits
+    size_t classes = 0;
+    uint64_t hands = 0;
+    visitCardSets(7, Card::SUIT_CANONICAL, [&](const CardSet&, size_t count)
+    {
+        classes++;
+        hands += count;
+    });
+    EXPECT_EQ(383274, classes);
+    EXPECT_EQ(choose(STANDARD_DECK_SIZE, 7), hands);
+
+    classes = 0;
+    hands = 0;
+    visitCardSets(7, Card::RANK, [&](const CardSet&, size_t count)
+    {
+        classes++;
+        hands += count;
+    });
+    EXPECT_EQ(6030, classes);
+    EXPECT_EQ(choose(STANDARD_DECK_SIZE, 7), hands);
+}
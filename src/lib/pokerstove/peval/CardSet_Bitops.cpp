@@ -0,0 +1,374 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "CardSetBitops.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <Config.h>
+#include <pokerstove/util/choose.h>
+#include "CardSet.h"
+#include "PokerEvaluationTables.h"
+#include "Rank.h"
+#include "Suit.h"
+
+#if defined(HAVE_BUILTIN_CPU_SUPPORTS)
+#include <immintrin.h>
+#define PEVAL_BITOPS_TARGET __attribute__((target("popcnt,lzcnt,bmi,bmi2")))
+#endif
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const uint64_t SUIT_MASK = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+
+static_assert(sizeof(rankMaskTable)/sizeof(rankMaskTable[0]) == SUIT_MASK+1,
+              "PokerEvaluationTables.h was generated for another deck");
+
+// the ranks of a suit as a mask
+inline int suitMask (uint64_t mask, size_t suit)
+{
+    return static_cast<int>((mask >> suit*Rank::NUM_RANK) & SUIT_MASK);
+}
+
+/**
+ * Bit counting with lookup tables and loops, which any cpu can run.  The
+ * rank lookups all come from the one packed rankMaskTable.
+ */
+struct TableBits
+{
+    static size_t size (uint64_t v)
+    {
+        size_t c;
+        for (c = 0; v; c++)
+            v &= v - 1; // clear the least significant bit set
+        return c;
+    }
+    static int count  (int ranks) { return rankMaskTable[ranks].nRanks; }
+    static int top    (int ranks) { return rankMaskTable[ranks].top; }
+    static int bottom (int ranks) { return rankMaskTable[ranks].bottom; }
+};
+
+/**
+ * Bit counting with the compiler builtins, which turn into popcnt, lzcnt
+ * and tzcnt in the functions compiled for them.  The results are the same
+ * as the tables, including -1 for the top and bottom of no ranks.
+ */
+struct BuiltinBits
+{
+    static size_t size (uint64_t v) { return __builtin_popcountll(v); }
+    static int count  (int ranks)   { return __builtin_popcount(ranks); }
+    static int top    (int ranks)   { return ranks ? 31-__builtin_clz(ranks) : -1; }
+    static int bottom (int ranks)   { return ranks ? __builtin_ctz(ranks) : -1; }
+};
+
+template <class Bits>
+inline __attribute__((always_inline))
+size_t countRanksOf (uint64_t mask)
+{
+    return Bits::count (suitMask (mask, 0) | suitMask (mask, 1) |
+                        suitMask (mask, 2) | suitMask (mask, 3));
+}
+
+template <class Bits>
+inline __attribute__((always_inline))
+size_t countMaxSuitOf (uint64_t mask)
+{
+    return max(max(Bits::count (suitMask (mask, 0)), Bits::count (suitMask (mask, 1))),
+               max(Bits::count (suitMask (mask, 2)), Bits::count (suitMask (mask, 3))));
+}
+
+// this is a rough draft of the evaluateHigh routine, the idea is that
+// it should be AFAP.  However, this is a general 1-7 card evaluator, so
+// it cannot be too fast.  We could unwrap the method calls here for the
+// PokerHand, maybe it would speed things up.
+//
+// note, there are no function calls in this function, once the bit
+// counting policy is inlined
+template <class Bits>
+inline __attribute__((always_inline))
+PokerEvaluation evaluateHighOf (uint64_t mask)
+{
+    // first the easy stuff
+    int c = suitMask (mask, 0);
+    int d = suitMask (mask, 1);
+    int h = suitMask (mask, 2);
+    int s = suitMask (mask, 3);
+    int rankmask = c | d | h | s;
+
+    if (Bits::count(rankmask) >= 5)
+    {
+        int sranks = 0;
+        int suitindex=-1;
+        if (Bits::count(c) >= 5)
+        {
+            suitindex = 0;
+            sranks = c;
+        }
+        else if (Bits::count(d) >= 5)
+        {
+            suitindex = 1;
+            sranks = d;
+        }
+        else if (Bits::count(h) >= 5)
+        {
+            suitindex = 2;
+            sranks = h;
+        }
+        else if (Bits::count(s) >= 5)
+        {
+            suitindex = 3;
+            sranks = s;
+        }
+        if (suitindex >= 0)
+        {
+            const RankMaskEntry& flush = rankMaskTable[sranks];
+            int strval = flush.straight;
+            if (strval > 0)
+                return PokerEvaluation((STRAIGHT_FLUSH<<VSHIFT) ^ strval<<MAJOR_SHIFT);
+            else
+                return PokerEvaluation((FLUSH<<VSHIFT) ^ flush.topFive);
+        }
+        int strval = rankMaskTable[rankmask].straight;
+        if (strval > 0)
+            return PokerEvaluation((STRAIGHT<<VSHIFT) ^(strval<<MAJOR_SHIFT));
+    }
+
+    int ncards = Bits::count(c) + Bits::count(d) + Bits::count(h) + Bits::count(s);
+    int ndups = ncards - Bits::count(rankmask);
+
+    switch (ndups)
+    {
+        case 0:     // no pair
+        {
+            return PokerEvaluation((NO_PAIR<<VSHIFT) ^ rankMaskTable[rankmask].topFive);
+        }
+        break;
+
+        case 1:     // one pair
+        {
+            int two_mask = rankmask ^(c ^ d ^ h ^ s);
+            int topind = Bits::top(two_mask);
+            int kickers = rankMaskTable[rankmask ^(0x01<<topind)].topThree;
+            return PokerEvaluation((ONE_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^ kickers);
+        }
+        break;
+
+        case 2:
+        {
+            int two_mask = rankmask ^(c ^ d ^ h ^ s);
+
+            if (two_mask)   // two pair
+            {
+                int topind = Bits::top(two_mask);
+                int botind = Bits::bottom(two_mask);
+                int kicker = Bits::top(rankmask ^ two_mask);
+                if (kicker >= 0)
+                    return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT) ^(0x01<<kicker));
+                else
+                    return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
+            }
+            else
+            {
+                int three_mask =
+                    ((c&d)|(h&s)) &
+                    ((c&h)|(d&s));
+                int topind = Bits::top(three_mask);
+                int kickers = rankmask ^(0x01<<topind);
+                int kbits = 0;
+                if (kickers > 0)
+                    kbits   = 0x01<<Bits::top(kickers);
+                if (kbits >= 0 && ((kickers^kbits) > 0))
+                    kbits      ^= 0x01<<Bits::top(kickers^kbits);
+                return PokerEvaluation((THREE_OF_A_KIND<<VSHIFT) ^(topind << MAJOR_SHIFT) ^ kbits);
+            }
+        }
+        break;
+
+        default:
+        {
+            int four_mask = c & d & h & s;
+            if (four_mask)
+            {
+                int topind = Bits::top(four_mask);
+                int kicker = rankmask;
+                kicker ^= (0x01<<topind);
+                kicker  = Bits::top(kicker);
+                if (kicker >= 0)
+                    return PokerEvaluation((FOUR_OF_A_KIND<<VSHIFT) ^(topind<<MAJOR_SHIFT) ^(0x01<<kicker));
+                else
+                    return PokerEvaluation((FOUR_OF_A_KIND<<VSHIFT) ^(topind<<MAJOR_SHIFT));
+            }
+
+            int two_mask = rankmask ^(c ^ d ^ h ^ s);
+            if (Bits::count(two_mask) != ndups)
+            {
+                int three_mask =
+                    ((c&d)|(h&s)) &
+                    ((c&h)|(d&s));
+                int topind = Bits::top(three_mask);
+                if (two_mask > 0)
+                {
+                    int botind = Bits::top(two_mask);
+                    return PokerEvaluation((FULL_HOUSE<<VSHIFT) ^(topind<<MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
+                }
+                else
+                {
+                    int botind = Bits::top(three_mask ^ 0x01<<topind);
+                    return PokerEvaluation((FULL_HOUSE<<VSHIFT) ^(topind<<MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
+                }
+            }
+
+            int topind = Bits::top(two_mask);
+            int botind = Bits::top(two_mask ^ 0x01<<topind);
+            int kicker = rankmask ^ 0x01<<topind ^ 0x01<<botind;
+            kicker  = Bits::top(kicker);
+            if (kicker >= 0)
+                return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT) ^(0x01<<kicker));
+            else
+                return PokerEvaluation((TWO_PAIR<<VSHIFT) ^(topind << MAJOR_SHIFT) ^(botind << MINOR_SHIFT));
+        }
+        break;
+    }
+
+    cerr << "oops\n";
+    return PokerEvaluation(0);
+}
+
+size_t rankColexPortable (uint64_t mask)
+{
+    size_t ret  = 0;
+    int slot = 0;
+    int sz   = 1;
+    int c    = suitMask (mask, 0);
+    int d    = suitMask (mask, 1);
+    int h    = suitMask (mask, 2);
+    int s    = suitMask (mask, 3);
+    int rbit = 0x01;
+
+    for (size_t i=0; i<Rank::NUM_RANK; i++)
+    {
+        if (rbit&c) ret += choose(slot++,sz++);
+        if (rbit&d) ret += choose(slot++,sz++);
+        if (rbit&h) ret += choose(slot++,sz++);
+        if (rbit&s) ret += choose(slot++,sz++);
+        slot++;
+        rbit <<= 1;
+    }
+    return ret;
+}
+
+size_t sizePortable (uint64_t mask)                 { return TableBits::size (mask); }
+size_t countRanksPortable (uint64_t mask)           { return countRanksOf<TableBits> (mask); }
+size_t countSuitPortable (uint64_t mask, size_t s)  { return TableBits::count (suitMask (mask, s)); }
+size_t countMaxSuitPortable (uint64_t mask)         { return countMaxSuitOf<TableBits> (mask); }
+PokerEvaluation evaluateHighPortable (uint64_t mask){ return evaluateHighOf<TableBits> (mask); }
+
+#ifdef PEVAL_BITOPS_TARGET
+// in rank major order, the card of rank r and suit s is bit r*4+s, this
+// is the bit of each rank for the first suit
+const uint64_t RANK_SLOTS = UINT64_C(0x111111111);
+
+PEVAL_BITOPS_TARGET size_t sizeBuiltin (uint64_t mask)
+{
+    return BuiltinBits::size (mask);
+}
+
+PEVAL_BITOPS_TARGET size_t countRanksBuiltin (uint64_t mask)
+{
+    return countRanksOf<BuiltinBits> (mask);
+}
+
+PEVAL_BITOPS_TARGET size_t countSuitBuiltin (uint64_t mask, size_t s)
+{
+    return BuiltinBits::count (suitMask (mask, s));
+}
+
+PEVAL_BITOPS_TARGET size_t countMaxSuitBuiltin (uint64_t mask)
+{
+    return countMaxSuitOf<BuiltinBits> (mask);
+}
+
+PEVAL_BITOPS_TARGET PokerEvaluation evaluateHighBuiltin (uint64_t mask)
+{
+    return evaluateHighOf<BuiltinBits> (mask);
+}
+
+// deposit each suit into the rank major order, so that the cards come
+// out lowest rank first, and then add up C(rank+j, j+1) for the j-th
+// card, as rankColexPortable does one rank at a time
+PEVAL_BITOPS_TARGET size_t rankColexBuiltin (uint64_t mask)
+{
+    uint64_t cards = 0;
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        cards |= _pdep_u64(suitMask (mask, s), RANK_SLOTS << s);
+
+    // a rank plus the cards below it is less than CHOOSE_TABLE_SIZE
+    const ChooseTable& b = ChooseTable::shared ();
+    size_t ret = 0;
+    for (size_t j=0; cards != 0; j++, cards = _blsr_u64(cards))
+        ret += b.c[(_tzcnt_u64(cards) >> 2) + j][j+1];
+    return ret;
+}
+#endif
+
+bool builtinSupported ()
+{
+#ifdef PEVAL_BITOPS_TARGET
+    __builtin_cpu_init ();
+    return __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("lzcnt") &&
+           __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+}
+
+const CardSetBitops& CardSetBitops::portable ()
+{
+    static const CardSetBitops ops =
+    {
+        "portable",
+        sizePortable,
+        countRanksPortable,
+        countSuitPortable,
+        countMaxSuitPortable,
+        rankColexPortable,
+        evaluateHighPortable
+    };
+    return ops;
+}
+
+const CardSetBitops& CardSetBitops::builtin ()
+{
+#ifdef PEVAL_BITOPS_TARGET
+    static const CardSetBitops ops =
+    {
+        "bmi2",
+        sizeBuiltin,
+        countRanksBuiltin,
+        countSuitBuiltin,
+        countMaxSuitBuiltin,
+        rankColexBuiltin,
+        evaluateHighBuiltin
+    };
+    if (isBuiltinSupported ())
+        return ops;
+#endif
+    throw runtime_error("CardSetBitops, the cpu or build lacks popcnt and bmi2");
+}
+
+bool CardSetBitops::isBuiltinSupported ()
+{
+    static const bool supported = builtinSupported ();
+    return supported;
+}
+
+const CardSetBitops& CardSetBitops::best ()
+{
+    static const CardSetBitops& ops = (isBuiltinSupported () ? builtin () : portable ());
+    return ops;
+}
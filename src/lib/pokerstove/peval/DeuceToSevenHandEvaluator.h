@@ -5,6 +5,7 @@
 #ifndef PEVAL_DEUCETOSEVENHANDEVALUATOR_H_
 #define PEVAL_DEUCETOSEVENHANDEVALUATOR_H_
 
+#include "LowballTable.h"
 #include "PokerHandEvaluator.h"
 
 namespace pokerstove
@@ -17,20 +18,21 @@ class DeuceToSevenHandEvaluator : public PokerHandEvaluator
 public:
     DeuceToSevenHandEvaluator()
         : PokerHandEvaluator()
+        , _lowball(&LowballTable::shared())
         , _numDraws(0)
     {}
 
     virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
     {
         if (usesSuits())
-            return PokerHandEvaluation(hand.evaluateLow2to7());
+            return PokerHandEvaluation(_lowball->evaluateLow2to7(hand));
         else
-            return PokerHandEvaluation(hand.evaluateRanksLow2to7());
+            return PokerHandEvaluation(_lowball->evaluateRanksLow2to7(hand));
     }
 
     virtual PokerEvaluation evaluateRanks(const CardSet& hand, const CardSet& board=CardSet(0)) const
     {
-        return hand.evaluateRanksLow2to7();
+        return _lowball->evaluateRanksLow2to7(hand);
     }
 
     virtual PokerEvaluation evaluateSuits(const CardSet& hand, const CardSet& board=CardSet(0)) const
@@ -44,7 +46,15 @@ public:
     virtual size_t numDraws() const            { return _numDraws; }
     virtual void setNumDraws(size_t sz)        { _numDraws = sz; }
 
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        _lowballTable = table;
+        _lowball = (table ? table.get() : &LowballTable::shared());
+    }
+
 private:
+    const LowballTable* _lowball;
+    boost::shared_ptr<const LowballTable> _lowballTable;
     size_t _numDraws;
 };
 
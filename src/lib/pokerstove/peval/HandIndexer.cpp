@@ -0,0 +1,390 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "HandIndexer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <pokerstove/util/lastbit.h>
+#include "PokerEvaluationTables.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const uint32_t SUIT_MASK = (1 << Rank::NUM_RANK) - 1;
+
+inline size_t countRanks (uint32_t ranks)
+{
+    return rankMaskTable[ranks].nRanks;
+}
+
+inline uint32_t suitRanks (const CardSet& cards, size_t suit)
+{
+    return static_cast<uint32_t>(cards.mask() >> (suit*Rank::NUM_RANK)) & SUIT_MASK;
+}
+
+// the colex index of a set of k values drawn with repetition, given in
+// decreasing order, which is the colex index of the set a[j] + k-1-j
+uint64_t multisetIndex (const uint64_t* a, size_t k)
+{
+    uint64_t index = 0;
+    for (size_t j=0; j<k; j++)
+        index += chooseSmall (a[j] + k-1-j, k-j);
+    return index;
+}
+
+// the inverse of multisetIndex, for values less than n
+void multisetUnindex (uint64_t index, uint64_t n, size_t k, uint64_t* a)
+{
+    uint64_t hi = n+k-2;        // the largest a[0] + k-1
+    for (size_t j=0; j<k; j++)
+    {
+        // the largest b <= hi with C(b,t) <= index
+        const size_t t = k-j;
+        uint64_t lo = t-1;
+        while (lo < hi)
+        {
+            const uint64_t mid = lo + (hi-lo+1)/2;
+            if (chooseSmall (mid, t) <= index)
+                lo = mid;
+            else
+                hi = mid-1;
+        }
+        index -= chooseSmall (lo, t);
+        a[j] = lo - (k-1-j);
+        hi = lo-1;
+    }
+}
+
+bool lessShapes (const uint32_t* a, const uint32_t* b)
+{
+    return lexicographical_compare (a, a+Suit::NUM_SUIT, b, b+Suit::NUM_SUIT);
+}
+
+inline bool sameShapes (const uint32_t* a, const uint32_t* b)
+{
+    return ((a[0]^b[0]) | (a[1]^b[1]) | (a[2]^b[2]) | (a[3]^b[3])) == 0;
+}
+
+// puts the larger first, without branches
+inline void compareSwap (uint64_t& a, uint64_t& b)
+{
+    const uint64_t hi = max(a, b);
+    const uint64_t lo = min(a, b);
+    a = hi;
+    b = lo;
+}
+}
+
+const size_t   HandIndexer::MAX_ROUNDS;
+const uint32_t HandIndexer::EMPTY_SLOT;
+
+HandIndexer::HandIndexer (const vector<size_t>& cardsPerRound)
+    : _choose(ChooseTable::shared())
+    , _rounds(cardsPerRound.size())
+{
+    if (_rounds == 0 || _rounds > MAX_ROUNDS)
+        throw invalid_argument("HandIndexer, between one and MAX_ROUNDS rounds");
+    size_t total = 0;
+    for (size_t i=0; i<_rounds; i++)
+    {
+        _cards[i] = cardsPerRound[i];
+        total += _cards[i];
+        if (_cards[i] == 0 || total > STANDARD_DECK_SIZE)
+            throw invalid_argument("HandIndexer, the rounds do not fit the deck");
+    }
+
+    for (size_t round=0; round<_rounds; round++)
+    {
+        // the shapes a suit can have, the cards of each round, which never
+        // add up to more than the ranks
+        vector<uint32_t> shapes(1, 0);
+        for (size_t i=0; i<=round; i++)
+        {
+            vector<uint32_t> next;
+            for (size_t s=0; s<shapes.size(); s++)
+                for (uint32_t c=0; c<=_cards[i]; c++)
+                {
+                    uint32_t shape = shapes[s] | c << (SHAPE_BITS*(MAX_ROUNDS-1-i));
+                    size_t n = 0;
+                    for (size_t j=0; j<=i; j++)
+                        n += shapeCount (shape, j);
+                    if (n <= Rank::NUM_RANK)
+                        next.push_back (shape);
+                }
+            shapes.swap (next);
+        }
+        sort (shapes.begin(), shapes.end(), greater<uint32_t>());
+
+        // the suits in order of decreasing shape, which between them are
+        // dealt the cards of each round
+        vector<Configuration>& configs = _configurations[round];
+        const size_t n = shapes.size();
+        for (size_t a=0; a<n; a++)
+            for (size_t b=a; b<n; b++)
+                for (size_t c=b; c<n; c++)
+                    for (size_t d=c; d<n; d++)
+                    {
+                        Configuration config;
+                        config.shapes[0] = shapes[a];
+                        config.shapes[1] = shapes[b];
+                        config.shapes[2] = shapes[c];
+                        config.shapes[3] = shapes[d];
+                        config.offset = 0;
+                        bool fits = true;
+                        for (size_t i=0; i<=round && fits; i++)
+                        {
+                            size_t dealt = 0;
+                            for (size_t s=0; s<Suit::NUM_SUIT; s++)
+                                dealt += shapeCount (config.shapes[s], i);
+                            fits = (dealt == _cards[i]);
+                        }
+                        if (!fits)
+                            continue;
+                        for (size_t s=0; s<Suit::NUM_SUIT; s++)
+                        {
+                            size_t left = Rank::NUM_RANK;
+                            config.suitSize[s] = 1;
+                            for (size_t i=0; i<=round; i++)
+                            {
+                                const size_t dealt = shapeCount (config.shapes[s], i);
+                                config.suitSize[s] *= choose (left, dealt);
+                                left -= dealt;
+                            }
+                        }
+                        configs.push_back (config);
+                    }
+        sort (configs.begin(), configs.end(),
+              [](const Configuration& x, const Configuration& y)
+              {
+                  return lessShapes (x.shapes, y.shapes);
+              });
+
+        // each block holds the multisets of the indices of each run of
+        // suits of the same shape
+        uint64_t offset = 0;
+        double bound = 0;
+        for (size_t i=0; i<configs.size(); i++)
+        {
+            Configuration& config = configs[i];
+            config.offset = offset;
+            double approx = 1;
+            uint64_t size = 1;
+            for (size_t s=0; s<Suit::NUM_SUIT; )
+            {
+                size_t k = 1;
+                while (s+k < Suit::NUM_SUIT && config.shapes[s+k] == config.shapes[s])
+                    k++;
+                for (size_t j=0; j<k; j++)
+                {
+                    config.runSize[s+j]   = 1;
+                    config.runLength[s+j] = 0;
+                }
+                config.runSize[s]   = chooseSmall (config.suitSize[s] + k-1, k);
+                config.runLength[s] = static_cast<uint8_t>(k);
+                approx *= static_cast<double>(config.runSize[s]);
+                size *= config.runSize[s];
+                s += k;
+            }
+            bound += approx;
+            if (bound >= 18446744073709551615.0)
+                throw invalid_argument("HandIndexer, too many deals for a 64 bit index");
+            offset += size;
+        }
+        _sizes[round] = offset;
+
+        // an open addressed hash of the shapes, at most half full; the
+        // empty slots are never reached, the shapes of a deal always have
+        // a configuration
+        size_t bits = 1;
+        while ((size_t(1) << bits) < 2*configs.size())
+            bits++;
+        _slotShift[round] = 64 - bits;
+        _slots[round].assign (size_t(1) << bits, EMPTY_SLOT);
+        for (size_t i=0; i<configs.size(); i++)
+        {
+            size_t j = slot (round, configs[i].shapes);
+            while (_slots[round][j] != EMPTY_SLOT)
+                j = (j+1) & (_slots[round].size()-1);
+            _slots[round][j] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+uint32_t HandIndexer::shapeCount (uint32_t shape, size_t round)
+{
+    return (shape >> (SHAPE_BITS*(MAX_ROUNDS-1-round))) & ((1 << SHAPE_BITS) - 1);
+}
+
+void HandIndexer::addRound (size_t round, const CardSet& cards, SuitState* suits) const
+{
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+    {
+        SuitState& suit = suits[s];
+        const uint32_t ranks = suitRanks (cards, s);
+
+        // the colex index of the ranks among those the suit has left
+        uint64_t index = 0;
+        size_t dealt = 0;
+        for (uint32_t m=ranks; m != 0; m &= m-1)
+        {
+            const uint32_t r = lastbit (m);
+            const size_t position = r - countRanks (suit.used & ((1 << r) - 1));
+            index += _choose.c[position][++dealt];
+        }
+
+        suit.index += suit.radix * index;
+        suit.radix *= _choose.c[Rank::NUM_RANK - countRanks (suit.used)][dealt];
+        suit.used  |= ranks;
+        suit.shape |= static_cast<uint32_t>(dealt) << (SHAPE_BITS*(MAX_ROUNDS-1-round));
+    }
+}
+
+size_t HandIndexer::slot (size_t round, const uint32_t* shapes) const
+{
+    const uint64_t hi = static_cast<uint64_t>(shapes[0]) << 32 | shapes[1];
+    const uint64_t lo = static_cast<uint64_t>(shapes[2]) << 32 | shapes[3];
+    return (hi*UINT64_C(0x9e3779b97f4a7c15) ^ lo*UINT64_C(0xc2b2ae3d27d4eb4f)) >> _slotShift[round];
+}
+
+uint64_t HandIndexer::combine (size_t round, const SuitState* suits) const
+{
+    // sort the suits by shape and then index, both decreasing, with a
+    // sorting network on keys of both.  A suit index is less than 9!, so
+    // fits below the shape.
+    uint64_t keys[Suit::NUM_SUIT];
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        keys[s] = static_cast<uint64_t>(suits[s].shape) << 32 | suits[s].index;
+    compareSwap (keys[0], keys[1]);
+    compareSwap (keys[2], keys[3]);
+    compareSwap (keys[0], keys[2]);
+    compareSwap (keys[1], keys[3]);
+    compareSwap (keys[1], keys[2]);
+
+    uint32_t shapes[Suit::NUM_SUIT];
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        shapes[s] = static_cast<uint32_t>(keys[s] >> 32);
+    const vector<Configuration>& configs = _configurations[round];
+    const vector<uint32_t>& slots = _slots[round];
+    size_t i = slot (round, shapes);
+    while (!sameShapes (shapes, configs[slots[i]].shapes))
+        i = (i+1) & (slots.size()-1);
+    const Configuration& config = configs[slots[i]];
+
+    uint64_t index = 0;
+    uint64_t radix = 1;
+    for (size_t s=0; s<Suit::NUM_SUIT; s += config.runLength[s])
+    {
+        const size_t k = config.runLength[s];
+        uint64_t a[Suit::NUM_SUIT];
+        for (size_t j=0; j<k; j++)
+            a[j] = keys[s+j] & 0xFFFFFFFF;
+        index += radix * multisetIndex (a, k);
+        radix *= config.runSize[s];
+    }
+    return config.offset + index;
+}
+
+uint64_t HandIndexer::index (const CardSet* deal, size_t n) const
+{
+    SuitState suits[Suit::NUM_SUIT] = {};
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        suits[s].radix = 1;
+    for (size_t i=0; i<n; i++)
+        addRound (i, deal[i], suits);
+    return combine (n-1, suits);
+}
+
+void HandIndexer::indexAll (const CardSet* deal, size_t n, uint64_t* indices) const
+{
+    SuitState suits[Suit::NUM_SUIT] = {};
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        suits[s].radix = 1;
+    for (size_t i=0; i<n; i++)
+    {
+        addRound (i, deal[i], suits);
+        indices[i] = combine (i, suits);
+    }
+}
+
+void HandIndexer::unindex (size_t round, uint64_t index, CardSet* deal) const
+{
+    if (round >= _rounds || index >= _sizes[round])
+        throw invalid_argument("HandIndexer, index out of range");
+
+    const vector<Configuration>& configs = _configurations[round];
+    const Configuration& config = *(upper_bound (configs.begin(), configs.end(), index,
+        [](uint64_t x, const Configuration& y)
+        {
+            return x < y.offset;
+        }) - 1);
+
+    // the index of each suit, from the multisets of each run of suits of
+    // the same shape
+    uint64_t suitIndex[Suit::NUM_SUIT];
+    index -= config.offset;
+    for (size_t s=0; s<Suit::NUM_SUIT; s += config.runLength[s])
+    {
+        const uint64_t blocks = config.runSize[s];
+        multisetUnindex (index % blocks, config.suitSize[s], config.runLength[s], suitIndex+s);
+        index /= blocks;
+    }
+
+    for (size_t i=0; i<=round; i++)
+        deal[i] = CardSet();
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+    {
+        uint32_t used = 0;
+        uint64_t rest = suitIndex[s];
+        for (size_t i=0; i<=round; i++)
+        {
+            const size_t dealt = shapeCount (config.shapes[s], i);
+            const uint64_t ways = _choose.c[Rank::NUM_RANK - countRanks (used)][dealt];
+            uint64_t sub = rest % ways;
+            rest /= ways;
+
+            // the positions among the ranks left, largest first, and then
+            // the ranks at those positions
+            uint32_t ranks = 0;
+            size_t position = Rank::NUM_RANK;
+            for (size_t j=dealt; j>0; j--)
+            {
+                do
+                    position--;
+                while (_choose.c[position][j] > sub);
+                sub -= _choose.c[position][j];
+
+                size_t r = 0;
+                for (size_t left=position; ; r++)
+                    if ((used & 1 << r) == 0 && left-- == 0)
+                        break;
+                ranks |= 1 << r;
+            }
+            used |= ranks;
+            deal[i] |= CardSet(static_cast<uint64_t>(ranks) << (s*Rank::NUM_RANK));
+        }
+    }
+}
+
+vector<CardSet> HandIndexer::unindex (size_t round, uint64_t index) const
+{
+    vector<CardSet> deal(round+1);
+    unindex (round, index, &deal[0]);
+    return deal;
+}
+
+void HandIndexer::indexBatch (size_t round, const CardSet* deals, size_t n,
+                              uint64_t* indices) const
+{
+    for (size_t i=0; i<n; i++)
+        indices[i] = index (deals + i*(round+1), round+1);
+}
+
+void HandIndexer::unindexBatch (size_t round, const uint64_t* indices, size_t n,
+                                CardSet* deals) const
+{
+    for (size_t i=0; i<n; i++)
+        unindex (round, indices[i], deals + i*(round+1));
+}
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_HANDINDEXER_H_
+#define PEVAL_HANDINDEXER_H_
+
+#include <cstdint>
+#include <vector>
+#include <pokerstove/util/choose.h>
+#include "CardSet.h"
+#include "Rank.h"
+#include "Suit.h"
+
+namespace pokerstove
+{
+/**
+ * A dense index of the deals of several rounds, such as 2|3|1|1 for
+ * holdem or 4|3|1|1 for omaha, up to the suits: two deals get the same
+ * index exactly when one is the other with the suits renamed, and the
+ * indices of the deals of rounds 0..r run from 0 to size(r)-1, with no
+ * gaps.  unindex gives back a deal of each index.
+ *
+ * An index is worked out in time linear in the cards, from integer
+ * binomials only:
+ * - each suit indexes the ranks it is dealt in each round among the ranks
+ *   it has left, and mixes the rounds into one index in mixed radix
+ * - the number of cards each suit is dealt in each round is its shape;
+ *   the suits are sorted by shape and index, and the sorted shapes pick
+ *   a block of the index space
+ * - suits of the same shape can be swapped, so their indices are taken
+ *   as a multiset, with the colex index of combinations with repetition
+ *
+ * This is the approach of Waugh, "A fast and optimal hand isomorphism
+ * algorithm", for this deck.
+ *
+ * The cards of a deal must be distinct, and round i must hold
+ * cards(i) of them, otherwise the index is meaningless.
+ */
+class HandIndexer
+{
+public:
+    static const size_t MAX_ROUNDS = 8;
+
+    /**
+     * an indexer for deals of cardsPerRound[i] cards in round i.  Throws
+     * std::invalid_argument for no rounds or more than MAX_ROUNDS, a
+     * round of no cards, more cards than the deck, or more deals than
+     * a 64 bit index can count.
+     */
+    explicit HandIndexer (const std::vector<size_t>& cardsPerRound);
+
+    size_t rounds () const { return _rounds; }
+
+    /**
+     * the cards dealt in a round
+     */
+    size_t cards (size_t round) const { return _cards[round]; }
+
+    /**
+     * the number of indices of the deals of rounds 0..round
+     */
+    uint64_t size (size_t round) const { return _sizes[round]; }
+
+    /**
+     * the index of the deal of rounds 0..n-1, deal[i] holding the cards
+     * of round i
+     */
+    uint64_t index (const CardSet* deal, size_t n) const;
+    uint64_t index (const std::vector<CardSet>& deal) const
+    {
+        return index (&deal[0], deal.size());
+    }
+
+    /**
+     * the indices of the deals of rounds 0..i for each i < n, in
+     * indices[i], in one pass over the cards
+     */
+    void indexAll (const CardSet* deal, size_t n, uint64_t* indices) const;
+
+    /**
+     * the deal of rounds 0..round with the index, into deal[0..round].
+     * The first suits get the most cards, and the lowest ranks of what
+     * they have left.  Throws std::invalid_argument if the index is not
+     * less than size(round).
+     */
+    void unindex (size_t round, uint64_t index, CardSet* deal) const;
+    std::vector<CardSet> unindex (size_t round, uint64_t index) const;
+
+    /**
+     * index or unindex n deals of rounds 0..round, where the deal of
+     * hand i is deals[i*(round+1)] to deals[i*(round+1)+round]
+     */
+    void indexBatch (size_t round, const CardSet* deals, size_t n,
+                     uint64_t* indices) const;
+    void unindexBatch (size_t round, const uint64_t* indices, size_t n,
+                       CardSet* deals) const;
+
+private:
+    // the shape of a suit holds the cards it is dealt in round i in
+    // bits [SHAPE_BITS*(MAX_ROUNDS-1-i), SHAPE_BITS*(MAX_ROUNDS-i)), so
+    // that the earlier rounds weigh most
+    static const size_t SHAPE_BITS = 4;
+
+    /**
+     * a block of indices, for the deals whose suits sorted by shape have
+     * these shapes.  suitSize[s] is the number of ways suit s can be
+     * dealt its shape.  The suits of the same shape make a run, which
+     * starts with runLength suits and runSize multisets of their indices.
+     */
+    struct Configuration
+    {
+        uint32_t shapes[Suit::NUM_SUIT];
+        uint64_t suitSize[Suit::NUM_SUIT];
+        uint64_t runSize[Suit::NUM_SUIT];       //!< 1 inside a run
+        uint8_t  runLength[Suit::NUM_SUIT];     //!< 0 inside a run
+        uint64_t offset;
+    };
+
+    // what each suit has seen, while the rounds of a deal are read
+    struct SuitState
+    {
+        uint32_t used;          //!< ranks dealt so far
+        uint32_t shape;
+        uint64_t index;         //!< the ranks dealt, in mixed radix
+        uint64_t radix;         //!< the number of such deals
+    };
+
+    static const uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+    void addRound (size_t round, const CardSet& cards, SuitState* suits) const;
+    size_t slot (size_t round, const uint32_t* shapes) const;
+    uint64_t combine (size_t round, const SuitState* suits) const;
+    static uint32_t shapeCount (uint32_t shape, size_t round);
+
+    const ChooseTable& _choose;
+    size_t   _rounds;
+    size_t   _cards[MAX_ROUNDS];
+    uint64_t _sizes[MAX_ROUNDS];
+    std::vector<Configuration> _configurations[MAX_ROUNDS];    //!< sorted by shapes
+    std::vector<uint32_t>      _slots[MAX_ROUNDS];             //!< configurations by hash of shapes
+    size_t                     _slotShift[MAX_ROUNDS];
+};
+}
+
+#endif  // PEVAL_HANDINDEXER_H_
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <pokerstove/util/combinations.h>
+#include "HandIndexer.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const uint64_t SUIT_MASK = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+
+// the deal with its suits renamed, suit s becoming perm[s]
+vector<uint64_t> permuteSuits (const vector<uint64_t>& deal, const size_t* perm)
+{
+    vector<uint64_t> ret(deal.size(), 0);
+    for (size_t i=0; i<deal.size(); i++)
+        for (size_t s=0; s<Suit::NUM_SUIT; s++)
+            ret[i] |= ((deal[i] >> (s*Rank::NUM_RANK)) & SUIT_MASK) << (perm[s]*Rank::NUM_RANK);
+    return ret;
+}
+
+// the least of the deals the suit renamings give, which two deals share
+// exactly when they should share an index
+vector<uint64_t> orbitKey (const vector<uint64_t>& deal)
+{
+    size_t perm[Suit::NUM_SUIT] = {0, 1, 2, 3};
+    vector<uint64_t> best = deal;
+    while (next_permutation (perm, perm+Suit::NUM_SUIT))
+        best = min(best, permuteSuits (deal, perm));
+    return best;
+}
+
+// every deal of the rounds, checking that the indices of the deals of
+// rounds 0..last match the suit renamings one to one
+void checkOrbits (const HandIndexer& indexer, vector<uint64_t>& deal, uint64_t dead,
+                  map<vector<uint64_t>, uint64_t>& keys, map<uint64_t, vector<uint64_t> >& indices)
+{
+    const size_t round = deal.size();
+    if (round == indexer.rounds())
+    {
+        vector<CardSet> cards;
+        for (size_t i=0; i<deal.size(); i++)
+            cards.push_back (CardSet(deal[i]));
+        const uint64_t index = indexer.index (cards);
+        ASSERT_LT(index, indexer.size(round-1));
+        const vector<uint64_t> key = orbitKey (deal);
+        if (keys.count(key))
+        {
+            ASSERT_EQ(keys[key], index);
+        }
+        if (indices.count(index))
+        {
+            ASSERT_TRUE(indices[index] == key);
+        }
+        keys[key] = index;
+        indices[index] = key;
+        return;
+    }
+    combinations hands(STANDARD_DECK_SIZE, indexer.cards(round));
+    do
+    {
+        const uint64_t mask = hands.getMask();
+        if (mask & dead)
+            continue;
+        deal.push_back (mask);
+        checkOrbits (indexer, deal, dead | mask, keys, indices);
+        deal.pop_back ();
+    }
+    while (hands.next());
+}
+
+vector<CardSet> randomDeal (const HandIndexer& indexer, mt19937& rng)
+{
+    vector<size_t> deck(STANDARD_DECK_SIZE);
+    for (size_t c=0; c<STANDARD_DECK_SIZE; c++)
+        deck[c] = c;
+    shuffle (deck.begin(), deck.end(), rng);
+    vector<CardSet> deal(indexer.rounds());
+    size_t next = 0;
+    for (size_t i=0; i<indexer.rounds(); i++)
+        for (size_t j=0; j<indexer.cards(i); j++)
+            deal[i] |= CardSet(UINT64_C(1) << deck[next++]);
+    return deal;
+}
+}
+
+TEST(HandIndexer, Sizes) {
+    // counted with Burnside's lemma over the renamings of the suits
+    HandIndexer holdem({2, 3, 1, 1});
+    EXPECT_EQ(81u, holdem.size(0));
+    EXPECT_EQ(186696u, holdem.size(1));
+    EXPECT_EQ(5266044u, holdem.size(2));
+    EXPECT_EQ(151065864u, holdem.size(3));
+
+    HandIndexer omaha({4, 3, 1, 1});
+    EXPECT_EQ(3663u, omaha.size(0));
+    EXPECT_EQ(12796398u, omaha.size(1));
+    EXPECT_EQ(360661986u, omaha.size(2));
+    EXPECT_EQ(UINT64_C(9971940384), omaha.size(3));
+}
+
+TEST(HandIndexer, MatchesSuitRenamings) {
+    const vector<vector<size_t> > shapes = {{2}, {3}, {4}, {2, 1}, {1, 1, 1}};
+    for (size_t i=0; i<shapes.size(); i++)
+    {
+        HandIndexer indexer(shapes[i]);
+        vector<uint64_t> deal;
+        map<vector<uint64_t>, uint64_t> keys;
+        map<uint64_t, vector<uint64_t> > indices;
+        checkOrbits (indexer, deal, 0, keys, indices);
+        EXPECT_EQ(indexer.size(indexer.rounds()-1), keys.size()) << i;
+        EXPECT_EQ(keys.size(), indices.size()) << i;
+    }
+}
+
+TEST(HandIndexer, UnindexRoundTrip) {
+    HandIndexer holdem({2, 3, 1, 1});
+    for (size_t round=0; round<holdem.rounds(); round++)
+    {
+        const uint64_t step = holdem.size(round)/5000 + 1;
+        for (uint64_t index=0; index<holdem.size(round); index+=step)
+        {
+            vector<CardSet> deal = holdem.unindex (round, index);
+            CardSet all;
+            for (size_t i=0; i<=round; i++)
+            {
+                ASSERT_EQ(holdem.cards(i), deal[i].size());
+                ASSERT_FALSE(all.intersects (deal[i]));
+                all |= deal[i];
+            }
+            ASSERT_EQ(index, holdem.index (deal)) << round;
+        }
+    }
+    EXPECT_THROW(holdem.unindex (0, holdem.size(0)), invalid_argument);
+}
+
+TEST(HandIndexer, AllRoundsAndBatches) {
+    HandIndexer omaha({4, 3, 1, 1});
+    mt19937 rng(17);
+    const size_t N = 500;
+    const size_t ROUNDS = omaha.rounds();
+    vector<CardSet> deals;
+    vector<uint64_t> expected;
+    for (size_t n=0; n<N; n++)
+    {
+        vector<CardSet> deal = randomDeal (omaha, rng);
+        uint64_t indices[HandIndexer::MAX_ROUNDS];
+        omaha.indexAll (&deal[0], ROUNDS, indices);
+        for (size_t i=0; i<ROUNDS; i++)
+            ASSERT_EQ(omaha.index (&deal[0], i+1), indices[i]);
+        deals.insert (deals.end(), deal.begin(), deal.end());
+        expected.push_back (indices[ROUNDS-1]);
+    }
+
+    vector<uint64_t> indices(N);
+    omaha.indexBatch (ROUNDS-1, &deals[0], N, &indices[0]);
+    EXPECT_TRUE(indices == expected);
+
+    vector<CardSet> canonical(N*ROUNDS);
+    omaha.unindexBatch (ROUNDS-1, &indices[0], N, &canonical[0]);
+    for (size_t n=0; n<N; n++)
+        EXPECT_EQ(expected[n], omaha.index (&canonical[n*ROUNDS], ROUNDS));
+}
+
+TEST(HandIndexer, RejectsBadRounds) {
+    EXPECT_THROW(HandIndexer(vector<size_t>()), invalid_argument);
+    EXPECT_THROW((HandIndexer({2, 0})), invalid_argument);
+    EXPECT_THROW((HandIndexer({30, 7})), invalid_argument);
+    EXPECT_THROW(HandIndexer(vector<size_t>(HandIndexer::MAX_ROUNDS+1, 1)), invalid_argument);
+}
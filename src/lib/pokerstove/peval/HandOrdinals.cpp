@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "HandOrdinals.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include "Card.h"
+#include "Rank.h"
+#include "Suit.h"
+
+using namespace std;
+using namespace pokerstove;
+
+const size_t HandOrdinals::NUM_KINDS;
+
+HandOrdinals::HandOrdinals (Kind kind)
+    : _kind(kind)
+{
+    // every evaluator of a kind only sees the ranks, and whether the
+    // five cards are suited, so one hand of each multiset of ranks and
+    // one flush of each set of ranks make every class
+    for (size_t r0=0; r0<Rank::NUM_RANK; r0++)
+    for (size_t r1=r0; r1<Rank::NUM_RANK; r1++)
+    for (size_t r2=r1; r2<Rank::NUM_RANK; r2++)
+    for (size_t r3=r2; r3<Rank::NUM_RANK; r3++)
+    for (size_t r4=r3; r4<Rank::NUM_RANK; r4++)
+    {
+        if (r0 == r4)
+            continue;
+        const size_t ranks[FULL_HAND_SIZE] = { r0, r1, r2, r3, r4 };
+        CardSet dealt;
+        CardSet suited;
+        for (size_t i=0; i<FULL_HAND_SIZE; i++)
+        {
+            // deal round the suits, so that the hand is not a flush
+            Rank r(static_cast<uint8_t>(ranks[i]));
+            size_t s = i;
+            while (dealt.contains (Card(r, Suit(static_cast<uint8_t>(s % Suit::NUM_SUIT)))))
+                s++;
+            dealt.insert (Card(r, Suit(static_cast<uint8_t>(s % Suit::NUM_SUIT))));
+            suited.insert (Card(r, Suit::Clubs()));
+        }
+        _codes.push_back (evaluate (dealt).code());
+        if (suited.size() == FULL_HAND_SIZE)
+            _codes.push_back (evaluate (suited).code());
+    }
+    sort (_codes.begin(), _codes.end());
+    _codes.erase (unique (_codes.begin(), _codes.end()), _codes.end());
+}
+
+uint16_t HandOrdinals::ordinal (const PokerEvaluation& eval) const
+{
+    vector<int>::const_iterator it = lower_bound (_codes.begin(), _codes.end(), eval.code());
+    if (it == _codes.end() || *it != eval.code())
+        throw invalid_argument("HandOrdinals, not a five card class: " +
+                               boost::lexical_cast<string>(eval.code()));
+    return static_cast<uint16_t>(it - _codes.begin());
+}
+
+PokerEvaluation HandOrdinals::evaluate (const CardSet& cards) const
+{
+    switch (_kind)
+    {
+        case LOW_A5:    return cards.evaluateLowA5();
+        case LOW_2TO7:  return cards.evaluateLow2to7();
+        default:        return cards.evaluateHigh();
+    }
+}
+
+const HandOrdinals& HandOrdinals::shared (Kind kind)
+{
+    static const HandOrdinals ordinals[NUM_KINDS] =
+    {
+        HandOrdinals(HIGH),
+        HandOrdinals(LOW_A5),
+        HandOrdinals(LOW_2TO7)
+    };
+    return ordinals[kind];
+}
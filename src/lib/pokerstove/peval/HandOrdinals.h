@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_HANDORDINALS_H_
+#define PEVAL_HANDORDINALS_H_
+
+#include <cstdint>
+#include <vector>
+#include "CardSet.h"
+#include "PokerEvaluation.h"
+
+namespace pokerstove
+{
+/**
+ * A dense numbering of the distinct evaluations of five card hands, so
+ * that tables and histograms of evaluations can be kept as uint16_t.
+ * The ordinals keep the order of the codes, zero is the worst class and
+ * size()-1 the best, so two ordinals compare the same way as the
+ * evaluations they stand for.  The full deck has 7462 high classes, the
+ * short deck has fewer, see size().
+ *
+ * Each kind numbers the codes of one of the CardSet evaluators: HIGH for
+ * evaluateHigh and evaluateHighRanks, LOW_A5 for evaluateLowA5 and
+ * LOW_2TO7 for evaluateLow2to7.  Those evaluators give the code of the
+ * best five cards for larger hands, so the ordinals cover them too, but
+ * not hands of fewer than five cards.  The one exception is evaluateLowA5
+ * of a larger hand with only four ranks, which has no five card class.
+ */
+class HandOrdinals
+{
+public:
+    enum Kind
+    {
+        HIGH     = 0,
+        LOW_A5   = 1,
+        LOW_2TO7 = 2
+    };
+    static const size_t NUM_KINDS = 3;
+
+    /**
+     * enumerate the classes of the kind, which takes a fraction of a
+     * millisecond
+     */
+    explicit HandOrdinals (Kind kind);
+
+    Kind kind () const { return _kind; }
+
+    /**
+     * the number of distinct classes
+     */
+    size_t size () const { return _codes.size(); }
+
+    /**
+     * the ordinal of an evaluation of this kind.  Throws
+     * std::invalid_argument for codes which are not a five card class.
+     */
+    uint16_t ordinal (const PokerEvaluation& eval) const;
+
+    /**
+     * the evaluation of an ordinal, ordinal < size()
+     */
+    PokerEvaluation evaluation (uint16_t ordinal) const
+    {
+        return PokerEvaluation(_codes[ordinal]);
+    }
+
+    /**
+     * the evaluation of five or more cards with the evaluator of the kind
+     */
+    PokerEvaluation evaluate (const CardSet& cards) const;
+
+    /**
+     * the ordinal of five or more cards, ordinal (evaluate (cards))
+     */
+    uint16_t evaluateOrdinal (const CardSet& cards) const
+    {
+        return ordinal (evaluate (cards));
+    }
+
+    /**
+     * the ordinals of each kind shared by the whole process, built on
+     * first use
+     */
+    static const HandOrdinals& shared (Kind kind);
+
+private:
+    Kind             _kind;
+    std::vector<int> _codes;    //!< sorted, the index is the ordinal
+};
+}
+
+#endif  // PEVAL_HANDORDINALS_H_
@@ -0,0 +1,70 @@
+#include <random>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <pokerstove/util/combinations.h>
+#include "Card.h"
+#include "HandOrdinals.h"
+
+using namespace pokerstove;
+using namespace std;
+
+TEST(HandOrdinals, Sizes) {
+    // the short deck has 126 sets of five ranks, the same again suited,
+    // and 1152 multisets of five ranks with a pair
+    EXPECT_EQ(126+126+1152, HandOrdinals::shared(HandOrdinals::HIGH).size());
+
+    // ace to five low sees no flushes
+    EXPECT_EQ(126+1152, HandOrdinals::shared(HandOrdinals::LOW_A5).size());
+    EXPECT_EQ(126+126+1152, HandOrdinals::shared(HandOrdinals::LOW_2TO7).size());
+}
+
+TEST(HandOrdinals, KeepOrder) {
+    for (size_t k=0; k<HandOrdinals::NUM_KINDS; k++)
+    {
+        const HandOrdinals& ordinals = HandOrdinals::shared(static_cast<HandOrdinals::Kind>(k));
+        EXPECT_EQ(k, ordinals.kind());
+        for (size_t i=0; i<ordinals.size(); i++)
+        {
+            PokerEvaluation eval = ordinals.evaluation(static_cast<uint16_t>(i));
+            EXPECT_EQ(i, ordinals.ordinal(eval));
+            if (i > 0)
+            {
+                EXPECT_LT(ordinals.evaluation(static_cast<uint16_t>(i-1)), eval);
+            }
+        }
+    }
+    const HandOrdinals& high = HandOrdinals::shared(HandOrdinals::HIGH);
+    EXPECT_EQ(high.size()-1, high.evaluateOrdinal(CardSet("AcKcQcJcTc")));
+    EXPECT_EQ(0, high.evaluateOrdinal(CardSet("6c7d8h9sJc")));
+    EXPECT_THROW(high.ordinal(CardSet("AcKd").evaluateHigh()), invalid_argument);
+}
+
+TEST(HandOrdinals, CoverEveryHand) {
+    for (size_t k=0; k<HandOrdinals::NUM_KINDS; k++)
+    {
+        const HandOrdinals& ordinals = HandOrdinals::shared(static_cast<HandOrdinals::Kind>(k));
+        vector<bool> seen(ordinals.size(), false);
+        combinations hands(STANDARD_DECK_SIZE, FULL_HAND_SIZE);
+        do
+            seen[ordinals.evaluateOrdinal(CardSet(hands.getMask()))] = true;
+        while (hands.next());
+        EXPECT_EQ(seen.end(), find(seen.begin(), seen.end(), false)) << k;
+
+        // larger hands play their best five cards, but ace to five low
+        // can leave a larger hand of four ranks without a five card class
+        if (k == HandOrdinals::LOW_A5)
+            continue;
+        mt19937 rng(18);
+        vector<int> deck(STANDARD_DECK_SIZE);
+        for (size_t i=0; i<deck.size(); i++)
+            deck[i] = static_cast<int>(i);
+        for (size_t t=0; t<2000; t++)
+        {
+            shuffle(deck.begin(), deck.end(), rng);
+            CardSet hand;
+            for (size_t i=0; i<FULL_HAND_SIZE+t%3; i++)
+                hand.insert(Card(deck[i]));
+            EXPECT_NO_THROW(ordinals.evaluateOrdinal(hand)) << hand.str();
+        }
+    }
+}
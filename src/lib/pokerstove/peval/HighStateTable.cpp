@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "HighStateTable.h"
+
+#include <map>
+#include "Card.h"
+#include "Rank.h"
+#include "Suit.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const MappedTable::Format FORMAT =
+    { "HighStateTable", "a state table", "PSHSTAT", HighStateTable::VERSION };
+
+typedef pair<uint64_t,uint64_t> StateKey;
+
+const uint64_t SUIT_MASK = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+
+// a suit which is marked dead can no longer make a flush
+const uint64_t DEAD_SUIT = UINT64_C(1) << Rank::NUM_RANK;
+
+/**
+ * What evaluateHigh can still tell apart about a set of cards by the
+ * time there are MAX_CARDS of them: the number of cards, the count of
+ * each rank, and the ranks of each suit which has enough cards to still
+ * make a flush.
+ */
+StateKey stateKey (const CardSet& cards)
+{
+    const size_t n = cards.size();
+    const uint64_t mask = cards.mask();
+    uint64_t ranks = n;
+    for (size_t r=0; r<Rank::NUM_RANK; r++)
+    {
+        uint64_t count = 0;
+        for (size_t s=0; s<Suit::NUM_SUIT; s++)
+            count += (mask >> (s*Rank::NUM_RANK + r)) & 0x01;
+        ranks |= count << (3 + 3*r);
+    }
+    uint64_t suits = 0;
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+    {
+        uint64_t smask = (mask >> (s*Rank::NUM_RANK)) & SUIT_MASK;
+        size_t count = CardSet(smask).size();
+        if (count + HighStateTable::MAX_CARDS - n < 5)
+            smask = DEAD_SUIT;
+        suits |= smask << (s*(Rank::NUM_RANK+1));
+    }
+    return StateKey(ranks, suits);
+}
+
+bool isDead (uint64_t suits, size_t s)
+{
+    return ((suits >> (s*(Rank::NUM_RANK+1))) & DEAD_SUIT) != 0;
+}
+}
+
+HighStateTable::HighStateTable (const string& filename)
+    : _table(FORMAT, filename, sizeof(Header))
+    , _header(&_table.header<Header>())
+    , _entries(NULL)
+{
+    _table.require (_header->maxCards == MAX_CARDS &&
+                    _header->numColumns == NUM_COLUMNS, "built for another deck");
+    _table.require (_header->numStates != 0, "corrupt table");
+    _entries = static_cast<const uint32_t*>(
+        _table.data (_header->dataOffset, _header->numStates*NUM_COLUMNS*sizeof(uint32_t)));
+    _table.adviseHugePages ();
+}
+
+vector<uint32_t> HighStateTable::build ()
+{
+    // breadth first from the empty hand, each state keeps the first set
+    // of cards which reached it
+    map<StateKey, uint32_t> index;
+    vector<CardSet> reps;
+    vector<uint32_t> entries;
+    reps.push_back (CardSet());
+    index[stateKey (CardSet())] = 0;
+
+    for (size_t i=0; i<reps.size(); i++)
+    {
+        const CardSet rep = reps[i];
+        const size_t n = rep.size();
+        entries.resize ((i+1)*NUM_COLUMNS, 0);
+        entries[i*NUM_COLUMNS] = static_cast<uint32_t>(rep.evaluateHigh().code());
+        const uint64_t suits = stateKey (rep).second;
+
+        for (size_t c=0; c<STANDARD_DECK_SIZE; c++)
+        {
+            // a card the representative holds may still be new to the
+            // other hands of the state, if its suit is dead: they are
+            // the same as the hand with that rank in any other dead suit
+            CardSet card(UINT64_C(1) << c);
+            const size_t rank = c % Rank::NUM_RANK;
+            if (rep.contains (card) && isDead (suits, c / Rank::NUM_RANK))
+                for (size_t s=0; s<Suit::NUM_SUIT; s++)
+                {
+                    CardSet other(UINT64_C(1) << (s*Rank::NUM_RANK + rank));
+                    if (isDead (suits, s) && !rep.contains (other))
+                        card = other;
+                }
+            if (rep.contains (card))
+                continue;
+
+            CardSet hand = rep | card;
+            uint32_t& entry = entries[i*NUM_COLUMNS + 1 + c];
+            if (n+1 == MAX_CARDS)
+            {
+                entry = static_cast<uint32_t>(hand.evaluateHigh().code());
+                continue;
+            }
+            StateKey key = stateKey (hand);
+            map<StateKey, uint32_t>::iterator it = index.find (key);
+            if (it == index.end())
+            {
+                it = index.insert (make_pair (key, static_cast<uint32_t>(reps.size()))).first;
+                reps.push_back (hand);
+            }
+            entry = it->second;
+        }
+    }
+    return entries;
+}
+
+void HighStateTable::write (const string& filename)
+{
+    vector<uint32_t> entries = build ();
+
+    Header header = Header();
+    header.maxCards   = MAX_CARDS;
+    header.numColumns = NUM_COLUMNS;
+    header.numStates  = entries.size()/NUM_COLUMNS;
+    header.dataOffset = DATA_OFFSET;
+    MappedTable::write (FORMAT, filename, header, DATA_OFFSET, entries);
+}
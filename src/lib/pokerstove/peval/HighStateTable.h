@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_HIGHSTATETABLE_H_
+#define PEVAL_HIGHSTATETABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <pokerstove/util/lastbit.h>
+#include "CardSet.h"
+#include "MappedTable.h"
+#include "PokerEvaluation.h"
+
+namespace pokerstove
+{
+/**
+ * A card by card state machine for high hands of up to seven cards,
+ * memory mapped from a file built by ps-lut.  Each card of a hand moves
+ * from one state to the next with a single load, and the move on the
+ * seventh card lands on the evaluation itself, so a seven card hand is
+ * seven dependent loads and no branches on the cards.
+ *
+ * A state remembers only what CardSet::evaluateHigh can still see by
+ * the seventh card: how many of each rank have been dealt, and the ranks
+ * of each suit which could still make a flush.  The codes are the same as
+ * those of evaluateHigh, so they compare and print the same way.
+ *
+ * The cards of a hand must be distinct.
+ *
+ * File layout: a Header, padding up to dataOffset, and then numStates
+ * rows of NUM_COLUMNS entries, in native byte order.  The first entry of
+ * a row is the evaluation of the cards which lead to it, entry 1+c is the
+ * move on the card with code c.  The rows start on a page boundary, and
+ * on linux the mapping is marked as a candidate for huge pages.
+ */
+class HighStateTable
+{
+public:
+    static const uint32_t VERSION     = 1;
+    static const size_t   MAX_CARDS   = 7;
+    static const size_t   NUM_COLUMNS = STANDARD_DECK_SIZE+1;
+    static const uint64_t DATA_OFFSET = 4096;
+
+    struct Header
+    {
+        MappedTable::Prefix prefix; //!< "PSHSTAT", VERSION
+        uint32_t maxCards;          //!< MAX_CARDS
+        uint32_t numColumns;        //!< NUM_COLUMNS
+        uint64_t numStates;
+        uint64_t dataOffset;        //!< where the rows start
+    };
+
+    /**
+     * map a table file, throws std::runtime_error if it can not be read or
+     * was not built for this deck and version
+     */
+    explicit HighStateTable (const std::string& filename);
+
+    size_t numStates () const { return _header->numStates; }
+
+    /**
+     * the high evaluation of the cards, the same as cards.evaluateHigh().
+     * Hands of more than MAX_CARDS cards are passed on to evaluateHigh.
+     */
+    PokerEvaluation evaluate (const CardSet& cards) const
+    {
+        if (cards.size() > MAX_CARDS)
+            return cards.evaluateHigh();
+        uint64_t mask = cards.mask();
+        uint32_t state = 0;
+        uint32_t next = 0;
+        size_t n = 0;
+        for (; mask != 0; mask &= mask-1, n++)
+        {
+            next  = _entries[state*NUM_COLUMNS + 1 + lastbit64 (mask)];
+            state = next;
+        }
+        return PokerEvaluation(static_cast<int>(n == MAX_CARDS ? next : _entries[state*NUM_COLUMNS]));
+    }
+
+    /**
+     * the high evaluation of n <= MAX_CARDS distinct card codes
+     */
+    PokerEvaluation evaluate (const uint8_t* cards, size_t n) const
+    {
+        uint32_t state = 0;
+        for (size_t i=0; i+1<n; i++)
+            state = _entries[state*NUM_COLUMNS + 1 + cards[i]];
+        if (n == MAX_CARDS)
+            return PokerEvaluation(static_cast<int>(_entries[state*NUM_COLUMNS + 1 + cards[n-1]]));
+        if (n > 0)
+            state = _entries[state*NUM_COLUMNS + 1 + cards[n-1]];
+        return PokerEvaluation(static_cast<int>(_entries[state*NUM_COLUMNS]));
+    }
+
+    /**
+     * build the rows of the state machine, numStates()*NUM_COLUMNS entries
+     */
+    static std::vector<uint32_t> build ();
+
+    /**
+     * build the state machine and write it to a file
+     */
+    static void write (const std::string& filename);
+
+private:
+    MappedTable     _table;
+    const Header*   _header;
+    const uint32_t* _entries;
+};
+}
+
+#endif  // PEVAL_HIGHSTATETABLE_H_
@@ -0,0 +1,96 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/util/combinations.h>
+#include "Card.h"
+#include "HighStateTable.h"
+#include "PokerHandEvaluator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const char* FILENAME = "HighStateTable.test.bin";
+
+class HighStateTableTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        HighStateTable::write(FILENAME);
+        table.reset(new HighStateTable(FILENAME));
+    }
+
+    static void TearDownTestCase()
+    {
+        table.reset();
+        remove(FILENAME);
+    }
+
+    static boost::shared_ptr<const HighStateTable> table;
+};
+
+boost::shared_ptr<const HighStateTable> HighStateTableTest::table;
+}
+
+TEST_F(HighStateTableTest, MatchesEvaluateHigh) {
+    for (size_t k=0; k<=HighStateTable::MAX_CARDS; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        size_t mismatches = 0;
+        do
+        {
+            CardSet hand(hands.getMask());
+            if (table->evaluate(hand) != hand.evaluateHigh())
+                mismatches++;
+        }
+        while (hands.next());
+        EXPECT_EQ(0, mismatches) << k << " cards";
+    }
+}
+
+TEST_F(HighStateTableTest, CardCodes) {
+    CardSet hand("AsKsQsJsTs9h9d");
+    vector<Card> cards = hand.cards();
+    uint8_t codes[HighStateTable::MAX_CARDS];
+    for (size_t n=0; n<=cards.size(); n++)
+    {
+        CardSet part;
+        for (size_t i=0; i<n; i++)
+        {
+            // any order will do
+            codes[i] = static_cast<uint8_t>(cards[n-1-i].code());
+            part.insert(cards[n-1-i]);
+        }
+        EXPECT_EQ(part.evaluateHigh(), table->evaluate(codes, n));
+    }
+}
+
+TEST_F(HighStateTableTest, SelectedPerEvaluator) {
+    boost::shared_ptr<PokerHandEvaluator> plain = PokerHandEvaluator::alloc("h");
+    boost::shared_ptr<PokerHandEvaluator> states = PokerHandEvaluator::alloc("h");
+    states->setHighStateTable(table);
+    CardSet hand("AhKh");
+    CardSet board("QhJh9c8d6h");
+    EXPECT_EQ(plain->evaluateHand(hand, board).high(),
+              states->evaluateHand(hand, board).high());
+    EXPECT_EQ(plain->evaluateHand(hand, board).str(),
+              states->evaluateHand(hand, board).str());
+
+    boost::shared_ptr<PokerHandEvaluator> stud = PokerHandEvaluator::alloc("s");
+    stud->setHighStateTable(table);
+    EXPECT_EQ(CardSet("AhAdKhKd6s6c7h").evaluateHigh(),
+              stud->evaluateHand(CardSet("AhAdKhKd6s6c7h"), CardSet()).high());
+
+    EXPECT_THROW(PokerHandEvaluator::alloc("r")->setHighStateTable(table), runtime_error);
+}
+
+TEST(HighStateTable, RejectsOtherFiles) {
+    FILE* f = fopen(FILENAME, "wb");
+    fputs("not a state table", f);
+    fclose(f);
+    EXPECT_THROW(HighStateTable table(FILENAME), runtime_error);
+    remove(FILENAME);
+    EXPECT_THROW(HighStateTable table(FILENAME), runtime_error);
+}
@@ -6,6 +6,7 @@
 #define PEVAL_HOLDEMHANDEVALUATOR_H_
 
 #include "Holdem.h"
+#include "HighStateTable.h"
 #include "PokerHandEvaluator.h"
 
 namespace pokerstove
@@ -23,6 +24,8 @@ public:
         //throw std::invalid_argument ("HHE: incorrect number of pocket cards");
         CardSet h = hand;
         h.insert(board);
+        if (_highStates)
+            return PokerHandEvaluation(_highStates->evaluate(h));
         return PokerHandEvaluation(h.evaluateHigh());
     }
 
@@ -43,6 +46,14 @@ public:
     virtual size_t handSize() const { return NUM_HOLDEM_POCKET; }
     virtual size_t boardSize() const { return BOARD_SIZE; }
     virtual size_t evaluationSize() const { return 1; }
+
+    virtual void setHighStateTable(boost::shared_ptr<const HighStateTable> table)
+    {
+        _highStates = table;
+    }
+
+private:
+    boost::shared_ptr<const HighStateTable> _highStates;
 };
 
 }
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_LOWBALLA5HANDEVALUATOR_H_
+#define PEVAL_LOWBALLA5HANDEVALUATOR_H_
+
+#include "LowballTable.h"
+#include "PokerHandEvaluator.h"
+
+namespace pokerstove
+{
+/**
+ * A specialized hand evaluator for ace to five lowball, single or triple
+ * draw.  Suits do not matter.
+ */
+class LowballA5HandEvaluator : public PokerHandEvaluator
+{
+public:
+    LowballA5HandEvaluator()
+        : PokerHandEvaluator()
+        , _lowball(&LowballTable::shared())
+        , _numDraws(0)
+    {}
+
+    virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
+    {
+        return PokerHandEvaluation(_lowball->evaluateLowA5(hand));
+    }
+
+    virtual PokerEvaluation evaluateRanks(const CardSet& hand, const CardSet& board=CardSet(0)) const
+    {
+        return _lowball->evaluateLowA5(hand);
+    }
+
+    virtual bool usesSuits() const
+    {
+        return false;
+    }
+
+    virtual size_t handSize() const            { return 5; }
+    virtual size_t boardSize() const           { return 0; }
+    virtual size_t evaluationSize() const      { return 1; }
+    virtual size_t numDraws() const            { return _numDraws; }
+    virtual void setNumDraws(size_t sz)        { _numDraws = sz; }
+
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        _lowballTable = table;
+        _lowball = (table ? table.get() : &LowballTable::shared());
+    }
+
+private:
+    const LowballTable* _lowball;
+    boost::shared_ptr<const LowballTable> _lowballTable;
+    size_t _numDraws;
+};
+
+}
+#endif  // PEVAL_LOWBALLA5HANDEVALUATOR_H_
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "LowballTable.h"
+
+#include "Card.h"
+#include "CardSetGenerators.h"
+#include "RankTable.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const MappedTable::Format FORMAT =
+    { "LowballTable", "a lowball table", "PSLOWBL", LowballTable::VERSION };
+}
+
+const size_t LowballTable::MAX_CARDS;
+const size_t LowballTable::NUM_MASKS;
+
+LowballTable::LowballTable ()
+    : _table()
+    , _bitops(CardSetBitops::best())
+    , _built(build ())
+{
+    setEntries (&_built[0]);
+}
+
+LowballTable::LowballTable (const string& filename)
+    : _table(new MappedTable(FORMAT, filename, sizeof(Header)))
+    , _bitops(CardSetBitops::best())
+    , _built()
+{
+    const Header& header = _table->header<Header>();
+    _table->require (header.maxCards == MAX_CARDS &&
+                     header.numMultisets == numMultisets(), "built for another deck");
+    setEntries (static_cast<const int32_t*>(
+        _table->data (header.dataOffset, numEntries()*sizeof(int32_t))));
+}
+
+void LowballTable::setEntries (const int32_t* entries)
+{
+    _lowA5   = entries;
+    _low2to7 = entries + numMultisets();
+    _low8    = entries + 2*numMultisets();
+    for (size_t n=0; n<=MAX_CARDS; n++)
+        _offsets[n] = RankTable::offset (n);
+}
+
+size_t LowballTable::numMultisets ()
+{
+    return RankTable::offset (MAX_CARDS+1);
+}
+
+vector<int32_t> LowballTable::build ()
+{
+    vector<int32_t> entries(numEntries(), 0);
+    int32_t* lowA5   = &entries[0];
+    int32_t* low2to7 = &entries[numMultisets()];
+    int32_t* low8    = &entries[2*numMultisets()];
+
+    // the hands in increasing size, as those of more than five cards
+    // look up the ones of a card less
+    for (size_t n=0; n<=MAX_CARDS; n++)
+    {
+        const size_t offset = RankTable::offset (n);
+        visitCardSets (n, Card::RANK, [&](const CardSet& hand, size_t)
+        {
+            const size_t index = offset + hand.rankColex();
+            lowA5[index] = hand.evaluateLowA5().code();
+            if (n <= FULL_HAND_SIZE)
+            {
+                low2to7[index] = hand.evaluateRanksLow2to7().code();
+                return;
+            }
+
+            // the best five of a larger hand are the best five of the
+            // hand less one of its cards
+            PokerEvaluation best;
+            for (uint64_t m=hand.mask(); m != 0; m &= m-1)
+            {
+                CardSet less(hand.mask() & ~(m & ~(m-1)));
+                PokerEvaluation e(low2to7[RankTable::offset (n-1) + less.rankColex()]);
+                if (e > best)
+                    best = e;
+            }
+            low2to7[index] = best.code();
+        });
+    }
+
+    for (size_t m=0; m<NUM_MASKS; m++)
+        low8[m] = CardSet(m).evaluate8LowA5().code();
+    return entries;
+}
+
+void LowballTable::write (const string& filename)
+{
+    vector<int32_t> entries = build ();
+
+    Header header = Header();
+    header.maxCards     = MAX_CARDS;
+    header.numMultisets = static_cast<uint32_t>(numMultisets());
+    header.dataOffset   = DATA_OFFSET;
+    MappedTable::write (FORMAT, filename, header, DATA_OFFSET, entries);
+}
+
+const LowballTable& LowballTable::shared ()
+{
+    static const LowballTable table;
+    return table;
+}
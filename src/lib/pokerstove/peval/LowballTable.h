@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_LOWBALLTABLE_H_
+#define PEVAL_LOWBALLTABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "CardSet.h"
+#include "CardSetBitops.h"
+#include "MappedTable.h"
+#include "PokerEvaluation.h"
+#include "Rank.h"
+
+namespace pokerstove
+{
+/**
+ * The lowball evaluations of CardSet as table lookups:
+ * - lowA5:    evaluateLowA5 of each multiset of up to MAX_CARDS ranks, at
+ *             offset(n) + rankColex, as in RankTable
+ * - low2to7:  evaluateRanksLow2to7 of each multiset, the same way
+ * - low8:     evaluate8LowA5 of each rank mask, which is all it looks at
+ *
+ * Ace to five low never sees suits, and deuce to seven low only sees them
+ * when a suit has five cards, so evaluateLow2to7 passes those hands on to
+ * CardSet, as does everything else for hands of more than MAX_CARDS.
+ * The codes are the same as those of CardSet.
+ *
+ * The default constructor builds the tables in memory, ps-lut
+ * --lowball-table writes the same tables to a file for the other
+ * constructor to map.  File layout: a Header, padding up to dataOffset,
+ * then the three tables in the order above, as int32 in native byte order.
+ */
+class LowballTable
+{
+public:
+    static const uint32_t VERSION     = 1;
+    static const size_t   MAX_CARDS   = 7;
+    static const size_t   NUM_MASKS   = 1 << Rank::NUM_RANK;
+    static const uint64_t DATA_OFFSET = 4096;
+
+    struct Header
+    {
+        MappedTable::Prefix prefix; //!< "PSLOWBL", VERSION
+        uint32_t maxCards;          //!< MAX_CARDS
+        uint32_t numMultisets;      //!< numMultisets()
+        uint64_t dataOffset;        //!< where the entries start
+    };
+
+    /**
+     * build the tables, which takes a few milliseconds
+     */
+    LowballTable ();
+
+    /**
+     * map a table file, throws std::runtime_error if it can not be read or
+     * was not built for this deck and version
+     */
+    explicit LowballTable (const std::string& filename);
+
+    /**
+     * the number of multisets of up to MAX_CARDS ranks
+     */
+    static size_t numMultisets ();
+    static size_t numEntries () { return 2*numMultisets() + NUM_MASKS; }
+
+    PokerEvaluation evaluateLowA5 (const CardSet& cards) const
+    {
+        const size_t n = _bitops.size (cards.mask());
+        if (n > MAX_CARDS)
+            return cards.evaluateLowA5();
+        return PokerEvaluation(_lowA5[_offsets[n] + _bitops.rankColex (cards.mask())]);
+    }
+
+    PokerEvaluation evaluate8LowA5 (const CardSet& cards) const
+    {
+        return PokerEvaluation(_low8[cards.rankMask()]);
+    }
+
+    /**
+     * evaluate8LowA5 of the cards of a rank mask, such as CardSet(ranks)
+     */
+    PokerEvaluation evaluate8LowA5 (int ranks) const
+    {
+        return PokerEvaluation(_low8[ranks]);
+    }
+
+    PokerEvaluation evaluateRanksLow2to7 (const CardSet& cards) const
+    {
+        const size_t n = _bitops.size (cards.mask());
+        if (n > MAX_CARDS)
+            return cards.evaluateRanksLow2to7();
+        return PokerEvaluation(_low2to7[_offsets[n] + _bitops.rankColex (cards.mask())]);
+    }
+
+    PokerEvaluation evaluateLow2to7 (const CardSet& cards) const
+    {
+        const size_t n = _bitops.size (cards.mask());
+        if (n > MAX_CARDS ||
+            (n >= FULL_HAND_SIZE && _bitops.countMaxSuit (cards.mask()) >= FULL_HAND_SIZE))
+            return cards.evaluateLow2to7();
+        return PokerEvaluation(_low2to7[_offsets[n] + _bitops.rankColex (cards.mask())]);
+    }
+
+    /**
+     * build the entries, numEntries() of them
+     */
+    static std::vector<int32_t> build ();
+
+    /**
+     * build the tables and write them to a file
+     */
+    static void write (const std::string& filename);
+
+    /**
+     * tables shared by the whole process, built on first use
+     */
+    static const LowballTable& shared ();
+
+private:
+    void setEntries (const int32_t* entries);
+
+    boost::shared_ptr<const MappedTable> _table;    //!< empty if built
+    const CardSetBitops& _bitops;
+    std::vector<int32_t> _built;
+    const int32_t* _lowA5;
+    const int32_t* _low2to7;
+    const int32_t* _low8;
+    size_t         _offsets[MAX_CARDS+1];
+};
+}
+
+#endif  // PEVAL_LOWBALLTABLE_H_
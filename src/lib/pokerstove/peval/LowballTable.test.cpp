@@ -0,0 +1,215 @@
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <boost/shared_ptr.hpp>
+#include "Card.h"
+#include "CardSetGenerators.h"
+#include "LowballTable.h"
+#include "PokerHandEvaluator.h"
+#include "UniversalHandEvaluator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const char* FILENAME = "LowballTable.test.bin";
+
+// every multiset of up to LowballTable::MAX_CARDS ranks, dealt into the
+// suits in turn from the given one
+vector<CardSet> rankHands (size_t firstSuit)
+{
+    vector<CardSet> hands;
+    for (size_t n=0; n<=LowballTable::MAX_CARDS; n++)
+        visitCardSets(n, Card::RANK, [&](const CardSet& ranks, size_t)
+        {
+            CardSet hand;
+            size_t dealt = 0;
+            for (size_t r=0; r<Rank::NUM_RANK; r++)
+                for (size_t i=0; i<ranks.count(Rank(static_cast<uint8_t>(r))); i++, dealt++)
+                    hand.insert(Card(Rank(static_cast<uint8_t>(r)),
+                                     Suit(static_cast<uint8_t>((firstSuit+dealt) % Suit::NUM_SUIT))));
+            hands.push_back(hand);
+        });
+    return hands;
+}
+
+class LowballTableTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        LowballTable::write(FILENAME);
+        mapped.reset(new LowballTable(FILENAME));
+    }
+
+    static void TearDownTestCase()
+    {
+        mapped.reset();
+        remove(FILENAME);
+    }
+
+    static boost::shared_ptr<const LowballTable> mapped;
+};
+
+boost::shared_ptr<const LowballTable> LowballTableTest::mapped;
+}
+
+TEST(LowballTable, AllRankMultisets) {
+    // each multiset dealt two ways, so that the ranks of a hand are
+    // spread over different suits
+    const LowballTable& table = LowballTable::shared();
+    for (size_t first=0; first<2; first++)
+    {
+        vector<CardSet> hands = rankHands(first);
+        // the multisets which hold no rank more than four times
+        EXPECT_EQ(10945, hands.size());
+        EXPECT_EQ(11440, LowballTable::numMultisets());
+        size_t mismatches = 0;
+        for (size_t i=0; i<hands.size(); i++)
+        {
+            const CardSet& hand = hands[i];
+            if (table.evaluateLowA5(hand) != hand.evaluateLowA5())
+                mismatches++;
+            if (table.evaluate8LowA5(hand) != hand.evaluate8LowA5())
+                mismatches++;
+            if (table.evaluateRanksLow2to7(hand) != hand.evaluateRanksLow2to7())
+                mismatches++;
+            if (table.evaluateLow2to7(hand) != hand.evaluateLow2to7())
+                mismatches++;
+        }
+        EXPECT_EQ(0, mismatches);
+    }
+}
+
+TEST(LowballTable, RandomHands) {
+    // suited hands, which deuce to seven low passes on, and some larger
+    // than the tables
+    const LowballTable& table = LowballTable::shared();
+    mt19937 rng(21);
+    vector<int> deck(STANDARD_DECK_SIZE);
+    for (size_t i=0; i<deck.size(); i++)
+        deck[i] = static_cast<int>(i);
+    size_t mismatches = 0;
+    for (size_t t=0; t<20000; t++)
+    {
+        size_t deckSize = (t%2 == 0 ? 2*Rank::NUM_RANK : STANDARD_DECK_SIZE);
+        shuffle(deck.begin(), deck.begin()+deckSize, rng);
+        CardSet hand;
+        for (size_t i=0; i<1+t%(LowballTable::MAX_CARDS+2); i++)
+            hand.insert(Card(deck[i]));
+        if (table.evaluateLowA5(hand) != hand.evaluateLowA5())
+            mismatches++;
+        if (table.evaluate8LowA5(hand) != hand.evaluate8LowA5())
+            mismatches++;
+        if (table.evaluateLow2to7(hand) != hand.evaluateLow2to7())
+            mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST(LowballTable, UsedByEvaluators) {
+    struct Game
+    {
+        const char*  id;
+        size_t       pocket;
+        size_t       board;
+        size_t       use;
+        evalFunction evalA;
+        evalFunction evalB;
+    };
+    const Game games[] =
+    {
+        { "r", 7, 0, 0, &CardSet::evaluateLowA5,   NULL },
+        { "e", 7, 0, 0, &CardSet::evaluateHigh,    &CardSet::evaluate8LowA5 },
+        { "t", 5, 0, 0, &CardSet::evaluateLow2to7, NULL },
+        { "o", 4, 5, 2, &CardSet::evaluateHigh,    &CardSet::evaluate8LowA5 },
+    };
+
+    mt19937 rng(22);
+    vector<int> deck(STANDARD_DECK_SIZE);
+    for (size_t i=0; i<deck.size(); i++)
+        deck[i] = static_cast<int>(i);
+    for (const Game& game : games)
+    {
+        boost::shared_ptr<PokerHandEvaluator> evaluator = PokerHandEvaluator::alloc(game.id);
+        UniversalHandEvaluator universal(static_cast<int>(game.pocket), static_cast<int>(game.pocket),
+                                         static_cast<int>(game.board), static_cast<int>(game.board),
+                                         static_cast<int>(game.use), game.evalA, game.evalB);
+        size_t mismatches = 0;
+        for (size_t t=0; t<5000; t++)
+        {
+            shuffle(deck.begin(), deck.end(), rng);
+            CardSet pocket, board;
+            for (size_t i=0; i<game.pocket; i++)
+                pocket.insert(Card(deck[i]));
+            for (size_t i=0; i<game.board; i++)
+                board.insert(Card(deck[game.pocket+i]));
+            PokerHandEvaluation expected = universal.evaluateHand(pocket, board);
+            PokerHandEvaluation actual = evaluator->evaluateHand(pocket, board);
+            for (size_t e=0; e<universal.evaluationSize(); e++)
+                if (expected.eval(e) != actual.eval(e))
+                    mismatches++;
+        }
+        EXPECT_EQ(0, mismatches) << game.id;
+    }
+}
+
+TEST_F(LowballTableTest, MappedMatchesBuilt) {
+    const LowballTable& built = LowballTable::shared();
+    vector<CardSet> hands = rankHands(0);
+    size_t mismatches = 0;
+    for (size_t i=0; i<hands.size(); i++)
+    {
+        if (mapped->evaluateLowA5(hands[i]) != built.evaluateLowA5(hands[i]))
+            mismatches++;
+        if (mapped->evaluateLow2to7(hands[i]) != built.evaluateLow2to7(hands[i]))
+            mismatches++;
+        if (mapped->evaluate8LowA5(hands[i]) != built.evaluate8LowA5(hands[i]))
+            mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST_F(LowballTableTest, SelectedPerEvaluator) {
+    // every lowball game gives the same evaluations with the mapped
+    // table, and again once it goes back to the built one
+    const char* games[] = { "r", "e", "q", "l", "T", "k", "t", "o" };
+    mt19937 rng(23);
+    vector<int> deck(STANDARD_DECK_SIZE);
+    for (size_t i=0; i<deck.size(); i++)
+        deck[i] = static_cast<int>(i);
+    for (const char* game : games)
+    {
+        boost::shared_ptr<PokerHandEvaluator> built = PokerHandEvaluator::alloc(game);
+        boost::shared_ptr<PokerHandEvaluator> table = PokerHandEvaluator::alloc(game);
+        size_t mismatches = 0;
+        for (size_t t=0; t<2000; t++)
+        {
+            table->setLowballTable(t%2 == 0 ? mapped : boost::shared_ptr<const LowballTable>());
+            shuffle(deck.begin(), deck.end(), rng);
+            CardSet pocket, board;
+            for (size_t i=0; i<built->handSize(); i++)
+                pocket.insert(Card(deck[i]));
+            for (size_t i=0; i<built->boardSize(); i++)
+                board.insert(Card(deck[built->handSize()+i]));
+            PokerHandEvaluation expected = built->evaluateHand(pocket, board);
+            PokerHandEvaluation actual = table->evaluateHand(pocket, board);
+            for (size_t e=0; e<built->evaluationSize(); e++)
+                if (expected.eval(e) != actual.eval(e))
+                    mismatches++;
+        }
+        EXPECT_EQ(0, mismatches) << game;
+    }
+
+    EXPECT_THROW(PokerHandEvaluator::alloc("h")->setLowballTable(mapped), runtime_error);
+}
+
+TEST(LowballTable, RejectsOtherFiles) {
+    FILE* f = fopen(FILENAME, "wb");
+    fputs("not a lowball table", f);
+    fclose(f);
+    EXPECT_THROW(LowballTable table(FILENAME), runtime_error);
+    remove(FILENAME);
+    EXPECT_THROW(LowballTable table(FILENAME), runtime_error);
+}
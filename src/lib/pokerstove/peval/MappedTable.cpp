@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "MappedTable.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <boost/interprocess/exceptions.hpp>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+using namespace pokerstove;
+namespace bip = boost::interprocess;
+
+MappedTable::MappedTable (const Format& format, const string& filename,
+                          size_t headerSize)
+    : _format(format)
+    , _filename(filename)
+    , _headerSize(headerSize)
+    , _file()
+    , _region()
+{
+    try
+    {
+        _file   = bip::file_mapping(filename.c_str(), bip::read_only);
+        _region = bip::mapped_region(_file, bip::read_only);
+    }
+    catch (const bip::interprocess_exception& e)
+    {
+        throw runtime_error(string(format.name) + ", can not map " + filename + ": " + e.what());
+    }
+
+    require (_region.get_size() >= headerSize, "truncated file");
+    const Prefix& prefix = header<Prefix>();
+    require (memcmp (prefix.magic, format.magic, sizeof(prefix.magic)) == 0,
+             string("not ") + format.kind);
+    require (prefix.version == format.version, "unsupported version in");
+    require (prefix.deckSize == STANDARD_DECK_SIZE, "built for another deck");
+}
+
+void MappedTable::require (bool ok, const string& problem) const
+{
+    if (!ok)
+        throw runtime_error(string(_format.name) + ", " + problem + " " + _filename);
+}
+
+const void* MappedTable::data (uint64_t offset, uint64_t size) const
+{
+    require (offset >= _headerSize && offset <= _region.get_size() &&
+             size <= _region.get_size() - offset, "corrupt table");
+    return static_cast<const char*>(_region.get_address()) + offset;
+}
+
+void MappedTable::adviseHugePages () const
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    madvise (_region.get_address(), _region.get_size(), MADV_HUGEPAGE);
+#endif
+}
+
+void MappedTable::setPrefix (const Format& format, Prefix& prefix)
+{
+    memcpy (prefix.magic, format.magic, sizeof(prefix.magic));
+    prefix.version  = format.version;
+    prefix.deckSize = STANDARD_DECK_SIZE;
+}
+
+void MappedTable::writeFile (const Format& format, const string& filename,
+                             const void* header, size_t headerSize, uint64_t dataOffset,
+                             const void* entries, uint64_t size)
+{
+    if (dataOffset < headerSize)
+        throw invalid_argument(string(format.name) + ", data inside the header");
+
+    ofstream out(filename.c_str(), ios::binary);
+    out.write (static_cast<const char*>(header), headerSize);
+    vector<char> pad(dataOffset-headerSize, 0);
+    if (!pad.empty())
+        out.write (&pad[0], pad.size());
+    if (size > 0)
+        out.write (static_cast<const char*>(entries), size);
+    if (!out)
+        throw runtime_error(string(format.name) + ", can not write " + filename);
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_MAPPEDTABLE_H_
+#define PEVAL_MAPPEDTABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "CardSet.h"
+
+namespace pokerstove
+{
+/**
+ * A table file memory mapped read only, the part the precomputed tables
+ * share.  A file is a header which starts with a Prefix, padding, and
+ * the entries from some data offset on, in native byte order.
+ *
+ * The checks throw std::runtime_error, naming the table and the file.
+ */
+class MappedTable
+{
+public:
+    /**
+     * what tells the files of one table apart
+     */
+    struct Format
+    {
+        const char* name;           //!< of the class, for the errors
+        const char* kind;           //!< such as "a rank table", for the errors
+        char        magic[8];
+        uint32_t    version;
+    };
+
+    /**
+     * the start of every header, filled in by write
+     */
+    struct Prefix
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t deckSize;          //!< STANDARD_DECK_SIZE of the build
+    };
+
+    /**
+     * map a file, and check that it holds a header of headerSize bytes
+     * with the magic and version of the format, for this deck
+     */
+    MappedTable (const Format& format, const std::string& filename,
+                 size_t headerSize);
+
+    template <class Header>
+    const Header& header () const
+    {
+        return *static_cast<const Header*>(_region.get_address());
+    }
+
+    /**
+     * throws "<name>, <problem> <filename>" unless ok
+     */
+    void require (bool ok, const std::string& problem) const;
+
+    /**
+     * the size bytes from offset on, throws if they overlap the header
+     * or run past the end of the file
+     */
+    const void* data (uint64_t offset, uint64_t size) const;
+
+    /**
+     * on linux, mark the mapping as a candidate for huge pages.  Only a
+     * hint, kernels which can not back files with them just say no.
+     */
+    void adviseHugePages () const;
+
+    /**
+     * write a header, with its prefix filled in, padding up to
+     * dataOffset, and the entries
+     */
+    template <class Header, class Entry>
+    static void write (const Format& format, const std::string& filename,
+                       Header header, uint64_t dataOffset,
+                       const std::vector<Entry>& entries)
+    {
+        setPrefix (format, header.prefix);
+        writeFile (format, filename, &header, sizeof(header), dataOffset,
+                   entries.empty() ? NULL : &entries[0], entries.size()*sizeof(Entry));
+    }
+
+private:
+    static void setPrefix (const Format& format, Prefix& prefix);
+    static void writeFile (const Format& format, const std::string& filename,
+                           const void* header, size_t headerSize, uint64_t dataOffset,
+                           const void* entries, uint64_t size);
+
+    const Format& _format;
+    std::string   _filename;
+    size_t        _headerSize;
+    boost::interprocess::file_mapping  _file;
+    boost::interprocess::mapped_region _region;
+};
+}
+
+#endif  // PEVAL_MAPPEDTABLE_H_
@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "MappedTable.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const char* FILENAME = "MappedTable.test.bin";
+
+const MappedTable::Format FORMAT = { "TestTable", "a test table", "PSTEST", 2 };
+
+struct Header
+{
+    MappedTable::Prefix prefix;
+    uint64_t numEntries;
+    uint64_t dataOffset;
+};
+
+void writeTable(uint64_t dataOffset)
+{
+    Header header = Header();
+    header.numEntries = 3;
+    header.dataOffset = dataOffset;
+    MappedTable::write(FORMAT, FILENAME, header, dataOffset, vector<uint32_t>(3, 7));
+}
+}
+
+TEST(MappedTable, WriteAndMap) {
+    writeTable(64);
+    {
+        MappedTable table(FORMAT, FILENAME, sizeof(Header));
+        const Header& header = table.header<Header>();
+        EXPECT_EQ(STANDARD_DECK_SIZE, header.prefix.deckSize);
+        EXPECT_EQ(3, header.numEntries);
+        const uint32_t* entries = static_cast<const uint32_t*>(table.data(64, 3*sizeof(uint32_t)));
+        EXPECT_EQ(7, entries[2]);
+
+        // entries in the header or past the end of the file
+        EXPECT_THROW(table.data(8, sizeof(uint32_t)), runtime_error);
+        EXPECT_THROW(table.data(64, 4*sizeof(uint32_t)), runtime_error);
+        EXPECT_THROW(table.require(false, "corrupt table"), runtime_error);
+    }
+    remove(FILENAME);
+}
+
+TEST(MappedTable, ChecksThePrefix) {
+    writeTable(sizeof(Header));
+    MappedTable::Format other = FORMAT;
+    other.version = 3;
+    EXPECT_THROW(MappedTable(other, FILENAME, sizeof(Header)), runtime_error);
+    other = FORMAT;
+    other.magic[0] = 'X';
+    EXPECT_THROW(MappedTable(other, FILENAME, sizeof(Header)), runtime_error);
+
+    // a header larger than the file
+    EXPECT_THROW(MappedTable(FORMAT, FILENAME, 4096), runtime_error);
+    EXPECT_NO_THROW(MappedTable(FORMAT, FILENAME, sizeof(Header)));
+    remove(FILENAME);
+}
@@ -6,8 +6,10 @@
 #define PEVAL_OMAHAEIGHTHANDEVALUATOR_H_
 
 #include <boost/math/special_functions/binomial.hpp>
+#include "OmahaHighEngine.h"
 #include "PokerEvaluationTables.h"
 #include "Holdem.h"
+#include "LowballTable.h"
 #include "PokerHandEvaluator.h"
 
 inline int bottomRanks(int x, int n)
@@ -46,6 +48,10 @@ namespace pokerstove
 class OmahaEightHandEvaluator : public PokerHandEvaluator
 {
 public:
+    OmahaEightHandEvaluator()
+        : PokerHandEvaluator()
+        , _lowball(&LowballTable::shared())
+    {}
 
     static const int NUM_OMAHA_POCKET = 4;
     static const int NUM_OMAHA_FLOP = 3;
@@ -68,23 +74,14 @@ public:
     {
         PokerEvaluation eval[2];
 
-        // generate the possible sub hands, player hand candidates are all
-        // 4c2 combinations of hands cards,
-        // board candidates are all Nc3 board candidates, where N is the size
-        // of the board
-        double combos = boost::math::binomial_coefficient<double>(board.size(),3);
-        std::vector<CardSet> board_candidates(static_cast<size_t>(combos));
+        // the high half, the best of the 4c2 pocket pairs with the Nc3
+        // board triples, where N is the size of the board
+        eval[0] = _engine.evaluate(hand, board);
+
+        // player hand candidates for the low are all 4c2 combinations of
+        // hands cards
         std::vector<CardSet> hand_candidates(6);
         fillHands(hand_candidates, hand);
-        fillBoards(board_candidates, board);
-
-        for (size_t i=0; i<hand_candidates.size(); i++)
-            for (size_t j=0; j<board_candidates.size(); j++)
-            {
-                PokerEvaluation e = CardSet(hand_candidates[i] | board_candidates[j]).evaluateHigh();
-                if (e > eval[0])
-                    eval[0] = e;
-            }
 
         // evaluate the low using brec's technique, see:
         // http://groups.google.com/group/rec.gambling.poker/msg/e8a3a7698d51f04a?dmode=source
@@ -119,8 +116,8 @@ public:
                 int hmask = flipAce(hand_candidates[i].rankMask() & 0x107F);
                 if (nRanksTable[hmask] < 2)
                     continue;
-                CardSet lowRanks(unflipAce(bottomRanks(bottomRanks(bmask & (~hmask), 3) | hmask, 5)));
-                PokerEvaluation e = lowRanks.evaluate8LowA5();
+                int lowRanks = unflipAce(bottomRanks(bottomRanks(bmask & (~hmask), 3) | hmask, 5));
+                PokerEvaluation e = _lowball->evaluate8LowA5(lowRanks);
                 if (e > eval[1])
                 {
                     eval[1] = e;
@@ -141,8 +138,8 @@ public:
         int hmask = flipAce(twocard.rankMask() & 0x107F);
         if (nRanksTable[hmask] < 2)
             return PokerEvaluation();
-        CardSet lowRanks(unflipAce(bottomRanks(bottomRanks(bmask & (~hmask), 3) | hmask, 5)));
-        return lowRanks.evaluate8LowA5();
+        int lowRanks = unflipAce(bottomRanks(bottomRanks(bmask & (~hmask), 3) | hmask, 5));
+        return _lowball->evaluate8LowA5(lowRanks);
     }
 
     PokerEvaluation evaluateLow(const CardSet& hand, const CardSet& board) const
@@ -158,8 +155,8 @@ public:
                 int hmask = flipAce(hand_candidates[i].rankMask() & 0x107F);
                 if (nRanksTable[hmask] < 2)
                     continue;
-                CardSet lowRanks(unflipAce(bottomRanks(bottomRanks(bmask & (~hmask), 3) | hmask, 5)));
-                PokerEvaluation e = lowRanks.evaluate8LowA5();
+                int lowRanks = unflipAce(bottomRanks(bottomRanks(bmask & (~hmask), 3) | hmask, 5));
+                PokerEvaluation e = _lowball->evaluate8LowA5(lowRanks);
                 if (e > eval)
                 {
                     eval = e;
@@ -209,6 +206,22 @@ public:
     virtual size_t handSize() const { return NUM_OMAHA_POCKET; }
     virtual size_t boardSize() const { return BOARD_SIZE; }
     virtual size_t evaluationSize() const { return 2; }
+
+    virtual void setOmahaTable(boost::shared_ptr<const OmahaTable> table)
+    {
+        _engine.setTable(table);
+    }
+
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        _lowballTable = table;
+        _lowball = (table ? table.get() : &LowballTable::shared());
+    }
+
+private:
+    OmahaHighEngine _engine;
+    const LowballTable* _lowball;
+    boost::shared_ptr<const LowballTable> _lowballTable;
 };
 
 }
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "OmahaHighEngine.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <pokerstove/util/lastbit.h>
+#include "OmahaTable.h"
+#include "PokerEvaluationTables.h"
+#include "RankHashEvaluator.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+// the subsets of up to five card positions, in colex order, so that the
+// first C(n,k) of them are the subsets of the first n positions
+const uint8_t PAIRS[6][2] =
+{
+    {0,1}, {0,2}, {1,2}, {0,3}, {1,3}, {2,3}
+};
+const uint8_t TRIPLES[10][3] =
+{
+    {0,1,2}, {0,1,3}, {0,2,3}, {1,2,3}, {0,1,4},
+    {0,2,4}, {1,2,4}, {0,3,4}, {1,3,4}, {2,3,4}
+};
+const size_t NUM_PAIRS[6]   = { 0, 0, 1, 3,  6, 10 };
+const size_t NUM_TRIPLES[6] = { 0, 0, 0, 1,  4, 10 };
+
+const uint64_t SUIT_MASK = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+
+inline int suitMask (uint64_t mask, size_t suit)
+{
+    return static_cast<int>((mask >> suit*Rank::NUM_RANK) & SUIT_MASK);
+}
+
+// the ranks of the n cards of a mask, lowest code first
+inline void ranksOf (uint64_t mask, size_t n, uint8_t* ranks)
+{
+    for (size_t i=0; i<n; i++, mask &= mask-1)
+        ranks[i] = static_cast<uint8_t>(lastbit64 (mask) % Rank::NUM_RANK);
+}
+
+// the rank keys and lookups of the rank hash
+struct HashLookup
+{
+    const RankHashEvaluator& hash;
+
+    uint32_t pair (int r0, int r1) const
+    {
+        return hash.rankKey (r0) + hash.rankKey (r1);
+    }
+    uint32_t triple (int r0, int r1, int r2) const
+    {
+        return hash.rankKey (r0) + hash.rankKey (r1) + hash.rankKey (r2);
+    }
+    PokerEvaluation ranks (uint32_t pair, uint32_t triple) const
+    {
+        return hash.evaluateRanks (pair + triple);
+    }
+    PokerEvaluation flush (int ranks) const
+    {
+        return hash.evaluateFlush (ranks);
+    }
+};
+
+// the same, with the rank and flush parts of an omaha table
+struct TableLookup
+{
+    const OmahaTable& table;
+
+    uint32_t pair (int r0, int r1) const
+    {
+        return static_cast<uint32_t>(OmahaTable::pairIndex (r0, r1)*OmahaTable::NUM_TRIPLES);
+    }
+    uint32_t triple (int r0, int r1, int r2) const
+    {
+        return static_cast<uint32_t>(OmahaTable::tripleIndex (r0, r1, r2));
+    }
+    PokerEvaluation ranks (uint32_t pair, uint32_t triple) const
+    {
+        return table.evaluateRanks (pair + triple);
+    }
+    PokerEvaluation flush (int ranks) const
+    {
+        return table.evaluateFlush (ranks);
+    }
+};
+
+template <class Lookup>
+PokerEvaluation evaluateWith (const Lookup& lookup, uint64_t pmask, size_t np,
+                              uint64_t bmask, size_t nb)
+{
+    // all sub hands, by their ranks
+    PokerEvaluation best;
+    uint8_t pranks[OmahaHighEngine::MAX_POCKET];
+    uint8_t branks[OmahaHighEngine::MAX_BOARD];
+    ranksOf (pmask, np, pranks);
+    ranksOf (bmask, nb, branks);
+
+    uint32_t pairs[6];
+    for (size_t i=0; i<NUM_PAIRS[np]; i++)
+        pairs[i] = lookup.pair (pranks[PAIRS[i][0]], pranks[PAIRS[i][1]]);
+    for (size_t j=0; j<NUM_TRIPLES[nb]; j++)
+    {
+        const uint32_t triple = lookup.triple (branks[TRIPLES[j][0]],
+                                               branks[TRIPLES[j][1]],
+                                               branks[TRIPLES[j][2]]);
+        for (size_t i=0; i<NUM_PAIRS[np]; i++)
+            best = max(best, lookup.ranks (pairs[i], triple));
+    }
+
+    // the flushes, five distinct ranks of one suit always beat the ranks
+    // on their own
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+    {
+        const int bsuit = suitMask (bmask, s);
+        const int psuit = suitMask (pmask, s);
+        if (nRanksTable[bsuit] < 3 || nRanksTable[psuit] < 2)
+            continue;
+
+        const size_t fp = nRanksTable[psuit];
+        const size_t fb = nRanksTable[bsuit];
+        ranksOf (psuit, fp, pranks);
+        ranksOf (bsuit, fb, branks);
+        for (size_t i=0; i<NUM_PAIRS[fp]; i++)
+            pairs[i] = (1 << pranks[PAIRS[i][0]]) | (1 << pranks[PAIRS[i][1]]);
+        for (size_t j=0; j<NUM_TRIPLES[fb]; j++)
+        {
+            const int triple = (1 << branks[TRIPLES[j][0]]) |
+                               (1 << branks[TRIPLES[j][1]]) |
+                               (1 << branks[TRIPLES[j][2]]);
+            for (size_t i=0; i<NUM_PAIRS[fp]; i++)
+                best = max(best, lookup.flush (pairs[i] | triple));
+        }
+    }
+    return best;
+}
+}
+
+OmahaHighEngine::OmahaHighEngine ()
+    : _hash(RankHashEvaluator::shared())
+    , _table()
+{}
+
+OmahaHighEngine::OmahaHighEngine (boost::shared_ptr<const OmahaTable> table)
+    : _hash(RankHashEvaluator::shared())
+    , _table(table)
+{}
+
+void OmahaHighEngine::setTable (boost::shared_ptr<const OmahaTable> table)
+{
+    _table = table;
+}
+
+PokerEvaluation OmahaHighEngine::evaluate (const CardSet& pocket, const CardSet& board) const
+{
+    const size_t np = pocket.size();
+    const size_t nb = board.size();
+    if (np > MAX_POCKET || nb > MAX_BOARD)
+        throw invalid_argument("OmahaHighEngine, too many cards: " + pocket.str() + " " + board.str());
+    if (np < 2 || nb < MIN_BOARD)
+        return PokerEvaluation();
+
+    if (_table)
+    {
+        TableLookup lookup = { *_table };
+        return evaluateWith (lookup, pocket.mask(), np, board.mask(), nb);
+    }
+    HashLookup lookup = { _hash };
+    return evaluateWith (lookup, pocket.mask(), np, board.mask(), nb);
+}
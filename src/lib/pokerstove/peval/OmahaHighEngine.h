@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_OMAHAHIGHENGINE_H_
+#define PEVAL_OMAHAHIGHENGINE_H_
+
+#include <boost/shared_ptr.hpp>
+#include "CardSet.h"
+#include "PokerEvaluation.h"
+
+namespace pokerstove
+{
+class OmahaTable;
+class RankHashEvaluator;
+
+/**
+ * The omaha high evaluation, the best five card hand made of exactly two
+ * cards of the pocket and three of the board, without allocating.
+ *
+ * The cards go into arrays on the stack, and the sub hands are picked
+ * from a fixed table of index subsets, one for the pairs of the pocket and
+ * one for the triples of a board of three to five cards.  The ranks of
+ * each sub hand are evaluated with the rank hash of RankHashEvaluator: a
+ * sum of per rank keys and one lookup.  Flushes are only tried for a suit
+ * which has three or more cards on the board and two or more in the
+ * pocket, using the ranks of that suit alone.
+ *
+ * Given an OmahaTable, the ranks and flushes are looked up there in place
+ * of the rank hash: a pair index and a triple index into a table which
+ * stays in the first level cache.
+ *
+ * The result is the same as the best CardSet::evaluateHigh over all of
+ * the sub hands.
+ */
+class OmahaHighEngine
+{
+public:
+    static const size_t MAX_POCKET = 4;
+    static const size_t MIN_BOARD  = 3;
+    static const size_t MAX_BOARD  = 5;
+
+    /**
+     * uses RankHashEvaluator::shared(), and the table if one is given
+     */
+    OmahaHighEngine ();
+    explicit OmahaHighEngine (boost::shared_ptr<const OmahaTable> table);
+
+    /**
+     * look up the sub hands in the table, or in the rank hash if it is
+     * null
+     */
+    void setTable (boost::shared_ptr<const OmahaTable> table);
+
+    /**
+     * The best high hand of two pocket and three board cards.  Boards of
+     * fewer than MIN_BOARD cards, and pockets of fewer than two, make no
+     * hand and give a zero evaluation.  Throws std::invalid_argument if
+     * the pocket has more than MAX_POCKET cards or the board more than
+     * MAX_BOARD.
+     */
+    PokerEvaluation evaluate (const CardSet& pocket, const CardSet& board) const;
+
+private:
+    const RankHashEvaluator& _hash;
+    boost::shared_ptr<const OmahaTable> _table;
+};
+}
+
+#endif  // PEVAL_OMAHAHIGHENGINE_H_
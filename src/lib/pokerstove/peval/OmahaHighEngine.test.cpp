@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <pokerstove/util/combinations.h>
+#include "Card.h"
+#include "OmahaHighEngine.h"
+#include "OmahaHighHandEvaluator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+// the best evaluateHigh over every two pocket and three board cards
+PokerEvaluation bruteForce(const CardSet& pocket, const CardSet& board)
+{
+    vector<CardSet> p = pocket.cardSets();
+    vector<CardSet> b = board.cardSets();
+    PokerEvaluation best;
+    if (p.size() < 2 || b.size() < 3)
+        return best;
+    combinations pairs(p.size(), 2);
+    do
+    {
+        combinations triples(b.size(), 3);
+        do
+        {
+            CardSet hand;
+            for (size_t i=0; i<p.size(); i++)
+                if (pairs.getMask() & (1 << i))
+                    hand |= p[i];
+            for (size_t i=0; i<b.size(); i++)
+                if (triples.getMask() & (1 << i))
+                    hand |= b[i];
+            best = max(best, hand.evaluateHigh());
+        }
+        while (triples.next());
+    }
+    while (pairs.next());
+    return best;
+}
+
+// the next n cards of a shuffled deck
+CardSet deal(const vector<int>& deck, size_t& next, size_t n)
+{
+    CardSet cards;
+    for (size_t i=0; i<n; i++)
+        cards.insert(Card(deck[next++]));
+    return cards;
+}
+}
+
+TEST(OmahaHighEngine, MatchesBruteForce) {
+    OmahaHighEngine engine;
+    mt19937 rng(17);
+    size_t mismatches = 0;
+    for (size_t t=0; t<60000; t++)
+    {
+        // every third deal uses only two suits, so that there are plenty
+        // of flushes
+        size_t deckSize = (t%3 == 0 ? 2*Rank::NUM_RANK : STANDARD_DECK_SIZE);
+        vector<int> deck(deckSize);
+        for (size_t i=0; i<deckSize; i++)
+            deck[i] = static_cast<int>(i);
+        shuffle(deck.begin(), deck.end(), rng);
+        size_t next = 0;
+        CardSet pocket = deal(deck, next, 2 + t%3);
+        CardSet board  = deal(deck, next, 3 + (t/3)%3);
+        if (engine.evaluate(pocket, board) != bruteForce(pocket, board))
+            mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST(OmahaHighEngine, Sizes) {
+    OmahaHighEngine engine;
+    EXPECT_EQ(PokerEvaluation(), engine.evaluate(CardSet("AcKcQcJc"), CardSet("TcJd")));
+    EXPECT_EQ(PokerEvaluation(), engine.evaluate(CardSet("Ac"), CardSet("TcJdQh")));
+    EXPECT_THROW(engine.evaluate(CardSet("AcKcQcJcTc"), CardSet("9c8c7h")), invalid_argument);
+    EXPECT_THROW(engine.evaluate(CardSet("AcKc"), CardSet("9c8c7h6h6s6c")), invalid_argument);
+
+    // a four flush on the board does not count with only one suited card
+    PokerEvaluation e = engine.evaluate(CardSet("AcAdKsQs"), CardSet("6c7c8c9cTh"));
+    EXPECT_EQ(bruteForce(CardSet("AcAdKsQs"), CardSet("6c7c8c9cTh")), e);
+    EXPECT_NE(FLUSH, e.type());
+}
+
+TEST(OmahaHighEngine, HandEvaluatorUsesEngine) {
+    OmahaHighHandEvaluator eval;
+    CardSet pocket("AhKhQd9s");
+    CardSet board("JhTh6h7c8c");
+    EXPECT_EQ(bruteForce(pocket, board), eval.evaluateHand(pocket, board).high());
+}
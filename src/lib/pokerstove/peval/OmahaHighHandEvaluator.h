@@ -6,6 +6,7 @@
 #define PEVAL_OMAHAHIGHHANDEVALUATOR_H_
 
 #include <boost/math/special_functions/binomial.hpp>
+#include "OmahaHighEngine.h"
 #include "PokerEvaluationTables.h"
 #include "PokerHandEvaluator.h"
 #include "Holdem.h"
@@ -13,7 +14,8 @@
 namespace pokerstove
 {
 /**
- * A specialized hand evaluator for omaha.  Not as slow.
+ * A specialized hand evaluator for omaha.  Not as slow.  evaluateHand
+ * goes through an OmahaHighEngine, which does not allocate.
  */
 class OmahaHighHandEvaluator : public PokerHandEvaluator
 {
@@ -27,27 +29,7 @@ public:
 
     virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet& board) const
     {
-        PokerEvaluation eval[2];
-
-        // generate the possible sub hands, player hand candidates are all
-        // 4c2 combinations of hands cards,
-        // board candidates are all Nc3 board candidates, where N is the size
-        // of the board
-        double combos = boost::math::binomial_coefficient<double>(board.size(),3);
-        std::vector<CardSet> board_candidates(static_cast<size_t>(combos));
-        std::vector<CardSet> hand_candidates(6);
-        fillHands(hand_candidates, hand);
-        fillBoards(board_candidates, board);
-
-        for (size_t i=0; i<hand_candidates.size(); i++)
-            for (size_t j=0; j<board_candidates.size(); j++)
-            {
-                PokerEvaluation e = CardSet(hand_candidates[i] | board_candidates[j]).evaluateHigh();
-                if (e > eval[0])
-                    eval[0] = e;
-            }
-
-        return PokerHandEvaluation(eval[0]);
+        return PokerHandEvaluation(_engine.evaluate(hand, board));
     }
 
     virtual PokerEvaluation evaluateRanks(const CardSet& hand, const CardSet& board) const
@@ -140,6 +122,14 @@ public:
     virtual size_t handSize() const { return NUM_OMAHA_POCKET; }
     virtual size_t boardSize() const { return BOARD_SIZE; }
     virtual size_t evaluationSize() const { return 1; }
+
+    virtual void setOmahaTable(boost::shared_ptr<const OmahaTable> table)
+    {
+        _engine.setTable(table);
+    }
+
+private:
+    OmahaHighEngine _engine;
 };
 
 }
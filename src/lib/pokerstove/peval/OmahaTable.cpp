@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "OmahaTable.h"
+
+#include "Card.h"
+#include "Suit.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const MappedTable::Format FORMAT =
+    { "OmahaTable", "an omaha table", "PSOMAHA", OmahaTable::VERSION };
+
+// a hand with the ranks, dealt round the suits so that it can not make a
+// flush, or an empty set if a rank comes up more than four times
+CardSet rankHand (const size_t* ranks, size_t n)
+{
+    CardSet hand;
+    for (size_t i=0; i<n; i++)
+        for (size_t s=0; s<=Suit::NUM_SUIT; s++)
+        {
+            if (s == Suit::NUM_SUIT)
+                return CardSet();
+            Card card(Rank(static_cast<uint8_t>(ranks[i])),
+                      Suit(static_cast<uint8_t>((i+s) % Suit::NUM_SUIT)));
+            if (!hand.contains (card))
+            {
+                hand.insert (card);
+                break;
+            }
+        }
+    return hand;
+}
+}
+
+const size_t OmahaTable::NUM_PAIRS;
+const size_t OmahaTable::NUM_TRIPLES;
+const size_t OmahaTable::NUM_FLUSHES;
+
+OmahaTable::OmahaTable (const string& filename)
+    : _table(FORMAT, filename, sizeof(Header))
+    , _entries(NULL)
+{
+    const Header& header = _table.header<Header>();
+    _table.require (header.numPairs == NUM_PAIRS &&
+                    header.numTriples == NUM_TRIPLES &&
+                    header.numFlushes == NUM_FLUSHES, "built for another deck");
+    _entries = static_cast<const int32_t*>(
+        _table.data (header.dataOffset, NUM_ENTRIES*sizeof(int32_t)));
+}
+
+vector<int32_t> OmahaTable::build ()
+{
+    vector<int32_t> entries(NUM_ENTRIES, 0);
+
+    // each multiset of pocket ranks, with each multiset of board ranks
+    for (size_t p0=0; p0<Rank::NUM_RANK; p0++)
+    for (size_t p1=p0; p1<Rank::NUM_RANK; p1++)
+    for (size_t b0=0; b0<Rank::NUM_RANK; b0++)
+    for (size_t b1=b0; b1<Rank::NUM_RANK; b1++)
+    for (size_t b2=b1; b2<Rank::NUM_RANK; b2++)
+    {
+        const size_t ranks[5] = { p0, p1, b0, b1, b2 };
+        CardSet hand = rankHand (ranks, 5);
+        if (hand.size() != 5)
+            continue;
+        const size_t pair   = pairIndex (static_cast<int>(p0), static_cast<int>(p1));
+        const size_t triple = tripleIndex (static_cast<int>(b0), static_cast<int>(b1),
+                                           static_cast<int>(b2));
+        entries[pair*NUM_TRIPLES + triple] = hand.evaluateHigh().code();
+    }
+
+    for (size_t m=0; m<NUM_FLUSHES; m++)
+    {
+        CardSet suited(m);
+        if (suited.size() == 5)
+            entries[NUM_PAIRS*NUM_TRIPLES + m] = suited.evaluateHigh().code();
+    }
+    return entries;
+}
+
+void OmahaTable::write (const string& filename)
+{
+    vector<int32_t> entries = build ();
+
+    Header header = Header();
+    header.numPairs   = NUM_PAIRS;
+    header.numTriples = NUM_TRIPLES;
+    header.numFlushes = NUM_FLUSHES;
+    header.dataOffset = DATA_OFFSET;
+    MappedTable::write (FORMAT, filename, header, DATA_OFFSET, entries);
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_OMAHATABLE_H_
+#define PEVAL_OMAHATABLE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CardSet.h"
+#include "MappedTable.h"
+#include "PokerEvaluation.h"
+#include "Rank.h"
+
+namespace pokerstove
+{
+/**
+ * The five card high evaluations of omaha, two pocket cards and three
+ * board cards, split into ranks and flushes and memory mapped from a file
+ * built by ps-lut:
+ * - ranks:    the evaluation, ignoring flushes, of each pair of pocket
+ *             ranks with each triple of board ranks, at
+ *             pairIndex*NUM_TRIPLES + tripleIndex
+ * - flushes:  the flush or straight flush of each mask of five ranks of
+ *             one suit, zero for other masks
+ *
+ * The pairs and triples are multisets of ranks, indexed in colex order,
+ * so the rank part is 45 by 165 entries and both parts fit in the first
+ * level cache.  The codes are the same as those of CardSet::evaluateHigh.
+ *
+ * File layout: a Header, padding up to dataOffset, then the rank entries
+ * and the flush entries, as int32 in native byte order.
+ */
+class OmahaTable
+{
+public:
+    static const uint32_t VERSION     = 1;
+    static const size_t   NUM_PAIRS   = Rank::NUM_RANK*(Rank::NUM_RANK+1)/2;
+    static const size_t   NUM_TRIPLES = Rank::NUM_RANK*(Rank::NUM_RANK+1)*(Rank::NUM_RANK+2)/6;
+    static const size_t   NUM_FLUSHES = 1 << Rank::NUM_RANK;
+    static const size_t   NUM_ENTRIES = NUM_PAIRS*NUM_TRIPLES + NUM_FLUSHES;
+    static const uint64_t DATA_OFFSET = 4096;
+
+    struct Header
+    {
+        MappedTable::Prefix prefix; //!< "PSOMAHA", VERSION
+        uint32_t numPairs;          //!< NUM_PAIRS
+        uint32_t numTriples;        //!< NUM_TRIPLES
+        uint32_t numFlushes;        //!< NUM_FLUSHES
+        uint32_t reserved;
+        uint64_t dataOffset;        //!< where the entries start
+    };
+
+    /**
+     * map a table file, throws std::runtime_error if it can not be read or
+     * was not built for this deck and version
+     */
+    explicit OmahaTable (const std::string& filename);
+
+    /**
+     * the index of a pair of ranks, in either order
+     */
+    static size_t pairIndex (int r0, int r1)
+    {
+        const int lo = std::min(r0, r1);
+        const int hi = std::max(r0, r1);
+        return hi*(hi+1)/2 + lo;
+    }
+
+    /**
+     * the index of a triple of ranks, in any order
+     */
+    static size_t tripleIndex (int r0, int r1, int r2)
+    {
+        const int lo  = std::min(r0, std::min(r1, r2));
+        const int hi  = std::max(r0, std::max(r1, r2));
+        const int mid = r0 + r1 + r2 - lo - hi;
+        return hi*(hi+1)*(hi+2)/6 + mid*(mid+1)/2 + lo;
+    }
+
+    /**
+     * the evaluation of the ranks at pairIndex*NUM_TRIPLES + tripleIndex,
+     * ignoring flushes
+     */
+    PokerEvaluation evaluateRanks (size_t index) const
+    {
+        return PokerEvaluation(_entries[index]);
+    }
+
+    /**
+     * the flush made by five ranks of one suit, zero for other masks
+     */
+    PokerEvaluation evaluateFlush (int ranks) const
+    {
+        return PokerEvaluation(_entries[NUM_PAIRS*NUM_TRIPLES + ranks]);
+    }
+
+    /**
+     * build the entries, NUM_ENTRIES of them
+     */
+    static std::vector<int32_t> build ();
+
+    /**
+     * build the table and write it to a file
+     */
+    static void write (const std::string& filename);
+
+private:
+    MappedTable    _table;
+    const int32_t* _entries;
+};
+}
+
+#endif  // PEVAL_OMAHATABLE_H_
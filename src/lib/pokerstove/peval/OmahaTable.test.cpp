@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <boost/shared_ptr.hpp>
+#include "Card.h"
+#include "OmahaHighEngine.h"
+#include "OmahaTable.h"
+#include "PokerHandEvaluator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const char* FILENAME = "OmahaTable.test.bin";
+
+class OmahaTableTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        OmahaTable::write(FILENAME);
+        table.reset(new OmahaTable(FILENAME));
+    }
+
+    static void TearDownTestCase()
+    {
+        table.reset();
+        remove(FILENAME);
+    }
+
+    static boost::shared_ptr<const OmahaTable> table;
+};
+
+boost::shared_ptr<const OmahaTable> OmahaTableTest::table;
+}
+
+TEST(OmahaTable, Indices) {
+    EXPECT_EQ(45, OmahaTable::NUM_PAIRS);
+    EXPECT_EQ(165, OmahaTable::NUM_TRIPLES);
+    EXPECT_EQ(0, OmahaTable::pairIndex(0, 0));
+    EXPECT_EQ(OmahaTable::NUM_PAIRS-1, OmahaTable::pairIndex(8, 8));
+    EXPECT_EQ(OmahaTable::pairIndex(2, 7), OmahaTable::pairIndex(7, 2));
+    EXPECT_EQ(OmahaTable::NUM_TRIPLES-1, OmahaTable::tripleIndex(8, 8, 8));
+    EXPECT_EQ(OmahaTable::tripleIndex(1, 5, 3), OmahaTable::tripleIndex(5, 3, 1));
+
+    // the colex order makes each multiset its own index
+    vector<bool> seen(OmahaTable::NUM_TRIPLES, false);
+    for (int a=0; a<Rank::NUM_RANK; a++)
+        for (int b=a; b<Rank::NUM_RANK; b++)
+            for (int c=b; c<Rank::NUM_RANK; c++)
+            {
+                size_t i = OmahaTable::tripleIndex(a, b, c);
+                ASSERT_LT(i, OmahaTable::NUM_TRIPLES);
+                EXPECT_FALSE(seen[i]);
+                seen[i] = true;
+            }
+}
+
+TEST_F(OmahaTableTest, MatchesRankHash) {
+    OmahaHighEngine hash;
+    OmahaHighEngine lookup(table);
+    mt19937 rng(23);
+    size_t mismatches = 0;
+    for (size_t t=0; t<60000; t++)
+    {
+        size_t deckSize = (t%3 == 0 ? 2*Rank::NUM_RANK : STANDARD_DECK_SIZE);
+        vector<int> deck(deckSize);
+        for (size_t i=0; i<deckSize; i++)
+            deck[i] = static_cast<int>(i);
+        shuffle(deck.begin(), deck.end(), rng);
+        CardSet pocket, board;
+        for (size_t i=0; i<4; i++)
+            pocket.insert(Card(deck[i]));
+        for (size_t i=0; i<3+t%3; i++)
+            board.insert(Card(deck[4+i]));
+        if (hash.evaluate(pocket, board) != lookup.evaluate(pocket, board))
+            mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST_F(OmahaTableTest, SelectedPerEvaluator) {
+    CardSet pocket("AhKhQd9s");
+    CardSet board("JhTh6h7c8c");
+    for (const char* game : { "O", "o" })
+    {
+        boost::shared_ptr<PokerHandEvaluator> plain = PokerHandEvaluator::alloc(game);
+        boost::shared_ptr<PokerHandEvaluator> lookup = PokerHandEvaluator::alloc(game);
+        lookup->setOmahaTable(table);
+        EXPECT_EQ(plain->evaluateHand(pocket, board).str(),
+                  lookup->evaluateHand(pocket, board).str()) << game;
+    }
+    EXPECT_THROW(PokerHandEvaluator::alloc("h")->setOmahaTable(table), runtime_error);
+}
+
+TEST(OmahaTable, RejectsOtherFiles) {
+    FILE* f = fopen(FILENAME, "wb");
+    fputs("not an omaha table", f);
+    fclose(f);
+    EXPECT_THROW(OmahaTable table(FILENAME), runtime_error);
+    remove(FILENAME);
+    EXPECT_THROW(OmahaTable table(FILENAME), runtime_error);
+}
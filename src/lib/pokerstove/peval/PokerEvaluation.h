@@ -45,8 +45,9 @@ const int ACE_LOW_BIT = 0x01<<Rank::NUM_RANK;
 class PokerEvaluation
 {
 public:
-    PokerEvaluation();
-    explicit PokerEvaluation(int ecode);  //!< for codes saved for later use, like in a file
+    PokerEvaluation() : _evalcode(0) {}
+    explicit PokerEvaluation(int ecode)   //!< for codes saved for later use, like in a file
+        : _evalcode(ecode) {}
 
 #if 0
     PokerEvaluation(int type,             //!< Manually create high hand evaluation
@@ -57,7 +58,7 @@ public:
 
     std::string str() const;     //!< semantic meaning of the evaluation
     std::string bitstr() const;  //!< bit string of the evaluation code. debugging.
-    int code() const;            //!< the bit representation
+    int code() const { return _evalcode; }  //!< the bit representation
 
     /**
      * This is a showdown code, useful for comparing to other hands instead
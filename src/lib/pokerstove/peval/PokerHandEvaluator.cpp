@@ -42,6 +42,15 @@ void PokerHandEvaluator::evaluateShowdown(const vector<CardSet>& hands,
         vector<PokerHandEvaluation>& evals,
         vector<EquityResult>& result,
         double weight) const
+{
+    evaluateShowdown(hands, board, evals, &result[0], weight);
+}
+
+void PokerHandEvaluator::evaluateShowdown(const vector<CardSet>& hands,
+        const CardSet& board,
+        vector<PokerHandEvaluation>& evals,
+        EquityResult* result,
+        double weight) const
 {
     // this is a special trick we use.  the hands vector could actually
     // contain hands [0..n],board because of the way we step through the
@@ -49,19 +58,28 @@ void PokerHandEvaluator::evaluateShowdown(const vector<CardSet>& hands,
     // the number of hands, board or not.  So we use the size of the evals
     // here, not the size of the hand vector
     size_t hsize = evals.size();
-    size_t nevals = 1;
 
     // gather all the evaluations
     for (size_t i=0; i<hsize; i++)
-    {
-        // we track whether or not an eval is used in the nevals
-        // variable to avoid looping through the low half of split
-        // pot games when no one has a low.  This only covers games
-        // which have one or two pots.
         evals[i] = evaluateHand(hands[i], board);
-        if (nevals == 1 && evals[i].eval(1) > PokerEvaluation(0))
+
+    awardShares(&evals[0], hsize, result, weight);
+    // display (hands, board, result);
+}
+
+void PokerHandEvaluator::awardShares(const PokerHandEvaluation* evals,
+        size_t hsize,
+        EquityResult* result,
+        double weight)
+{
+    // we track whether or not an eval is used in the nevals
+    // variable to avoid looping through the low half of split
+    // pot games when no one has a low.  This only covers games
+    // which have one or two pots.
+    size_t nevals = 1;
+    for (size_t i=0; i<hsize && nevals == 1; i++)
+        if (evals[i].eval(1) > PokerEvaluation(0))
             nevals = 2;
-    }
 
     // award share(s)
     for (size_t e=0; e<nevals; e++)
@@ -97,6 +115,4 @@ void PokerHandEvaluator::evaluateShowdown(const vector<CardSet>& hands,
                     result[i].tieShares += INV_LUT[shares*nevals]*weight;
         }
     }
-    // display (hands, board, result);
 }
-
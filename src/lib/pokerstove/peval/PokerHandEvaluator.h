@@ -16,6 +16,10 @@ const unsigned int BOARD_SIZE = 5;
 
 namespace pokerstove
 {
+class HighStateTable;
+class LowballTable;
+class OmahaTable;
+
 /**
  * What is actually stored in the equity result is up to the evalutor
  * being used.  Usually it is either wins/ties, or m1/m2
@@ -38,6 +42,8 @@ struct EquityResult
     {
         winShares += other.winShares;
         tieShares += other.tieShares;
+        equity    += other.equity;
+        equity2   += other.equity2;
         return *this;
     }
 
@@ -131,6 +137,14 @@ public:
         return _useSuits;
     }
 
+    /**
+     * the id the evaluator was allocated with, see alloc
+     */
+    const std::string& id() const
+    {
+        return _subclassID;
+    }
+
     void useSuits(bool use)
     {
         _useSuits = use;
@@ -144,6 +158,39 @@ public:
         throw std::runtime_error("not implemented");
     }
 
+    /**
+     * evaluate high hands with a state machine table rather than
+     * CardSet::evaluateHigh, the codes are the same.  Only evaluators of
+     * high hands of at most seven cards can do this, a null table goes
+     * back to evaluateHigh.
+     */
+    virtual void setHighStateTable(boost::shared_ptr<const HighStateTable> table)
+    {
+        throw std::runtime_error("not implemented");
+    }
+
+    /**
+     * evaluate the omaha high hands with a table of two card by three
+     * card evaluations built by ps-lut, the codes are the same.  Only the
+     * omaha evaluators can do this, a null table goes back to the rank
+     * hash.
+     */
+    virtual void setOmahaTable(boost::shared_ptr<const OmahaTable> table)
+    {
+        throw std::runtime_error("not implemented");
+    }
+
+    /**
+     * evaluate the lows with a LowballTable mapped from a file written by
+     * ps-lut, rather than the one built in memory on first use, the codes
+     * are the same.  Only evaluators of lowball hands can do this, a null
+     * table goes back to the built one.
+     */
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        throw std::runtime_error("not implemented");
+    }
+
     /**
      * Given a set of showdown hands, return the corresponding number of
      * shares of the pot each hand is rewarded.  The shares are accumulated
@@ -172,6 +219,27 @@ public:
                           std::vector<EquityResult>& result,
                           double weight=1.0) const;
 
+    /**
+     * Same as above, but the shares are accumulated into the raw array
+     * result, which must have room for evals.size() results.  This lets
+     * callers keep their accumulators in storage they lay out themselves.
+     */
+    void evaluateShowdown(const std::vector<CardSet>& hands,
+                          const pokerstove::CardSet& board,
+                          std::vector<PokerHandEvaluation>& evals,
+                          EquityResult* result,
+                          double weight=1.0) const;
+
+    /**
+     * Award the pot shares for the evaluations of hsize hands, this is
+     * the second half of evaluateShowdown, for callers which already have
+     * the evaluations in hand.  Shares are accumulated in result.
+     */
+    static void awardShares(const PokerHandEvaluation* evals,
+                            size_t hsize,
+                            EquityResult* result,
+                            double weight=1.0);
+
 
 protected:
     PokerHandEvaluator();
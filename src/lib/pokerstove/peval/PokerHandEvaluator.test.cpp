@@ -1,5 +1,8 @@
+#include <random>
 #include <gtest/gtest.h>
+#include "Card.h"
 #include "PokerHandEvaluator.h"
+#include "UniversalHandEvaluator.h"
 
 TEST(PokerHandEvaluator, OmahaHigh)
 {
@@ -9,3 +12,54 @@ TEST(PokerHandEvaluator, OmahaHigh)
     EXPECT_EQ(true, evaluator->usesSuits());
     EXPECT_EQ(5, evaluator->boardSize());
 }
+
+TEST(PokerHandEvaluator, SpecializedMatchUniversal)
+{
+    using namespace pokerstove;
+    using namespace std;
+
+    struct Game
+    {
+        const char*  id;
+        size_t       maxCards;
+        evalFunction evalA;
+        evalFunction evalB;
+    };
+    const Game games[] =
+    {
+        { "k", 5, &CardSet::evaluateLow2to7, NULL },
+        { "l", 5, &CardSet::evaluateLowA5,   NULL },
+        { "3", 3, &CardSet::evaluate3CP,     NULL },
+        { "q", 7, &CardSet::evaluateHigh,    &CardSet::evaluateLowA5 },
+        { "T", 5, &CardSet::evaluateLowA5,   NULL },
+    };
+
+    mt19937 rng(20);
+    vector<int> deck(STANDARD_DECK_SIZE);
+    for (size_t i=0; i<deck.size(); i++)
+        deck[i] = static_cast<int>(i);
+    for (const Game& game : games)
+    {
+        boost::shared_ptr<PokerHandEvaluator> evaluator = PokerHandEvaluator::alloc(game.id);
+        UniversalHandEvaluator universal(1, static_cast<int>(game.maxCards), 0, 0, 0,
+                                         game.evalA, game.evalB);
+        EXPECT_EQ(universal.handSize(), evaluator->handSize()) << game.id;
+        EXPECT_EQ(universal.boardSize(), evaluator->boardSize()) << game.id;
+        EXPECT_EQ(universal.evaluationSize(), evaluator->evaluationSize()) << game.id;
+
+        size_t mismatches = 0;
+        for (size_t t=0; t<5000; t++)
+        {
+            shuffle(deck.begin(), deck.end(), rng);
+            CardSet hand;
+            for (size_t i=0; i<1+t%game.maxCards; i++)
+                hand.insert(Card(deck[i]));
+            PokerHandEvaluation expected = universal.evaluateHand(hand, CardSet());
+            PokerHandEvaluation actual = evaluator->evaluateHand(hand, CardSet());
+            for (size_t e=0; e<universal.evaluationSize(); e++)
+                if (expected.eval(e) != actual.eval(e))
+                    mismatches++;
+        }
+        EXPECT_EQ(0, mismatches) << game.id;
+    }
+}
@@ -12,10 +12,9 @@
 #include "DeuceToSevenHandEvaluator.h"
 #include "DrawHighHandEvaluator.h"
 #include "BadugiHandEvaluator.h"
-//#include "LowballA5HandEvaluator.h"
-//#include "ThreeCardPokerHandEvaluator.h"
-
-#include "UniversalHandEvaluator.h"
+#include "LowballA5HandEvaluator.h"
+#include "ThreeCardPokerHandEvaluator.h"
+#include "StudHighLowHandEvaluator.h"
 
 using namespace std;
 using namespace pokerstove;
@@ -32,15 +31,18 @@ boost::shared_ptr<PokerHandEvaluator> PokerHandEvaluator::alloc(const string& st
             break;
 
         case 'k':       //     Kansas City lowball (2-7)
-            ret.reset(new UniversalHandEvaluator(1,5,0,0,0,&CardSet::evaluateLow2to7, NULL));
+            //ret.reset(new UniversalHandEvaluator(1,5,0,0,0,&CardSet::evaluateLow2to7, NULL));
+            ret.reset(new DeuceToSevenHandEvaluator);
             break;
 
         case 'l':       //     lowball (A-5)
-            ret.reset(new UniversalHandEvaluator(1,5,0,0,0,&CardSet::evaluateLowA5, NULL));
+            //ret.reset(new UniversalHandEvaluator(1,5,0,0,0,&CardSet::evaluateLowA5, NULL));
+            ret.reset(new LowballA5HandEvaluator);
             break;
 
         case '3':       //     three card poker
-            ret.reset(new UniversalHandEvaluator(1,3,0,0,0,&CardSet::evaluate3CP, NULL));
+            //ret.reset(new UniversalHandEvaluator(1,3,0,0,0,&CardSet::evaluate3CP, NULL));
+            ret.reset(new ThreeCardPokerHandEvaluator);
             break;
 
         case 'O':       //     omaha high
@@ -50,7 +52,9 @@ boost::shared_ptr<PokerHandEvaluator> PokerHandEvaluator::alloc(const string& st
 
         case 'p':       //     pot limit
         case 'P':
-            if (strid[2] == 'h' || strid[2] == 'H')           // plh/PLH
+            if (strid.size() < 3)
+                throw std::runtime_error("no comatible pot limit game available");
+            else if (strid[2] == 'h' || strid[2] == 'H')      // plh/PLH
                 ret.reset(new HoldemHandEvaluator);
             else if (strid[2] == 'o' || strid[2] == 'O')      // PLO
                 ret.reset(new OmahaHighHandEvaluator);
@@ -73,8 +77,9 @@ boost::shared_ptr<PokerHandEvaluator> PokerHandEvaluator::alloc(const string& st
             break;
 
         case 'q':       //     stud high/low no qualifier
-            ret.reset(new UniversalHandEvaluator(1,7,0,0,0,
-                                                 &CardSet::evaluateHigh, &CardSet::evaluateLowA5));
+            //ret.reset(new UniversalHandEvaluator(1,7,0,0,0,
+            //                                     &CardSet::evaluateHigh, &CardSet::evaluateLowA5));
+            ret.reset(new StudHighLowHandEvaluator);
             break;
 
         case 'd':       //     draw high
@@ -89,7 +94,8 @@ boost::shared_ptr<PokerHandEvaluator> PokerHandEvaluator::alloc(const string& st
             break;
 
         case 'T':       //     triple draw lowball (A-5)
-            ret.reset(new UniversalHandEvaluator(1,5,0,0,0,&CardSet::evaluateLowA5, NULL));
+            //ret.reset(new UniversalHandEvaluator(1,5,0,0,0,&CardSet::evaluateLowA5, NULL));
+            ret.reset(new LowballA5HandEvaluator);
             break;
 
         case 'o':       //     omaha/high low
@@ -107,6 +113,8 @@ boost::shared_ptr<PokerHandEvaluator> PokerHandEvaluator::alloc(const string& st
             ret.reset(new BadugiHandEvaluator);
             break;
 
+        default:
+            throw std::runtime_error("unknown game: " + strid);
     }
 
     ret->_subclassID = strid;
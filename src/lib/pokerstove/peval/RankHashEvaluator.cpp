@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "RankHashEvaluator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "Card.h"
+#include "Rank.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const size_t MAX_COUNT = Suit::NUM_SUIT;    // of one rank
+const size_t MAX_TRIES = 64;                // multipliers to try
+
+// a hand with the rank counts, dealt round the suits so that no suit has
+// more than two cards, and so can not make a flush
+CardSet rankHand (const uint8_t* counts)
+{
+    CardSet hand;
+    size_t suit = 0;
+    for (size_t r=0; r<Rank::NUM_RANK; r++)
+        for (size_t i=0; i<counts[r]; i++, suit++)
+            hand.insert (Card(Rank(static_cast<uint8_t>(r)),
+                              Suit(static_cast<uint8_t>(suit % Suit::NUM_SUIT))));
+    return hand;
+}
+
+// the number of ranks in a base five number of rank counts
+size_t cardCount (uint32_t quinary)
+{
+    size_t n = 0;
+    for (; quinary != 0; quinary /= 5)
+        n += quinary % 5;
+    return n;
+}
+
+uint64_t mix (uint64_t x)
+{
+    x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+}
+}
+
+RankHashEvaluator::RankHashEvaluator ()
+    : _multiplier(0)
+{
+    for (size_t m=0; m<NUM_SUIT_MASKS; m++)
+    {
+        CardSet suited(m);
+        uint32_t quinary = 0;
+        for (size_t r=Rank::NUM_RANK; r-- > 0; )
+            quinary = quinary*5 + ((m >> r) & 0x01);
+        _suits[m].flush = (suited.size() >= 5 ? suited.evaluateHigh().code() : 0);
+        _suits[m].key   = static_cast<uint32_t>(suited.size() << COUNT_SHIFT) | quinary;
+    }
+
+    // walk the rank counts like an odometer, and keep the multisets of up
+    // to MAX_CARDS ranks
+    vector<uint32_t> quinaries;
+    vector<int> codes;
+    uint8_t counts[Rank::NUM_RANK] = {};
+    for (;;)
+    {
+        size_t n = 0;
+        uint32_t quinary = 0;
+        for (size_t r=Rank::NUM_RANK; r-- > 0; )
+        {
+            n += counts[r];
+            quinary = quinary*5 + counts[r];
+        }
+        if (n <= MAX_CARDS)
+        {
+            quinaries.push_back (quinary);
+            codes.push_back (rankHand (counts).evaluateHigh().code());
+        }
+
+        size_t r = 0;
+        while (r < Rank::NUM_RANK && counts[r] == MAX_COUNT)
+            counts[r++] = 0;
+        if (r == Rank::NUM_RANK)
+            break;
+        counts[r]++;
+    }
+
+    bool found = false;
+    for (size_t t=0; t<MAX_TRIES && !found; t++)
+    {
+        _multiplier = static_cast<uint32_t>(mix (t)) | 0x01;
+        found = findDisplacements (quinaries);
+    }
+    if (!found)
+        throw logic_error("RankHashEvaluator, no perfect hash for the rank sets");
+
+    fill (_ranks, _ranks+NUM_SLOTS, 0);
+    for (size_t i=0; i<quinaries.size(); i++)
+        _ranks[slot (quinaries[i])] = codes[i];
+
+    // the same tables again as ordinals, the hands of fewer than five
+    // cards have none
+    const HandOrdinals& ordinals = HandOrdinals::shared (HandOrdinals::HIGH);
+    for (size_t m=0; m<NUM_SUIT_MASKS; m++)
+        _flushOrdinals[m] = (_suits[m].flush != 0 ?
+                             ordinals.ordinal (PokerEvaluation(_suits[m].flush)) : 0);
+    fill (_rankOrdinals, _rankOrdinals+NUM_SLOTS, 0);
+    for (size_t i=0; i<quinaries.size(); i++)
+        if (cardCount (quinaries[i]) >= FULL_HAND_SIZE)
+            _rankOrdinals[slot (quinaries[i])] = ordinals.ordinal (PokerEvaluation(codes[i]));
+}
+
+bool RankHashEvaluator::findDisplacements (const vector<uint32_t>& quinaries)
+{
+    // the primary slots of the keys of each bucket
+    vector<vector<size_t> > buckets(NUM_BUCKETS);
+    for (size_t i=0; i<quinaries.size(); i++)
+    {
+        const uint32_t u = quinaries[i] * _multiplier;
+        const size_t primary = u >> (32-SLOT_BITS);
+        const size_t bucket  = (u >> (32-SLOT_BITS-BUCKET_BITS)) & (NUM_BUCKETS-1);
+        vector<size_t>& b = buckets[bucket];
+        if (find (b.begin(), b.end(), primary) != b.end())
+            return false;
+        b.push_back (primary);
+    }
+
+    // place the largest buckets first, while there is the most room
+    vector<size_t> order(NUM_BUCKETS);
+    for (size_t b=0; b<NUM_BUCKETS; b++)
+        order[b] = b;
+    stable_sort (order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    vector<bool> used(NUM_SLOTS, false);
+    fill (_displacements, _displacements+NUM_BUCKETS+1, 0);
+    for (size_t i=0; i<NUM_BUCKETS && !buckets[order[i]].empty(); i++)
+    {
+        const vector<size_t>& b = buckets[order[i]];
+        size_t d = 0;
+        for (; d<NUM_SLOTS; d++)
+        {
+            size_t k = 0;
+            while (k < b.size() && !used[b[k]^d])
+                k++;
+            if (k == b.size())
+                break;
+        }
+        if (d == NUM_SLOTS)
+            return false;
+        for (size_t k=0; k<b.size(); k++)
+            used[b[k]^d] = true;
+        _displacements[order[i]] = static_cast<uint16_t>(d);
+    }
+    return true;
+}
+
+const RankHashEvaluator& RankHashEvaluator::shared ()
+{
+    static const RankHashEvaluator eval;
+    return eval;
+}
+
+size_t RankHashEvaluator::tableSize ()
+{
+    return sizeof(RankHashEvaluator);
+}
@@ -0,0 +1,201 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_RANKHASHEVALUATOR_H_
+#define PEVAL_RANKHASHEVALUATOR_H_
+
+#include <cstdint>
+#include <vector>
+#include "CardSet.h"
+#include "HandOrdinals.h"
+#include "PokerEvaluation.h"
+#include "Suit.h"
+
+namespace pokerstove
+{
+/**
+ * A high hand evaluator whose tables stay in the first levels of cache.
+ * Where CardSet::evaluateHigh goes through a dozen table lookups and
+ * branches, this one does four lookups of the suit masks, and then at
+ * most two more:
+ * - suits:  for each suit mask, the flush it makes if it has five cards
+ *           or more, and its ranks as a base five number, so that the sum
+ *           over the suits counts the ranks of the hand
+ * - ranks:  the evaluation of each multiset of ranks, at the slot given
+ *           by a perfect hash of its base five number
+ *
+ * The hash displaces a primary slot by a per bucket value, which the
+ * constructor searches for, so that the 10945 multisets of up to seven
+ * ranks land in distinct slots.  All of the tables come to about 80KB, and
+ * the ordinal copies to another 33KB.
+ *
+ * The codes are the same as those of evaluateHigh for hands of up to
+ * MAX_CARDS cards, larger hands are passed on to evaluateHigh.
+ *
+ * evaluateOrdinal gives the HandOrdinals::HIGH ordinal of the hand in
+ * place of the code, from uint16_t copies of the tables.
+ *
+ * evaluateBatch does 8 hands at a time with AVX2, or 16 with AVX-512,
+ * when the cpu has them.  The vector paths count the ranks with register
+ * permutes in place of the suit table, gather from the hash tables, and
+ * leave hands with a flush or too many cards to evaluate.
+ */
+class RankHashEvaluator
+{
+public:
+    static const size_t MAX_CARDS = 7;
+    static const size_t NUM_SUIT_MASKS = 1 << Rank::NUM_RANK;
+    static const size_t SLOT_BITS   = 14;
+    static const size_t BUCKET_BITS = 12;
+
+    enum BatchPath
+    {
+        SCALAR = 0,
+        AVX2   = 1,
+        AVX512 = 2
+    };
+
+    /**
+     * build the tables, which takes a few milliseconds.  Throws
+     * std::logic_error if no perfect hash is found.
+     */
+    RankHashEvaluator ();
+
+    PokerEvaluation evaluate (const CardSet& cards) const
+    {
+        const uint64_t mask = cards.mask();
+        const uint64_t SUIT_MASK = NUM_SUIT_MASKS-1;
+        const SuitEntry& c = _suits[ mask                      & SUIT_MASK];
+        const SuitEntry& d = _suits[(mask >>   Rank::NUM_RANK) & SUIT_MASK];
+        const SuitEntry& h = _suits[(mask >> 2*Rank::NUM_RANK) & SUIT_MASK];
+        const SuitEntry& s = _suits[(mask >> 3*Rank::NUM_RANK) & SUIT_MASK];
+
+        // with at most seven cards, at most one suit can hold a flush
+        const uint32_t key = c.key + d.key + h.key + s.key;
+        if ((key >> COUNT_SHIFT) > MAX_CARDS)
+            return cards.evaluateHigh();
+        const int flush = c.flush | d.flush | h.flush | s.flush;
+        if (flush != 0)
+            return PokerEvaluation(flush);
+        return PokerEvaluation(_ranks[slot (key & QUINARY_MASK)]);
+    }
+
+    /**
+     * the HandOrdinals::HIGH ordinal of evaluate (cards), for hands of
+     * five cards or more.  Hands of fewer than five cards have no class,
+     * and give zero.
+     */
+    uint16_t evaluateOrdinal (const CardSet& cards) const
+    {
+        const uint64_t mask = cards.mask();
+        const uint64_t SUIT_MASK = NUM_SUIT_MASKS-1;
+        const size_t c =  mask                      & SUIT_MASK;
+        const size_t d = (mask >>   Rank::NUM_RANK) & SUIT_MASK;
+        const size_t h = (mask >> 2*Rank::NUM_RANK) & SUIT_MASK;
+        const size_t s = (mask >> 3*Rank::NUM_RANK) & SUIT_MASK;
+
+        const uint32_t key = _suits[c].key + _suits[d].key + _suits[h].key + _suits[s].key;
+        if ((key >> COUNT_SHIFT) > MAX_CARDS)
+            return HandOrdinals::shared (HandOrdinals::HIGH).evaluateOrdinal (cards);
+        const uint16_t flush = _flushOrdinals[c] | _flushOrdinals[d] |
+                               _flushOrdinals[h] | _flushOrdinals[s];
+        if (flush != 0)
+            return flush;
+        return _rankOrdinals[slot (key & QUINARY_MASK)];
+    }
+
+    /**
+     * the evaluation of a multiset of up to MAX_CARDS ranks, given as the
+     * sum of the rankKey of each of its cards, ignoring flushes
+     */
+    PokerEvaluation evaluateRanks (uint32_t quinary) const
+    {
+        return PokerEvaluation(_ranks[slot (quinary)]);
+    }
+
+    /**
+     * the flush or straight flush made by the ranks of one suit, or zero
+     * if there are fewer than five of them
+     */
+    PokerEvaluation evaluateFlush (int ranks) const
+    {
+        return PokerEvaluation(_suits[ranks].flush);
+    }
+
+    /**
+     * what a card of the rank adds to the key of evaluateRanks
+     */
+    uint32_t rankKey (size_t rank) const
+    {
+        return _suits[1 << rank].key & QUINARY_MASK;
+    }
+
+    /**
+     * the slot of the rank table for the base five number of a multiset
+     * of ranks
+     */
+    size_t slot (uint32_t quinary) const
+    {
+        const uint32_t u = quinary * _multiplier;
+        const size_t primary = u >> (32-SLOT_BITS);
+        const size_t bucket  = (u >> (32-SLOT_BITS-BUCKET_BITS)) & (NUM_BUCKETS-1);
+        return primary ^ _displacements[bucket];
+    }
+
+    /**
+     * evaluate n hands, given as card masks, into out, the same as
+     * evaluate does for each of them.  The first form uses the widest
+     * path the cpu supports.
+     */
+    void evaluateBatch (const uint64_t* masks, PokerEvaluation* out, size_t n) const;
+    void evaluateBatch (const uint64_t* masks, PokerEvaluation* out, size_t n,
+                        BatchPath path) const;
+
+    /**
+     * the widest batch path this build and cpu support, checked once
+     */
+    static BatchPath bestBatchPath ();
+
+    /**
+     * an evaluator shared by the whole process, built on first use
+     */
+    static const RankHashEvaluator& shared ();
+
+    /**
+     * bytes used by the tables
+     */
+    static size_t tableSize ();
+
+private:
+    friend struct RankHashBatch;
+
+    static const size_t   NUM_SLOTS    = 1 << SLOT_BITS;
+    static const size_t   NUM_BUCKETS  = 1 << BUCKET_BITS;
+    static const size_t   COUNT_SHIFT  = 24;
+    static const uint32_t QUINARY_MASK = (1 << COUNT_SHIFT) - 1;
+
+    struct SuitEntry
+    {
+        int      flush;             //!< zero for fewer than five cards
+        uint32_t key;               //!< card count << COUNT_SHIFT | ranks in base five
+    };
+
+    bool findDisplacements (const std::vector<uint32_t>& quinaries);
+
+    uint32_t  _multiplier;
+    SuitEntry _suits[NUM_SUIT_MASKS];
+    uint16_t  _displacements[NUM_BUCKETS+1];    //!< one spare for 32 bit gathers
+    int       _ranks[NUM_SLOTS];
+    uint16_t  _flushOrdinals[NUM_SUIT_MASKS];   //!< zero for fewer than five cards
+    uint16_t  _rankOrdinals[NUM_SLOTS];
+};
+
+/**
+ * The high evaluations of n hands, given as card masks, the same as
+ * CardSet::evaluateHigh for each of them.  It uses the shared
+ * RankHashEvaluator, and the widest batch path the cpu supports.
+ */
+void evaluateHighBatch (const uint64_t* masks, PokerEvaluation* out, size_t n);
+}
+
+#endif  // PEVAL_RANKHASHEVALUATOR_H_
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <pokerstove/util/combinations.h>
+#include "RankHashEvaluator.h"
+
+using namespace pokerstove;
+using namespace std;
+
+TEST(RankHashEvaluator, MatchesEvaluateHigh) {
+    RankHashEvaluator* eval = new RankHashEvaluator;
+    for (size_t k=0; k<=RankHashEvaluator::MAX_CARDS; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        size_t mismatches = 0;
+        do
+        {
+            CardSet hand(hands.getMask());
+            if (eval->evaluate(hand) != hand.evaluateHigh())
+                mismatches++;
+        }
+        while (hands.next());
+        EXPECT_EQ(0, mismatches) << k << " cards";
+    }
+
+    // larger hands are passed on
+    CardSet big("AsAhAdAcKsKhKdKc");
+    EXPECT_EQ(big.evaluateHigh(), eval->evaluate(big));
+    delete eval;
+}
+
+TEST(RankHashEvaluator, OrdinalsMatchEvaluateHigh) {
+    const HandOrdinals& ordinals = HandOrdinals::shared(HandOrdinals::HIGH);
+    const RankHashEvaluator& eval = RankHashEvaluator::shared();
+    for (size_t k=FULL_HAND_SIZE; k<=RankHashEvaluator::MAX_CARDS; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        size_t mismatches = 0;
+        do
+        {
+            CardSet hand(hands.getMask());
+            if (eval.evaluateOrdinal(hand) != ordinals.ordinal(hand.evaluateHigh()))
+                mismatches++;
+        }
+        while (hands.next());
+        EXPECT_EQ(0, mismatches) << k << " cards";
+    }
+
+    CardSet big("AsAhAdAcKsKhKdKc");
+    EXPECT_EQ(ordinals.ordinal(big.evaluateHigh()), eval.evaluateOrdinal(big));
+    EXPECT_EQ(0, eval.evaluateOrdinal(CardSet("AsAh")));
+}
+
+TEST(RankHashEvaluator, FitsInCache) {
+    EXPECT_LT(RankHashEvaluator::tableSize(), 150*1024);
+}
+
+TEST(RankHashEvaluator, BatchMatchesEvaluateHigh) {
+    // every hand of up to seven cards, then some larger ones, so that
+    // the vector paths see both a ragged tail and lanes they pass on
+    vector<uint64_t> masks;
+    for (size_t k=0; k<=RankHashEvaluator::MAX_CARDS; k++)
+    {
+        combinations hands(STANDARD_DECK_SIZE, k);
+        do
+            masks.push_back(hands.getMask());
+        while (hands.next());
+    }
+    combinations big(20, 9);
+    for (size_t i=0; i<1000 && big.next(); i++)
+        masks.push_back(big.getMask() << 3);
+    masks.push_back(UINT64_C(0xfffffffff));
+
+    vector<PokerEvaluation> expected(masks.size());
+    for (size_t i=0; i<masks.size(); i++)
+        expected[i] = CardSet(masks[i]).evaluateHigh();
+
+    RankHashEvaluator* eval = new RankHashEvaluator;
+    vector<PokerEvaluation> out(masks.size());
+    for (int path=RankHashEvaluator::SCALAR; path<=RankHashEvaluator::bestBatchPath(); path++)
+    {
+        eval->evaluateBatch(&masks[0], &out[0], masks.size(),
+                            static_cast<RankHashEvaluator::BatchPath>(path));
+        size_t mismatches = 0;
+        for (size_t i=0; i<masks.size(); i++)
+            if (out[i] != expected[i])
+                mismatches++;
+        EXPECT_EQ(0, mismatches) << "path " << path;
+    }
+    delete eval;
+
+    out.assign(masks.size(), PokerEvaluation());
+    evaluateHighBatch(&masks[0], &out[0], 37);
+    for (size_t i=0; i<37; i++)
+        EXPECT_EQ(expected[i], out[i]);
+}
@@ -0,0 +1,242 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "RankHashEvaluator.h"
+
+#include <stdexcept>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PEVAL_X86_BATCH
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace pokerstove;
+
+namespace pokerstove
+{
+/**
+ * The batch paths, each evaluates as many hands as fit its registers,
+ * and leaves the rest for the scalar loop.  The vector paths are compiled
+ * for their instruction sets one function at a time, so the rest of the
+ * library does not need them, and are only called when the cpu has them.
+ */
+struct RankHashBatch
+{
+    typedef RankHashEvaluator RHE;
+
+    // hands of more than MAX_CARDS cards, which the vector paths pass on
+    static void evaluateLanes (const RHE& e, const uint64_t* masks,
+                               PokerEvaluation* out, unsigned lanes)
+    {
+        for (size_t l=0; lanes != 0; l++, lanes >>= 1)
+            if (lanes & 0x01)
+                out[l] = e.evaluate (CardSet(masks[l]));
+    }
+
+#ifdef PEVAL_X86_BATCH
+    // Each suit mask is split in three chunks of three ranks.  CHUNKS
+    // holds, for each chunk value, its ranks in base five in the low
+    // byte and its number of cards above that, so that both can be
+    // summed a chunk at a time.  The vector paths look the chunks up with
+    // a permute, rather than gathering from the suit table.
+    static const int CHUNK_BITS  = 3;
+    static const int COUNT_SHIFT = 8;
+
+    static int chunkEntry (int x)
+    {
+        return ((x & 1) + 5*((x >> 1) & 1) + 25*((x >> 2) & 1)) |
+               ((( x & 1) + ((x >> 1) & 1) + ((x >> 2) & 1)) << COUNT_SHIFT);
+    }
+
+    // the lanes which hold a flush or more than MAX_CARDS cards are left
+    // to evaluateLanes
+    __attribute__((target("avx2")))
+    static size_t avx2 (const RHE& e, const uint64_t* masks, PokerEvaluation* out, size_t n)
+    {
+        alignas(32) int table[8];
+        for (int x=0; x<8; x++)
+            table[x] = chunkEntry (x);
+        const __m256i chunks     = _mm256_load_si256 (reinterpret_cast<const __m256i*>(table));
+        const __m256i chunkMask  = _mm256_set1_epi32 (7);
+        const __m256i lowByte    = _mm256_set1_epi32 (0xff);
+        const __m256i flushSize  = _mm256_set1_epi32 (4);
+        const __m256i maxCards   = _mm256_set1_epi32 (RHE::MAX_CARDS);
+        const __m256i multiplier = _mm256_set1_epi32 (static_cast<int>(e._multiplier));
+        const __m256i bucketMask = _mm256_set1_epi32 (RHE::NUM_BUCKETS-1);
+        const __m256i lowHalf    = _mm256_set1_epi32 (0xffff);
+        const __m256i evens      = _mm256_setr_epi32 (0, 2, 4, 6, 1, 3, 5, 7);
+
+        size_t i = 0;
+        alignas(32) int codes[8];
+        for (; i+8<=n; i+=8)
+        {
+            // the low and high halves of the eight masks
+            const __m256i a = _mm256_permutevar8x32_epi32 (
+                _mm256_loadu_si256 (reinterpret_cast<const __m256i*>(masks+i)), evens);
+            const __m256i b = _mm256_permutevar8x32_epi32 (
+                _mm256_loadu_si256 (reinterpret_cast<const __m256i*>(masks+i+4)), evens);
+            const __m256i lo = _mm256_permute2x128_si256 (a, b, 0x20);
+            const __m256i hi = _mm256_permute2x128_si256 (a, b, 0x31);
+
+            __m256i sums[3] = { _mm256_setzero_si256 (), _mm256_setzero_si256 (), _mm256_setzero_si256 () };
+            __m256i total = _mm256_setzero_si256 ();
+            __m256i count = _mm256_setzero_si256 ();
+            __m256i pass  = _mm256_setzero_si256 ();
+            for (int c=0; c<STANDARD_DECK_SIZE/CHUNK_BITS; c++)
+            {
+                const int shift = c*CHUNK_BITS;
+                __m256i bits = (shift+CHUNK_BITS <= 32 ? _mm256_srli_epi32 (lo, shift) :
+                                shift >= 32        ? _mm256_srli_epi32 (hi, shift-32) :
+                                _mm256_or_si256 (_mm256_srli_epi32 (lo, shift), _mm256_slli_epi32 (hi, 32-shift)));
+                __m256i entry = _mm256_permutevar8x32_epi32 (chunks, _mm256_and_si256 (bits, chunkMask));
+                sums[c % 3] = _mm256_add_epi32 (sums[c % 3], _mm256_and_si256 (entry, lowByte));
+                total = _mm256_add_epi32 (total, entry);
+
+                // a suit is done every third chunk, check it for a flush
+                if (c % 3 == 2)
+                {
+                    __m256i suited = _mm256_srli_epi32 (total, COUNT_SHIFT);
+                    pass  = _mm256_or_si256 (pass, _mm256_cmpgt_epi32 (suited, flushSize));
+                    count = _mm256_add_epi32 (count, suited);
+                    total = _mm256_setzero_si256 ();
+                }
+            }
+            pass = _mm256_or_si256 (pass, _mm256_cmpgt_epi32 (count, maxCards));
+            const __m256i quinary = _mm256_add_epi32 (
+                sums[0],
+                _mm256_add_epi32 (_mm256_mullo_epi32 (sums[1], _mm256_set1_epi32 (125)),
+                                  _mm256_mullo_epi32 (sums[2], _mm256_set1_epi32 (15625))));
+
+            const __m256i u = _mm256_mullo_epi32 (quinary, multiplier);
+            const __m256i primary = _mm256_srli_epi32 (u, 32-RHE::SLOT_BITS);
+            const __m256i bucket  = _mm256_and_si256 (_mm256_srli_epi32 (u, 32-RHE::SLOT_BITS-RHE::BUCKET_BITS),
+                                                      bucketMask);
+            const __m256i disp = _mm256_and_si256 (
+                _mm256_i32gather_epi32 (reinterpret_cast<const int*>(e._displacements), bucket, 2),
+                lowHalf);
+            _mm256_store_si256 (reinterpret_cast<__m256i*>(codes),
+                                _mm256_i32gather_epi32 (e._ranks, _mm256_xor_si256 (primary, disp), 4));
+            for (size_t l=0; l<8; l++)
+                out[i+l] = PokerEvaluation(codes[l]);
+
+            unsigned lanes = static_cast<unsigned>(_mm256_movemask_ps (_mm256_castsi256_ps (pass)));
+            if (lanes != 0)
+                evaluateLanes (e, masks+i, out+i, lanes);
+        }
+        return i;
+    }
+
+    __attribute__((target("avx512f")))
+    static size_t avx512 (const RHE& e, const uint64_t* masks, PokerEvaluation* out, size_t n)
+    {
+        alignas(64) int table[16];
+        for (int x=0; x<16; x++)
+            table[x] = chunkEntry (x & 7);
+        const __m512i chunks     = _mm512_load_si512 (table);
+        const __m512i chunkMask  = _mm512_set1_epi32 (7);
+        const __m512i lowByte    = _mm512_set1_epi32 (0xff);
+        const __m512i flushSize  = _mm512_set1_epi32 (4);
+        const __m512i maxCards   = _mm512_set1_epi32 (RHE::MAX_CARDS);
+        const __m512i multiplier = _mm512_set1_epi32 (static_cast<int>(e._multiplier));
+        const __m512i bucketMask = _mm512_set1_epi32 (RHE::NUM_BUCKETS-1);
+        const __m512i lowHalf    = _mm512_set1_epi32 (0xffff);
+
+        size_t i = 0;
+        alignas(64) int codes[16];
+        for (; i+16<=n; i+=16)
+        {
+            // the low and high halves of the sixteen masks
+            const __m512i a = _mm512_loadu_si512 (masks+i);
+            const __m512i b = _mm512_loadu_si512 (masks+i+8);
+            const __m512i lo = _mm512_inserti64x4 (_mm512_castsi256_si512 (_mm512_cvtepi64_epi32 (a)),
+                                                   _mm512_cvtepi64_epi32 (b), 1);
+            const __m512i hi = _mm512_inserti64x4 (_mm512_castsi256_si512 (_mm512_cvtepi64_epi32 (_mm512_srli_epi64 (a, 32))),
+                                                   _mm512_cvtepi64_epi32 (_mm512_srli_epi64 (b, 32)), 1);
+
+            __m512i sums[3] = { _mm512_setzero_si512 (), _mm512_setzero_si512 (), _mm512_setzero_si512 () };
+            __m512i total = _mm512_setzero_si512 ();
+            __m512i count = _mm512_setzero_si512 ();
+            __mmask16 pass = 0;
+            for (int c=0; c<STANDARD_DECK_SIZE/CHUNK_BITS; c++)
+            {
+                const int shift = c*CHUNK_BITS;
+                __m512i bits = (shift+CHUNK_BITS <= 32 ? _mm512_srli_epi32 (lo, shift) :
+                                shift >= 32        ? _mm512_srli_epi32 (hi, shift-32) :
+                                _mm512_or_si512 (_mm512_srli_epi32 (lo, shift), _mm512_slli_epi32 (hi, 32-shift)));
+                __m512i entry = _mm512_permutexvar_epi32 (_mm512_and_si512 (bits, chunkMask), chunks);
+                sums[c % 3] = _mm512_add_epi32 (sums[c % 3], _mm512_and_si512 (entry, lowByte));
+                total = _mm512_add_epi32 (total, entry);
+
+                // a suit is done every third chunk, check it for a flush
+                if (c % 3 == 2)
+                {
+                    __m512i suited = _mm512_srli_epi32 (total, COUNT_SHIFT);
+                    pass |= _mm512_cmpgt_epi32_mask (suited, flushSize);
+                    count = _mm512_add_epi32 (count, suited);
+                    total = _mm512_setzero_si512 ();
+                }
+            }
+            pass |= _mm512_cmpgt_epi32_mask (count, maxCards);
+            const __m512i quinary = _mm512_add_epi32 (
+                sums[0],
+                _mm512_add_epi32 (_mm512_mullo_epi32 (sums[1], _mm512_set1_epi32 (125)),
+                                  _mm512_mullo_epi32 (sums[2], _mm512_set1_epi32 (15625))));
+
+            const __m512i u = _mm512_mullo_epi32 (quinary, multiplier);
+            const __m512i primary = _mm512_srli_epi32 (u, 32-RHE::SLOT_BITS);
+            const __m512i bucket  = _mm512_and_si512 (_mm512_srli_epi32 (u, 32-RHE::SLOT_BITS-RHE::BUCKET_BITS),
+                                                      bucketMask);
+            const __m512i disp = _mm512_and_si512 (_mm512_i32gather_epi32 (bucket, e._displacements, 2),
+                                                   lowHalf);
+            _mm512_store_si512 (codes, _mm512_i32gather_epi32 (_mm512_xor_si512 (primary, disp), e._ranks, 4));
+            for (size_t l=0; l<16; l++)
+                out[i+l] = PokerEvaluation(codes[l]);
+
+            if (pass != 0)
+                evaluateLanes (e, masks+i, out+i, pass);
+        }
+        return i;
+    }
+#endif
+};
+}
+
+void RankHashEvaluator::evaluateBatch (const uint64_t* masks, PokerEvaluation* out, size_t n) const
+{
+    evaluateBatch (masks, out, n, bestBatchPath());
+}
+
+void RankHashEvaluator::evaluateBatch (const uint64_t* masks, PokerEvaluation* out, size_t n,
+                                       BatchPath path) const
+{
+    if (path > bestBatchPath())
+        throw runtime_error("RankHashEvaluator, batch path not supported by this cpu");
+
+    size_t done = 0;
+#ifdef PEVAL_X86_BATCH
+    if (path == AVX512)
+        done = RankHashBatch::avx512 (*this, masks, out, n);
+    else if (path == AVX2)
+        done = RankHashBatch::avx2 (*this, masks, out, n);
+#endif
+    for (size_t i=done; i<n; i++)
+        out[i] = evaluate (CardSet(masks[i]));
+}
+
+RankHashEvaluator::BatchPath RankHashEvaluator::bestBatchPath ()
+{
+#ifdef PEVAL_X86_BATCH
+    static const BatchPath best =
+        (__builtin_cpu_init (), __builtin_cpu_supports ("avx512f") ? AVX512 :
+                                __builtin_cpu_supports ("avx2")    ? AVX2   : SCALAR);
+    return best;
+#else
+    return SCALAR;
+#endif
+}
+
+void pokerstove::evaluateHighBatch (const uint64_t* masks, PokerEvaluation* out, size_t n)
+{
+    RankHashEvaluator::shared().evaluateBatch (masks, out, n);
+}
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "RankTable.h"
+
+#include "Card.h"
+#include "CardSetGenerators.h"
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+const MappedTable::Format FORMAT =
+    { "RankTable", "a rank table", "PSRANKS", RankTable::VERSION };
+}
+
+RankTable::RankTable (const string& filename)
+    : _table(FORMAT, filename, sizeof(Header))
+    , _entries(NULL)
+{
+    const Header& header = _table.header<Header>();
+    _table.require (header.maxCards == MAX_CARDS &&
+                    header.numEntries == numEntries(), "built for another deck");
+    _entries = static_cast<const int32_t*>(
+        _table.data (header.dataOffset, numEntries()*sizeof(int32_t)));
+    for (size_t n=0; n<=MAX_CARDS; n++)
+        _offsets[n] = offset (n);
+}
+
+size_t RankTable::offset (size_t n)
+{
+    // the sum of C(NUM_RANK-1+k,k) for k < n
+    size_t ret = 0;
+    size_t count = 1;
+    for (size_t k=0; k<n; k++)
+    {
+        ret += count;
+        count = count*(Rank::NUM_RANK+k)/(k+1);
+    }
+    return ret;
+}
+
+vector<int32_t> RankTable::build ()
+{
+    // one hand for each multiset of n ranks which can be dealt
+    vector<int32_t> entries(numEntries(), 0);
+    for (size_t n=0; n<=MAX_CARDS; n++)
+    {
+        const size_t start = offset (n);
+        visitCardSets (n, Card::RANK, [&](const CardSet& hand, size_t)
+        {
+            entries[start + hand.rankColex()] = hand.evaluateHighRanks().code();
+        });
+    }
+    return entries;
+}
+
+void RankTable::write (const string& filename)
+{
+    vector<int32_t> entries = build ();
+
+    Header header = Header();
+    header.maxCards   = MAX_CARDS;
+    header.numEntries = static_cast<uint32_t>(entries.size());
+    header.dataOffset = DATA_OFFSET;
+    MappedTable::write (FORMAT, filename, header, DATA_OFFSET, entries);
+}
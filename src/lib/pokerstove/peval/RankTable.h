@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_RANKTABLE_H_
+#define PEVAL_RANKTABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CardSet.h"
+#include "MappedTable.h"
+#include "PokerEvaluation.h"
+#include "Rank.h"
+
+namespace pokerstove
+{
+/**
+ * The rank only high evaluations, CardSet::evaluateHighRanks, of every
+ * multiset of up to MAX_CARDS ranks, memory mapped from a file built by
+ * ps-lut --ranks.  The multisets of n ranks are numbered by
+ * CardSet::rankColex, from zero to C(NUM_RANK-1+n,n)-1, so the entries
+ * of a hand are at offset(n) + rankColex, and the whole table comes to
+ * 11440 entries.  Multisets which hold a rank more than four times can
+ * not be dealt, and their entries are zero.
+ *
+ * File layout: a Header, padding up to dataOffset, then the entries as
+ * int32 in native byte order.
+ */
+class RankTable
+{
+public:
+    static const uint32_t VERSION     = 1;
+    static const size_t   MAX_CARDS   = 7;
+    static const uint64_t DATA_OFFSET = 4096;
+
+    struct Header
+    {
+        MappedTable::Prefix prefix; //!< "PSRANKS", VERSION
+        uint32_t maxCards;          //!< MAX_CARDS
+        uint32_t numEntries;        //!< numEntries()
+        uint64_t dataOffset;        //!< where the entries start
+    };
+
+    /**
+     * map a table file, throws std::runtime_error if it can not be read or
+     * was not built for this deck and version
+     */
+    explicit RankTable (const std::string& filename);
+
+    /**
+     * where the multisets of n ranks start, for n <= MAX_CARDS+1
+     */
+    static size_t offset (size_t n);
+
+    static size_t numEntries () { return offset (MAX_CARDS+1); }
+
+    /**
+     * the rank evaluation of n <= MAX_CARDS ranks, given by their
+     * rankColex
+     */
+    PokerEvaluation evaluate (size_t n, size_t rankColex) const
+    {
+        return PokerEvaluation(_entries[_offsets[n] + rankColex]);
+    }
+
+    /**
+     * the same as cards.evaluateHighRanks().  Hands of more than MAX_CARDS
+     * cards are passed on to evaluateHighRanks.
+     */
+    PokerEvaluation evaluate (const CardSet& cards) const
+    {
+        const size_t n = cards.size();
+        if (n > MAX_CARDS)
+            return cards.evaluateHighRanks();
+        return evaluate (n, cards.rankColex());
+    }
+
+    /**
+     * build the entries, numEntries() of them
+     */
+    static std::vector<int32_t> build ();
+
+    /**
+     * build the table and write it to a file
+     */
+    static void write (const std::string& filename);
+
+private:
+    MappedTable    _table;
+    const int32_t* _entries;
+    size_t         _offsets[MAX_CARDS+1];
+};
+}
+
+#endif  // PEVAL_RANKTABLE_H_
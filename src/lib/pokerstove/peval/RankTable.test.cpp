@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <boost/shared_ptr.hpp>
+#include "Card.h"
+#include "RankTable.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+const char* FILENAME = "RankTable.test.bin";
+
+class RankTableTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        RankTable::write(FILENAME);
+        table.reset(new RankTable(FILENAME));
+    }
+
+    static void TearDownTestCase()
+    {
+        table.reset();
+        remove(FILENAME);
+    }
+
+    static boost::shared_ptr<const RankTable> table;
+};
+
+boost::shared_ptr<const RankTable> RankTableTest::table;
+}
+
+TEST(RankTable, Offsets) {
+    EXPECT_EQ(0, RankTable::offset(0));
+    EXPECT_EQ(1, RankTable::offset(1));
+    EXPECT_EQ(1+9, RankTable::offset(2));
+    EXPECT_EQ(1+9+45+165+495+1287+3003+6435, RankTable::numEntries());
+}
+
+TEST_F(RankTableTest, MatchesEvaluateHighRanks) {
+    mt19937 rng(17);
+    vector<int> deck(STANDARD_DECK_SIZE);
+    for (size_t i=0; i<deck.size(); i++)
+        deck[i] = static_cast<int>(i);
+    size_t mismatches = 0;
+    for (size_t t=0; t<100000; t++)
+    {
+        shuffle(deck.begin(), deck.end(), rng);
+        CardSet hand;
+        for (size_t i=0; i<t%(RankTable::MAX_CARDS+3); i++)
+            hand.insert(Card(deck[i]));
+        if (table->evaluate(hand) != hand.evaluateHighRanks())
+            mismatches++;
+        if (hand.size() <= RankTable::MAX_CARDS &&
+            table->evaluate(hand.size(), hand.rankColex()) != hand.evaluateHighRanks())
+            mismatches++;
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST_F(RankTableTest, RanksOfPocketAndBoard) {
+    CardSet pocket("AcAd");
+    CardSet board("AhKsKdQc9c");
+    CardSet hand = pocket;
+    ASSERT_TRUE(hand.insertRanks(board));
+    EXPECT_EQ((pocket|board).evaluateHighRanks(), table->evaluate(hand));
+    EXPECT_EQ(table->evaluate(pocket|board), table->evaluate(hand));
+}
+
+TEST(RankTable, RejectsOtherFiles) {
+    FILE* f = fopen(FILENAME, "wb");
+    fputs("not a rank table", f);
+    fclose(f);
+    EXPECT_THROW(RankTable table(FILENAME), runtime_error);
+    remove(FILENAME);
+    EXPECT_THROW(RankTable table(FILENAME), runtime_error);
+}
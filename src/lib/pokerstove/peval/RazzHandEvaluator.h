@@ -5,6 +5,7 @@
 #ifndef PEVAL_RAZZHANDEVALUATOR_H_
 #define PEVAL_RAZZHANDEVALUATOR_H_
 
+#include "LowballTable.h"
 #include "PokerHandEvaluator.h"
 
 namespace pokerstove
@@ -15,15 +16,19 @@ namespace pokerstove
 class RazzHandEvaluator : public PokerHandEvaluator
 {
 public:
+    RazzHandEvaluator()
+        : PokerHandEvaluator()
+        , _lowball(&LowballTable::shared())
+    {}
 
     virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
     {
-        return PokerHandEvaluation(hand.evaluateLowA5());
+        return PokerHandEvaluation(_lowball->evaluateLowA5(hand));
     }
 
     virtual PokerEvaluation evaluateRanks(const CardSet& hand, const CardSet& board=CardSet(0)) const
     {
-        return hand.evaluateLowA5();
+        return _lowball->evaluateLowA5(hand);
     }
 
     virtual bool usesSuits() const
@@ -34,6 +39,16 @@ public:
     virtual size_t handSize() const { return 7; }
     virtual size_t boardSize() const { return 0; }
     virtual size_t evaluationSize() const { return 1; }
+
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        _lowballTable = table;
+        _lowball = (table ? table.get() : &LowballTable::shared());
+    }
+
+private:
+    const LowballTable* _lowball;
+    boost::shared_ptr<const LowballTable> _lowballTable;
 };
 
 }
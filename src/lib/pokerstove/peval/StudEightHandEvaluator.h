@@ -5,6 +5,7 @@
 #ifndef PEVAL_STUDEIGHTHANDEVALUATOR_H_
 #define PEVAL_STUDEIGHTHANDEVALUATOR_H_
 
+#include "LowballTable.h"
 #include "PokerHandEvaluator.h"
 
 namespace pokerstove
@@ -15,15 +16,29 @@ namespace pokerstove
 class StudEightHandEvaluator : public PokerHandEvaluator
 {
 public:
+    StudEightHandEvaluator()
+        : PokerHandEvaluator()
+        , _lowball(&LowballTable::shared())
+    {}
 
     virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
     {
-        return PokerHandEvaluation(hand.evaluateHigh(), hand.evaluate8LowA5());
+        return PokerHandEvaluation(hand.evaluateHigh(), _lowball->evaluate8LowA5(hand));
     }
 
     virtual size_t handSize() const { return 7; }
     virtual size_t boardSize() const { return 0; }
     virtual size_t evaluationSize() const { return 2; }
+
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        _lowballTable = table;
+        _lowball = (table ? table.get() : &LowballTable::shared());
+    }
+
+private:
+    const LowballTable* _lowball;
+    boost::shared_ptr<const LowballTable> _lowballTable;
 };
 
 }
@@ -5,6 +5,7 @@
 #ifndef PEVAL_STUDHANDEVALUATOR_H_
 #define PEVAL_STUDHANDEVALUATOR_H_
 
+#include "HighStateTable.h"
 #include "PokerHandEvaluator.h"
 
 namespace pokerstove
@@ -19,6 +20,8 @@ public:
     virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
     {
         //return hand.evaluateHighRanks ();
+        if (_highStates)
+            return PokerHandEvaluation(_highStates->evaluate(hand));
         return PokerHandEvaluation(hand.evaluateHigh());
     }
 
@@ -35,6 +38,14 @@ public:
     virtual size_t handSize() const { return 7; }
     virtual size_t boardSize() const { return 0; }
     virtual size_t evaluationSize() const { return 1; }
+
+    virtual void setHighStateTable(boost::shared_ptr<const HighStateTable> table)
+    {
+        _highStates = table;
+    }
+
+private:
+    boost::shared_ptr<const HighStateTable> _highStates;
 };
 
 }
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_STUDHIGHLOWHANDEVALUATOR_H_
+#define PEVAL_STUDHIGHLOWHANDEVALUATOR_H_
+
+#include "LowballTable.h"
+#include "PokerHandEvaluator.h"
+
+namespace pokerstove
+{
+/**
+ * A specialized hand evaluator for stud high/low with no qualifier for
+ * the low half.
+ */
+class StudHighLowHandEvaluator : public PokerHandEvaluator
+{
+public:
+    StudHighLowHandEvaluator()
+        : PokerHandEvaluator()
+        , _lowball(&LowballTable::shared())
+    {}
+
+    virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
+    {
+        return PokerHandEvaluation(hand.evaluateHigh(), _lowball->evaluateLowA5(hand));
+    }
+
+    virtual size_t handSize() const { return 7; }
+    virtual size_t boardSize() const { return 0; }
+    virtual size_t evaluationSize() const { return 2; }
+
+    virtual void setLowballTable(boost::shared_ptr<const LowballTable> table)
+    {
+        _lowballTable = table;
+        _lowball = (table ? table.get() : &LowballTable::shared());
+    }
+
+private:
+    const LowballTable* _lowball;
+    boost::shared_ptr<const LowballTable> _lowballTable;
+};
+
+}
+#endif  // PEVAL_STUDHIGHLOWHANDEVALUATOR_H_
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#include "SuitPermutation.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PEVAL_X86_SUITS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace pokerstove;
+
+namespace
+{
+#ifdef PEVAL_X86_SUITS
+bool hasAvx2 ()
+{
+    static const bool avx2 = (__builtin_cpu_init (), __builtin_cpu_supports ("avx2"));
+    return avx2;
+}
+
+// the larger of each lane in a, the smaller in b
+__attribute__((target("avx2")))
+inline void compareExchange (__m256i& a, __m256i& b)
+{
+    const __m256i less = _mm256_cmpgt_epi64 (b, a);
+    const __m256i hi = _mm256_blendv_epi8 (a, b, less);
+    b = _mm256_blendv_epi8 (b, a, less);
+    a = hi;
+}
+
+// the network and keys of canonizeSuits, one mask to a lane
+__attribute__((target("avx2")))
+size_t canonizeAvx2 (const uint64_t* masks, size_t n, uint64_t* out, SuitPermutation* perms)
+{
+    const __m256i suitMask = _mm256_set1_epi64x ((1 << Rank::NUM_RANK) - 1);
+    const __m256i suitBits = _mm256_set1_epi64x (0x03);
+    const __m256i lastSuit = _mm256_set1_epi64x (Suit::NUM_SUIT-1);
+
+    size_t i = 0;
+    alignas(32) uint64_t packed[4];
+    for (; i+4<=n; i+=4)
+    {
+        const __m256i m = _mm256_loadu_si256 (reinterpret_cast<const __m256i*>(masks+i));
+        __m256i k0 = _mm256_or_si256 (_mm256_slli_epi64 (_mm256_and_si256 (m, suitMask), 2),
+                                      _mm256_set1_epi64x (3));
+        __m256i k1 = _mm256_or_si256 (_mm256_slli_epi64 (_mm256_and_si256 (
+                                          _mm256_srli_epi64 (m, Rank::NUM_RANK), suitMask), 2),
+                                      _mm256_set1_epi64x (2));
+        __m256i k2 = _mm256_or_si256 (_mm256_slli_epi64 (_mm256_and_si256 (
+                                          _mm256_srli_epi64 (m, 2*Rank::NUM_RANK), suitMask), 2),
+                                      _mm256_set1_epi64x (1));
+        __m256i k3 = _mm256_slli_epi64 (_mm256_and_si256 (
+                                          _mm256_srli_epi64 (m, 3*Rank::NUM_RANK), suitMask), 2);
+        compareExchange (k0, k1);
+        compareExchange (k2, k3);
+        compareExchange (k0, k2);
+        compareExchange (k1, k3);
+        compareExchange (k1, k2);
+
+        const __m256i canon = _mm256_or_si256 (
+            _mm256_or_si256 (_mm256_srli_epi64 (k0, 2),
+                             _mm256_slli_epi64 (_mm256_srli_epi64 (k1, 2), Rank::NUM_RANK)),
+            _mm256_or_si256 (_mm256_slli_epi64 (_mm256_srli_epi64 (k2, 2), 2*Rank::NUM_RANK),
+                             _mm256_slli_epi64 (_mm256_srli_epi64 (k3, 2), 3*Rank::NUM_RANK)));
+        _mm256_storeu_si256 (reinterpret_cast<__m256i*>(out+i), canon);
+
+        if (perms)
+        {
+            // canonical suit t goes in the bits of the suit its key holds
+            const __m256i* keys[4] = {&k0, &k1, &k2, &k3};
+            __m256i perm = _mm256_setzero_si256 ();
+            for (int t=0; t<4; t++)
+            {
+                const __m256i shift = _mm256_slli_epi64 (
+                    _mm256_sub_epi64 (lastSuit, _mm256_and_si256 (*keys[t], suitBits)), 1);
+                perm = _mm256_or_si256 (perm, _mm256_sllv_epi64 (_mm256_set1_epi64x (t), shift));
+            }
+            _mm256_store_si256 (reinterpret_cast<__m256i*>(packed), perm);
+            for (size_t l=0; l<4; l++)
+                perms[i+l] = static_cast<SuitPermutation>(packed[l]);
+        }
+    }
+    return i;
+}
+
+// suit s of each lane moves by nine times the suit its permutation names
+__attribute__((target("avx2")))
+size_t permuteAvx2 (const uint64_t* masks, const SuitPermutation* perms, size_t n, uint64_t* out)
+{
+    const __m256i suitMask = _mm256_set1_epi64x ((1 << Rank::NUM_RANK) - 1);
+    const __m256i suitBits = _mm256_set1_epi64x (0x03);
+
+    size_t i = 0;
+    for (; i+4<=n; i+=4)
+    {
+        const __m256i m = _mm256_loadu_si256 (reinterpret_cast<const __m256i*>(masks+i));
+        int32_t bytes;
+        memcpy (&bytes, perms+i, sizeof(bytes));
+        const __m256i p = _mm256_cvtepu8_epi64 (_mm_cvtsi32_si128 (bytes));
+        __m256i ret = _mm256_setzero_si256 ();
+        for (int s=0; s<4; s++)
+        {
+            const __m256i suit = _mm256_and_si256 (_mm256_srli_epi64 (m, s*Rank::NUM_RANK), suitMask);
+            const __m256i to = _mm256_and_si256 (_mm256_srli_epi64 (p, 2*s), suitBits);
+            const __m256i shift = _mm256_add_epi64 (_mm256_slli_epi64 (to, 3), to);
+            ret = _mm256_or_si256 (ret, _mm256_sllv_epi64 (suit, shift));
+        }
+        _mm256_storeu_si256 (reinterpret_cast<__m256i*>(out+i), ret);
+    }
+    return i;
+}
+#endif
+}
+
+void pokerstove::canonizeSuitsBatch (const uint64_t* masks, size_t n,
+                                     uint64_t* out, SuitPermutation* perms)
+{
+    size_t done = 0;
+#ifdef PEVAL_X86_SUITS
+    if (hasAvx2 ())
+        done = canonizeAvx2 (masks, n, out, perms);
+#endif
+    for (size_t i=done; i<n; i++)
+        out[i] = canonizeSuits (masks[i], perms ? perms+i : NULL);
+}
+
+void pokerstove::permuteSuitsBatch (const uint64_t* masks, const SuitPermutation* perms,
+                                    size_t n, uint64_t* out)
+{
+    size_t done = 0;
+#ifdef PEVAL_X86_SUITS
+    if (hasAvx2 ())
+        done = permuteAvx2 (masks, perms, n, out);
+#endif
+    for (size_t i=done; i<n; i++)
+        out[i] = permuteSuits (masks[i], perms[i]);
+}
+
+void pokerstove::permuteSuitsBatch (const uint64_t* masks, SuitPermutation perm,
+                                    size_t n, uint64_t* out)
+{
+    // the shifts are worked out once, and the loop is left to vectorize
+    const uint64_t suitMask = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+    size_t shift[Suit::NUM_SUIT];
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        shift[s] = permutedSuit (perm, s)*Rank::NUM_RANK;
+    for (size_t i=0; i<n; i++)
+    {
+        const uint64_t m = masks[i];
+        out[i] = (m                        & suitMask) << shift[0] |
+                 (m >>   Rank::NUM_RANK    & suitMask) << shift[1] |
+                 (m >> 2*Rank::NUM_RANK    & suitMask) << shift[2] |
+                 (m >> 3*Rank::NUM_RANK    & suitMask) << shift[3];
+    }
+}
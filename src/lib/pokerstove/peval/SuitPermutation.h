@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_SUITPERMUTATION_H_
+#define PEVAL_SUITPERMUTATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "Rank.h"
+#include "Suit.h"
+
+namespace pokerstove
+{
+/**
+ * A renaming of the four suits, packed in a byte: bits [2s, 2s+2) hold
+ * the suit that suit s becomes.  The functions here work on card masks,
+ * allocate nothing, and do not branch on the cards.
+ */
+typedef uint8_t SuitPermutation;
+
+const SuitPermutation IDENTITY_SUITS = 0xE4;    //!< {0,1,2,3}
+
+/**
+ * the permutation taking clubs to c, diamonds to d, hearts to h and
+ * spades to s, as CardSet::rotateSuits takes them
+ */
+inline SuitPermutation packSuits (int c, int d, int h, int s)
+{
+    return static_cast<SuitPermutation>(c | d << 2 | h << 4 | s << 6);
+}
+
+/**
+ * the suit that suit s becomes
+ */
+inline size_t permutedSuit (SuitPermutation perm, size_t s)
+{
+    return perm >> 2*s & 0x03;
+}
+
+inline SuitPermutation inverseSuits (SuitPermutation perm)
+{
+    int ret = 0;
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        ret |= static_cast<int>(s) << 2*permutedSuit (perm, s);
+    return static_cast<SuitPermutation>(ret);
+}
+
+/**
+ * the cards of the mask with their suits renamed
+ */
+inline uint64_t permuteSuits (uint64_t mask, SuitPermutation perm)
+{
+    const uint64_t suitMask = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+    uint64_t ret = 0;
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        ret |= (mask >> s*Rank::NUM_RANK & suitMask) << permutedSuit (perm, s)*Rank::NUM_RANK;
+    return ret;
+}
+
+/**
+ * The canonical form of CardSet::canonize, the suit masks in decreasing
+ * order with the largest in clubs, and in perm, if it is given, the
+ * permutation which makes it.  Suits with the same mask keep their
+ * order, as findSuitPermutation orders them.
+ *
+ * Each suit mask is keyed with its suit in the low two bits, and the
+ * four keys are sorted by a network of five compare exchanges, which
+ * compile to conditional moves.
+ */
+inline uint64_t canonizeSuits (uint64_t mask, SuitPermutation* perm=NULL)
+{
+    const uint64_t suitMask = (UINT64_C(1) << Rank::NUM_RANK) - 1;
+    uint64_t keys[Suit::NUM_SUIT];
+    for (size_t s=0; s<Suit::NUM_SUIT; s++)
+        keys[s] = (mask >> s*Rank::NUM_RANK & suitMask) << 2 | (Suit::NUM_SUIT-1-s);
+
+    static const size_t NETWORK[5][2] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}, {1, 2}};
+    for (size_t i=0; i<5; i++)
+    {
+        uint64_t& a = keys[NETWORK[i][0]];
+        uint64_t& b = keys[NETWORK[i][1]];
+        const uint64_t hi = a > b ? a : b;
+        const uint64_t lo = a > b ? b : a;
+        a = hi;
+        b = lo;
+    }
+
+    uint64_t ret = 0;
+    int packed = 0;
+    for (size_t t=0; t<Suit::NUM_SUIT; t++)
+    {
+        ret |= (keys[t] >> 2) << t*Rank::NUM_RANK;
+        packed |= static_cast<int>(t) << 2*(Suit::NUM_SUIT-1 - (keys[t] & 0x03));
+    }
+    if (perm)
+        *perm = static_cast<SuitPermutation>(packed);
+    return ret;
+}
+
+/**
+ * canonizeSuits of n masks, into out and, if it is not null, perms.  With
+ * AVX2 four masks are sorted at once, one to a lane.
+ */
+void canonizeSuitsBatch (const uint64_t* masks, size_t n,
+                         uint64_t* out, SuitPermutation* perms=NULL);
+
+/**
+ * permuteSuits of n masks, by perms[i] for masks[i], or by the one
+ * permutation.  With AVX2 the per mask permutations shuffle the suits of
+ * four masks at once with per lane shifts, as pshufb would shuffle bytes.
+ */
+void permuteSuitsBatch (const uint64_t* masks, const SuitPermutation* perms,
+                        size_t n, uint64_t* out);
+void permuteSuitsBatch (const uint64_t* masks, SuitPermutation perm,
+                        size_t n, uint64_t* out);
+}
+
+#endif  // PEVAL_SUITPERMUTATION_H_
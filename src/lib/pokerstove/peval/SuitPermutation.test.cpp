@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "CardSet.h"
+#include "SuitPermutation.h"
+
+using namespace pokerstove;
+using namespace std;
+
+namespace
+{
+vector<uint64_t> randomMasks (size_t n, mt19937_64& rng)
+{
+    const uint64_t deck = (UINT64_C(1) << STANDARD_DECK_SIZE) - 1;
+    vector<uint64_t> masks(n);
+    for (size_t i=0; i<n; i++)
+    {
+        // sparse hands like real ones, and some with equal suits
+        masks[i] = rng() & rng() & rng() & deck;
+        if (i % 5 == 0)
+            masks[i] = (masks[i] & 0x1FF) * UINT64_C(0x8040201);
+    }
+    return masks;
+}
+}
+
+TEST(SuitPermutation, PackAndInverse) {
+    int perm[Suit::NUM_SUIT] = {0, 1, 2, 3};
+    do
+    {
+        const SuitPermutation packed = packSuits (perm[0], perm[1], perm[2], perm[3]);
+        for (size_t s=0; s<Suit::NUM_SUIT; s++)
+            EXPECT_EQ(perm[s], static_cast<int>(permutedSuit (packed, s)));
+        EXPECT_EQ(IDENTITY_SUITS, packSuits (0, 1, 2, 3));
+
+        const CardSet hand("As7d7h6c9s");
+        EXPECT_EQ(hand.rotateSuits (perm[0], perm[1], perm[2], perm[3]).mask(),
+                  permuteSuits (hand.mask(), packed));
+        EXPECT_EQ(hand.mask(), permuteSuits (permuteSuits (hand.mask(), packed),
+                                             inverseSuits (packed)));
+    }
+    while (next_permutation (perm, perm+Suit::NUM_SUIT));
+}
+
+TEST(SuitPermutation, CanonizeMatchesSortAndSearch) {
+    mt19937_64 rng(5);
+    const vector<uint64_t> masks = randomMasks (20000, rng);
+    for (size_t i=0; i<masks.size(); i++)
+    {
+        const CardSet hand(masks[i]);
+        int smasks[Suit::NUM_SUIT];
+        for (size_t s=0; s<Suit::NUM_SUIT; s++)
+            smasks[s] = hand.suitMask (Suit(static_cast<uint8_t>(s)));
+        sort (smasks, smasks+Suit::NUM_SUIT);
+        const uint64_t sorted = static_cast<uint64_t>(smasks[3]) |
+                                static_cast<uint64_t>(smasks[2]) << Rank::NUM_RANK |
+                                static_cast<uint64_t>(smasks[1]) << 2*Rank::NUM_RANK |
+                                static_cast<uint64_t>(smasks[0]) << 3*Rank::NUM_RANK;
+
+        SuitPermutation perm;
+        ASSERT_EQ(sorted, canonizeSuits (masks[i], &perm));
+        ASSERT_EQ(sorted, permuteSuits (masks[i], perm));
+
+        // the same permutation the search over the suits finds
+        const vector<int> rot = findSuitPermutation (hand, CardSet(sorted));
+        ASSERT_EQ(packSuits (rot[0], rot[1], rot[2], rot[3]), perm) << hand.str();
+    }
+}
+
+TEST(SuitPermutation, Batches) {
+    mt19937_64 rng(11);
+    const size_t N = 1003;      // not a multiple of the lanes
+    const vector<uint64_t> masks = randomMasks (N, rng);
+    const vector<uint64_t> hands = randomMasks (N, rng);
+
+    vector<uint64_t> canon(N);
+    vector<SuitPermutation> perms(N);
+    canonizeSuitsBatch (&masks[0], N, &canon[0], &perms[0]);
+    vector<uint64_t> onlyCanon(N);
+    canonizeSuitsBatch (&masks[0], N, &onlyCanon[0]);
+    EXPECT_TRUE(canon == onlyCanon);
+
+    vector<uint64_t> permuted(N);
+    permuteSuitsBatch (&hands[0], &perms[0], N, &permuted[0]);
+    for (size_t i=0; i<N; i++)
+    {
+        SuitPermutation perm;
+        ASSERT_EQ(canonizeSuits (masks[i], &perm), canon[i]);
+        ASSERT_EQ(perm, perms[i]);
+        ASSERT_EQ(canonizeToBoard (CardSet(masks[i]), CardSet(hands[i])).mask(), permuted[i]);
+    }
+
+    const SuitPermutation one = packSuits (2, 0, 3, 1);
+    permuteSuitsBatch (&hands[0], one, N, &permuted[0]);
+    for (size_t i=0; i<N; i++)
+        ASSERT_EQ(permuteSuits (hands[i], one), permuted[i]);
+}
@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) 2012 Andrew Prock. All rights reserved.
+ */
+#ifndef PEVAL_THREECARDPOKERHANDEVALUATOR_H_
+#define PEVAL_THREECARDPOKERHANDEVALUATOR_H_
+
+#include "PokerHandEvaluator.h"
+
+namespace pokerstove
+{
+/**
+ * A specialized hand evaluator for three card poker.
+ */
+class ThreeCardPokerHandEvaluator : public PokerHandEvaluator
+{
+public:
+
+    virtual PokerHandEvaluation evaluateHand(const CardSet& hand, const CardSet&) const
+    {
+        return PokerHandEvaluation(hand.evaluate3CP());
+    }
+
+    virtual size_t handSize() const { return 3; }
+    virtual size_t boardSize() const { return 0; }
+    virtual size_t evaluationSize() const { return 1; }
+};
+
+}
+#endif  // PEVAL_THREECARDPOKERHANDEVALUATOR_H_
@@ -0,0 +1,75 @@
+#ifndef __CHOOSE_H
+#define __CHOOSE_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace pokerstove
+{
+/**
+ * Exact binomial coefficients from integers only.  choose(n,k) comes from
+ * a table of Pascal's triangle for n < CHOOSE_TABLE_SIZE, which is built
+ * on first use and holds every C(n,k) that fits in 64 bits for n < 64.
+ */
+const size_t CHOOSE_TABLE_SIZE = 64;
+
+struct ChooseTable
+{
+    uint64_t c[CHOOSE_TABLE_SIZE][CHOOSE_TABLE_SIZE];
+
+    ChooseTable ()
+    {
+        for (size_t n=0; n<CHOOSE_TABLE_SIZE; n++)
+        {
+            c[n][0] = 1;
+            for (size_t k=1; k<CHOOSE_TABLE_SIZE; k++)
+                c[n][k] = (n == 0 ? 0 : c[n-1][k-1] + c[n-1][k]);
+        }
+    }
+
+    static const ChooseTable& shared ()
+    {
+        static const ChooseTable table;
+        return table;
+    }
+};
+
+/**
+ * C(n,k), zero if k > n, for n < CHOOSE_TABLE_SIZE
+ */
+inline uint64_t choose (size_t n, size_t k)
+{
+    return ChooseTable::shared().c[n][k];
+}
+
+/**
+ * C(n,k) for any n and a small k.  It is exact, and does not overflow as
+ * long as the result fits in 64 bits.  For k <= 4 and n < 2^16 it divides
+ * by constants, which compile to multiplies.
+ */
+inline uint64_t chooseSmall (uint64_t n, size_t k)
+{
+    if (k > n)
+        return 0;
+    if (n < (1 << 16))
+        switch (k)
+        {
+            case 0: return 1;
+            case 1: return n;
+            case 2: return n*(n-1)/2;
+            case 3: return n*(n-1)*(n-2)/6;
+            case 4: return n*(n-1)*(n-2)*(n-3)/24;
+        }
+    uint64_t r = 1;
+    for (uint64_t i=0; i<k; i++)
+    {
+        // r*(n-i) divides by i+1, and so does the remainder part
+        const uint64_t q = r / (i+1);
+        const uint64_t s = r % (i+1);
+        r = q*(n-i) + s*(n-i)/(i+1);
+    }
+    return r;
+}
+}
+
+#endif  // __CHOOSE_H
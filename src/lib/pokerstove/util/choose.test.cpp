@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include "choose.h"
+
+using namespace pokerstove;
+
+TEST(ChooseTest, Table) {
+    EXPECT_EQ(1u, choose(0, 0));
+    EXPECT_EQ(0u, choose(0, 1));
+    EXPECT_EQ(0u, choose(3, 5));
+    EXPECT_EQ(36u, choose(9, 2));
+    EXPECT_EQ(630u, choose(36, 2));
+    EXPECT_EQ(UINT64_C(9075135300), choose(36, 18));
+    EXPECT_EQ(UINT64_C(916312070471295267), choose(63, 31));
+    for (size_t n=1; n<CHOOSE_TABLE_SIZE; n++)
+        for (size_t k=1; k<=n; k++)
+            EXPECT_EQ(choose(n-1, k-1) + choose(n-1, k), choose(n, k));
+}
+
+TEST(ChooseTest, Small) {
+    for (size_t n=0; n<CHOOSE_TABLE_SIZE; n++)
+        for (size_t k=0; k<=8; k++)
+            EXPECT_EQ(choose(n, k), chooseSmall(n, k));
+    EXPECT_EQ(UINT64_C(4166416671249975000), chooseSmall(100000, 4));
+    EXPECT_EQ(UINT64_C(4999950000), chooseSmall(100000, 2));
+}
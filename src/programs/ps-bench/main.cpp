@@ -0,0 +1,191 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/function.hpp>
+#include <boost/program_options.hpp>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/peval/BadugiTable.h>
+#include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/CardSetBitops.h>
+#include <pokerstove/peval/HighStateTable.h>
+#include <pokerstove/peval/RankHashEvaluator.h>
+
+using namespace std;
+namespace po = boost::program_options;
+using namespace pokerstove;
+
+namespace
+{
+// one pass over the hands, returns a sum of the codes, so that the
+// evaluations are not optimized away
+typedef boost::function<int (const vector<uint64_t>&)> Pass;
+
+// a pass which evaluates the hands one at a time
+template <class Eval>
+Pass eachHand (Eval eval)
+{
+    return [=](const vector<uint64_t>& hands)
+    {
+        int sum = 0;
+        for (size_t i=0; i<hands.size(); i++)
+            sum += eval (hands[i]);
+        return sum;
+    };
+}
+
+// a pass which evaluates the hands in blocks with evaluateBatch
+Pass inBatches (const RankHashEvaluator& eval, RankHashEvaluator::BatchPath path)
+{
+    return [&eval, path](const vector<uint64_t>& hands)
+    {
+        const size_t BLOCK = 1024;
+        PokerEvaluation out[BLOCK];
+        int sum = 0;
+        for (size_t i=0; i<hands.size(); i+=BLOCK)
+        {
+            size_t n = min(BLOCK, hands.size()-i);
+            eval.evaluateBatch (&hands[i], out, n, path);
+            for (size_t j=0; j<n; j++)
+                sum += out[j].code();
+        }
+        return sum;
+    };
+}
+
+// random hands of n distinct cards
+vector<uint64_t> randomHands (size_t count, size_t n, uint64_t seed)
+{
+    mt19937_64 rng(seed);
+    vector<uint64_t> hands(count);
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t mask = 0;
+        while (CardSet(mask).size() < n)
+            mask |= UINT64_C(1) << (rng() % STANDARD_DECK_SIZE);
+        hands[i] = mask;
+    }
+    return hands;
+}
+
+/**
+ * Time the evaluator on each thread going over all of the hands, passes
+ * times, and print the evaluations per second of all threads together.
+ */
+void bench (const string& name, const Pass& pass,
+            const vector<uint64_t>& hands, size_t passes, size_t nthreads)
+{
+    vector<int> sums(nthreads, 0);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t t=0; t<nthreads; t++)
+        threads.push_back (thread([&, t]()
+        {
+            int sum = 0;
+            for (size_t p=0; p<passes; p++)
+                sum += pass (hands);
+            sums[t] = sum;
+        }));
+    for (size_t t=0; t<nthreads; t++)
+        threads[t].join ();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+
+    double evals = static_cast<double>(hands.size())*passes*nthreads;
+    cout << boost::format("%-14s %8.2f M evals/s  %8.3f s  [%08x]\n")
+        % name % (evals/seconds/1e6) % seconds % static_cast<unsigned>(sums[0]);
+}
+}
+
+int main (int argc, char ** argv)
+{
+    try
+    {
+        po::options_description desc("ps-bench, times the hand evaluators on random hands\n");
+        desc.add_options()
+            ("help,?",    "produce help message")
+            ("cards,c",   po::value<size_t>()->default_value(7), "number of cards in each hand")
+            ("hands,n",   po::value<size_t>()->default_value(1<<20), "number of random hands")
+            ("passes,p",  po::value<size_t>()->default_value(10), "times each thread goes over the hands")
+            ("threads,t", po::value<size_t>()->default_value(1), "number of threads, 0 for one per core")
+            ("seed",      po::value<uint64_t>()->default_value(1), "seed for the hands")
+            ("high-states", po::value<string>(), "also time the state table built by ps-lut")
+            ("badugi",    "time the badugi evaluators on hands of four cards instead")
+            ;
+
+        po::variables_map vm;
+        po::store (po::command_line_parser(argc, argv)
+                   .style(po::command_line_style::unix_style)
+                   .options(desc)
+                   .run(), vm);
+        po::notify (vm);
+
+        if (vm.count("help"))
+        {
+            cout << desc << endl;
+            return 1;
+        }
+
+        size_t nthreads = vm["threads"].as<size_t>();
+        if (nthreads == 0)
+            nthreads = max(1u, thread::hardware_concurrency());
+        size_t passes = vm["passes"].as<size_t>();
+        vector<uint64_t> hands = randomHands (vm["hands"].as<size_t>(),
+                                              vm["cards"].as<size_t>(),
+                                              vm["seed"].as<uint64_t>());
+
+        if (vm.count("badugi"))
+        {
+            hands = randomHands (hands.size(), BadugiTable::MAX_CARDS, vm["seed"].as<uint64_t>());
+            cout << boost::format("%d hands of %d cards, %d passes, %d threads\n")
+                % hands.size() % BadugiTable::MAX_CARDS % passes % nthreads;
+            bench ("evaluateBadugi", eachHand ([](uint64_t m) { return CardSet(m).evaluateBadugi().code(); }),
+                   hands, passes, nthreads);
+            const BadugiTable& table = BadugiTable::shared();
+            bench ("badugi-table", eachHand ([&table](uint64_t m) { return table.evaluate(CardSet(m)).code(); }),
+                   hands, passes, nthreads);
+            return 0;
+        }
+
+        cout << boost::format("%d hands of %d cards, %d passes, %d threads\n")
+            % hands.size() % vm["cards"].as<size_t>() % passes % nthreads;
+
+        bench ("evaluateHigh", eachHand ([](uint64_t m) { return CardSet(m).evaluateHigh().code(); }),
+               hands, passes, nthreads);
+        if (CardSetBitops::isBuiltinSupported())
+        {
+            const CardSetBitops& portable = CardSetBitops::portable();
+            bench ("portable", eachHand ([&portable](uint64_t m) { return portable.evaluateHigh(m).code(); }),
+                   hands, passes, nthreads);
+        }
+
+        boost::shared_ptr<RankHashEvaluator> rankHash(new RankHashEvaluator);
+        const RankHashEvaluator& rh = *rankHash;
+        bench ("rank-hash", eachHand ([&rh](uint64_t m) { return rh.evaluate(CardSet(m)).code(); }),
+               hands, passes, nthreads);
+        const char* paths[] = { "batch", "batch-avx2", "batch-avx512" };
+        for (int p=RankHashEvaluator::SCALAR; p<=RankHashEvaluator::bestBatchPath(); p++)
+            bench (paths[p], inBatches (rh, static_cast<RankHashEvaluator::BatchPath>(p)),
+                   hands, passes, nthreads);
+
+        if (vm.count("high-states"))
+        {
+            HighStateTable states(vm["high-states"].as<string>());
+            bench ("high-states", eachHand ([&states](uint64_t m) { return states.evaluate(CardSet(m)).code(); }),
+                   hands, passes, nthreads);
+        }
+    }
+    catch(std::exception& e)
+    {
+        cerr << "-- caught exception--\n" << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <iostream>
+#include <thread>
 #include <vector>
 #include <string>
 #include <boost/program_options.hpp>
@@ -6,6 +8,7 @@
 #include <boost/format.hpp>
 #include <pokerstove/peval/Card.h>
 #include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/CardSetGenerators.h>
 #include <pokerstove/util/combinations.h>
 
 using namespace std;
@@ -42,6 +45,8 @@ int main (int argc, char ** argv)
             ("help,?",    "produce help message")
             ("num-cards,n", po::value<size_t>()->default_value(2), "number of cards in hands")
             ("ranks",       "print the set of rank values")
+            ("counts",      "print the number of hands each one stands for")
+            ("threads,t",   po::value<size_t>()->default_value(1), "threads to use, 0 for one per core")
             ;
       
         po::variables_map vm;
@@ -61,30 +66,41 @@ int main (int argc, char ** argv)
         // extract the options
         size_t num_cards = vm["num-cards"].as<size_t>();
 
-        set<CardSet> canonicalHands;
-        map<string,size_t> rankHands;
-        combinations cards(52,num_cards);
-        do
-        {
-            CardSet hand;
-            for (size_t i=0; i<num_cards; i++)
-            {
-                hand.insert (Card(cards[i]));
-            }
-            canonicalHands.insert(hand.canonize());
-            rankHands[hand.rankstr()] = hand.rankColex();
-        }
-        while (cards.next());
+        bool ranks = vm.count("ranks") > 0;
+        bool counts = vm.count("counts") > 0;
+        size_t threads = vm["threads"].as<size_t>();
 
-        if (vm.count("ranks") > 0)
+        // one hand of each class, streamed, with the number of hands in it
+        auto print = [&](const CardSet& hand, size_t count)
+        {
+            if (ranks)
+                cout << boost::format("%s: %d") % hand.rankstr() % hand.rankColex();
+            else
+                cout << boost::format("%s: %d") % hand.str() % hand.colex();
+            if (counts)
+                cout << boost::format(" x %d") % count;
+            cout << "\n";
+        };
+        Card::Grouping grouping = ranks ? Card::RANK : Card::SUIT_CANONICAL;
+        if (threads == 1)
         {
-            for (auto it=rankHands.begin(); it != rankHands.end(); it++)
-                cout << boost::format("%s: %d\n") % it->first % it->second;
+            visitCardSets (num_cards, grouping, print);
         }
         else
         {
-            for (auto it=canonicalHands.begin(); it != canonicalHands.end(); it++)
-                cout << boost::format("%s: %d\n") % it->str() % it->colex();
+            // each thread keeps its own hands, which print in part order
+            if (threads == 0)
+                threads = max(1u, thread::hardware_concurrency());
+            vector<vector<pair<CardSet,size_t> > > parts(threads);
+            visitCardSetsParallel (num_cards, grouping,
+                                   [&](const CardSet& hand, size_t count, size_t part)
+                                   {
+                                       parts[part].push_back (make_pair(hand, count));
+                                   },
+                                   threads);
+            for (size_t i=0; i<parts.size(); i++)
+                for (size_t j=0; j<parts[i].size(); j++)
+                    print (parts[i][j].first, parts[i][j].second);
         }
     }
     catch(std::exception& e) 
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <string>
+#include <boost/program_options.hpp>
+#include <boost/shared_ptr.hpp>
+#include <pokerstove/util/choose.h>
+#include <pokerstove/util/combinations.h>
+#include <pokerstove/peval/CardSet.h>
+#include <pokerstove/peval/PokerHandEvaluator.h>
+#include <pokerstove/penum/EquityTable.h>
+#include <pokerstove/penum/ShowdownEnumerator.h>
+#include <pokerstove/penum/ShowdownSampler.h>
+
+using namespace std;
+namespace po = boost::program_options;
+using namespace pokerstove;
+
+namespace
+{
+// the smallest image of a pair of hands under the suit permutations, used
+// to share one computation among all the equivalent matchups
+pair<uint64_t,uint64_t> canonicalPair (const CardSet& a, const CardSet& b)
+{
+    int p[4] = {0, 1, 2, 3};
+    pair<uint64_t,uint64_t> ret(a.mask(), b.mask());
+    while (next_permutation (p, p+4))
+        ret = min(ret, make_pair(a.rotateSuits(p[0],p[1],p[2],p[3]).mask(),
+                                 b.rotateSuits(p[0],p[1],p[2],p[3]).mask()));
+    return ret;
+}
+}
+
+int main (int argc, char ** argv)
+{
+    try
+    {
+        // set up the program options, handle the help case, and extract the values
+        po::options_description desc(
+            "create a table of heads up preflop equities\n");
+        desc.add_options()
+            ("help,?",    "produce help message")
+            ("game,g",    po::value<string>()->default_value("h"), "game to use for evaluation")
+            ("output,o",  po::value<string>(), "table file to write")
+            ("random,r",  "each hand against a random hand, instead of every other hand")
+            ("samples,n", po::value<uint64_t>()->default_value(0), "sample this many deals per hand, 0 to enumerate")
+            ("threads,t", po::value<size_t>()->default_value(1), "number of threads to use, 0 for one per core")
+            ;
+
+        po::variables_map vm;
+        po::store (po::command_line_parser(argc, argv)
+                   .style(po::command_line_style::unix_style)
+                   .options(desc)
+                   .run(), vm);
+        po::notify (vm);
+
+        // check for help
+        if (vm.count("help") || argc == 1 || vm.count("output") == 0)
+        {
+            cout << desc << endl;
+            return 1;
+        }
+
+        // extract the options
+        string game = vm["game"].as<string>();
+        string output = vm["output"].as<string>();
+        bool random = vm.count("random") > 0;
+        uint64_t samples = vm["samples"].as<uint64_t>();
+        size_t threads = vm["threads"].as<size_t>();
+
+        boost::shared_ptr<PokerHandEvaluator> evaluator = PokerHandEvaluator::alloc (game);
+        if (evaluator->evaluationSize() != 1)
+            throw runtime_error("equity tables are only supported for high games");
+        size_t handSize = evaluator->handSize();
+        size_t boardSize = evaluator->boardSize();
+        size_t nhands = EquityTable::numHands(handSize);
+
+        // lay out all of the hands by index
+        vector<CardSet> hands(nhands);
+        combinations cards(STANDARD_DECK_SIZE, handSize);
+        do
+        {
+            uint64_t mask = 0;
+            for (size_t i=0; i<handSize; i++)
+                mask |= UINT64_C(1) << cards[i];
+            hands[EquityTable::index(CardSet(mask))] = CardSet(mask);
+        }
+        while (cards.next());
+
+        ShowdownEnumerator showdown;
+        showdown.setNumThreads (threads);
+        showdown.setSuitIsomorphism (true);
+        ShowdownSampler sampler;
+        sampler.setNumThreads (threads);
+        sampler.setMaxSamples (samples);
+
+        EquityTable::Header header = EquityTable::Header();
+        header.handSize  = static_cast<uint32_t>(handSize);
+        header.boardSize = static_cast<uint32_t>(boardSize);
+        header.opponent  = random ? EquityTable::RANDOM : EquityTable::HAND;
+        header.samples   = samples;
+        game.copy (header.game, sizeof(header.game)-1);
+        size_t left = STANDARD_DECK_SIZE - 2*handSize;
+        header.total = static_cast<double>(choose(left, boardSize));
+        if (random)
+            header.total *= static_cast<double>(choose(STANDARD_DECK_SIZE-handSize, handSize));
+
+        vector<EquityTable::Entry> entries(random ? nhands : nhands*nhands);
+        EquityTable::Entry zero = {0.0f, 0.0f};
+        fill (entries.begin(), entries.end(), zero);
+        map<pair<uint64_t,uint64_t>, EquityTable::Entry> memo;
+        for (size_t i=0; i<nhands; i++)
+        {
+            for (size_t j=(random ? 0 : i+1); j<(random ? 1 : nhands); j++)
+            {
+                CardSet villain = random ? CardSet() : hands[j];
+                if (hands[i].intersects (villain))
+                    continue;
+
+                pair<uint64_t,uint64_t> key = canonicalPair (hands[i], villain);
+                map<pair<uint64_t,uint64_t>, EquityTable::Entry>::iterator it = memo.find (key);
+                if (it == memo.end())
+                {
+                    vector<CardDistribution> dists(2);
+                    dists[0] = CardDistribution(CardSet(key.first));
+                    dists[1] = CardDistribution(CardSet(key.second));
+                    EquityTable::Entry e;
+                    if (samples > 0)
+                    {
+                        // scale the sampled fractions up to the full count
+                        vector<EquityResult> r = sampler.calculateEquity (dists, CardSet(), evaluator);
+                        double scale = header.total/static_cast<double>(sampler.samples());
+                        e.winShares = static_cast<float>(r[0].winShares*scale);
+                        e.tieShares = static_cast<float>(r[0].tieShares*scale);
+                    }
+                    else
+                    {
+                        vector<EquityResult> r = showdown.calculateEquity (dists, CardSet(), evaluator);
+                        e.winShares = static_cast<float>(r[0].winShares);
+                        e.tieShares = static_cast<float>(r[0].tieShares);
+                    }
+                    it = memo.insert (make_pair (key, e)).first;
+                }
+
+                const EquityTable::Entry& e = it->second;
+                if (random)
+                {
+                    entries[i] = e;
+                }
+                else
+                {
+                    entries[i*nhands+j] = e;
+                    EquityTable::Entry& mirror = entries[j*nhands+i];
+                    mirror.winShares = static_cast<float>(header.total - e.winShares - 2.0*e.tieShares);
+                    mirror.tieShares = e.tieShares;
+                }
+            }
+            if ((i+1)%64 == 0 || i+1 == nhands)
+                cerr << "\r" << i+1 << "/" << nhands << " hands, "
+                     << memo.size() << " distinct matchups" << flush;
+        }
+        cerr << endl;
+
+        EquityTable::write (output, header, entries);
+    }
+    catch(std::exception& e)
+    {
+        cerr << "-- caught exception--\n" << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+    return 0;
+}
@@ -2,6 +2,10 @@
 #include <vector>
 #include <boost/program_options.hpp>
 #include <pokerstove/penum/ShowdownEnumerator.h>
+#include <pokerstove/penum/ShowdownSampler.h>
+#include <pokerstove/peval/HighStateTable.h>
+#include <pokerstove/peval/LowballTable.h>
+#include <pokerstove/peval/OmahaTable.h>
 
 using namespace pokerstove;
 namespace po = boost::program_options;
@@ -12,8 +16,20 @@ int main(int argc, char** argv) {
 
   desc.add_options()("help,?", "produce help message")
       ("game,g", po::value<string>()->default_value("h"), "game to use for evaluation")
-      ("board,b", po::value<string>(), "community cards for he/o/o8")
+      ("board,b", po::value<string>(), "community cards for he/o/o8, or a weighted list of boards such as AsKs=2,Qh9h")
       ("hand,h", po::value<vector<string>>(), "a hand for evaluation")
+      ("threads,t", po::value<size_t>()->default_value(1), "number of threads to use, 0 for one per core")
+      ("iso,i", "evaluate one runout per suit isomorphic class")
+      ("samples,n", po::value<uint64_t>(), "sample at most this many deals instead of enumerating")
+      ("stderr,e", po::value<double>(), "sample until the standard error of the equity is below this")
+      ("time", po::value<double>(), "sample for at most this many seconds")
+      ("seed", po::value<uint64_t>(), "seed for sampling")
+      ("table", po::value<string>(), "precomputed equity table for heads up preflop queries")
+      ("sampled-table", "let a --table built by sampling answer, its equities are estimates")
+      ("high-states", po::value<string>(), "evaluate high hands with a state table built by ps-lut")
+      ("omaha-table", po::value<string>(), "evaluate omaha high hands with a table built by ps-lut")
+      ("lowball-table", po::value<string>(), "evaluate lowball hands with a table built by ps-lut")
+      ("limit", po::value<double>(), "stop enumerating after this many seconds, and report the part done")
       ("quiet,q", "produces no output");
 
   // make hand a positional argument
@@ -40,29 +56,109 @@ int main(int argc, char** argv) {
   string board = vm.count("board") ? vm["board"].as<string>() : "";
   vector<string> hands = vm["hand"].as<vector<string>>();
 
+  size_t threads = vm["threads"].as<size_t>();
+  bool iso = vm.count("iso") > 0;
   bool quiet = vm.count("quiet") > 0;
+  bool sample = vm.count("samples") || vm.count("stderr") || vm.count("time");
+
+  // a list of boards, or a weighted board, is a board distribution
+  CardDistribution boards;
+  bool boardDist = board.find_first_of(",=") != string::npos;
+  if (boardDist) {
+    if (sample) {
+      cerr << "board distributions can not be sampled" << endl;
+      return 1;
+    }
+    if (!boards.parse(board)) {
+      cerr << "can not parse the board distribution " << board << endl;
+      return 1;
+    }
+  }
 
   // allocate evaluator and create card distributions
   boost::shared_ptr<PokerHandEvaluator> evaluator =
       PokerHandEvaluator::alloc(game);
+  if (vm.count("high-states"))
+    evaluator->setHighStateTable(boost::shared_ptr<const HighStateTable>(
+        new HighStateTable(vm["high-states"].as<string>())));
+  if (vm.count("omaha-table"))
+    evaluator->setOmahaTable(boost::shared_ptr<const OmahaTable>(
+        new OmahaTable(vm["omaha-table"].as<string>())));
+  if (vm.count("lowball-table"))
+    evaluator->setLowballTable(boost::shared_ptr<const LowballTable>(
+        new LowballTable(vm["lowball-table"].as<string>())));
 
   // calcuate the results and print them
   ShowdownEnumerator showdown;
-  vector<EquityResult> results =
-      showdown.calculateEquityFuzz(hands, CardSet(board), evaluator);
+  showdown.setNumThreads(threads);
+  showdown.setSuitIsomorphism(iso);
+  if (vm.count("table")) {
+    boost::shared_ptr<const EquityTable> table(
+        new EquityTable(vm["table"].as<string>()));
+    if (!table->matches(*evaluator)) {
+      cerr << "the equity table was built for game " << table->game()
+           << ", not " << game << endl;
+      return 1;
+    }
+    if (!table->exact() && !vm.count("sampled-table") && !quiet)
+      cerr << "the equity table is sampled, enumerating instead, use "
+           << "--sampled-table to answer from it" << endl;
+    showdown.setEquityTable(table, vm.count("sampled-table") > 0);
+  }
+  // only a time limit needs the control, without one the enumerator
+  // keeps its single threaded fast path
+  EnumerationControl control;
+  EnumerationControl* limit = NULL;
+  if (vm.count("limit")) {
+    control.setTimeLimit(vm["limit"].as<double>());
+    limit = &control;
+  }
+  ShowdownSampler sampler;
+  vector<EquityResult> results;
+  if (sample) {
+    sampler.setNumThreads(threads);
+    sampler.setMaxSamples(vm.count("samples") ? vm["samples"].as<uint64_t>()
+                                              : UINT64_MAX);
+    if (vm.count("stderr"))
+      sampler.setTargetStandardError(vm["stderr"].as<double>());
+    if (vm.count("time"))
+      sampler.setTimeBudget(vm["time"].as<double>());
+    if (vm.count("seed"))
+      sampler.setSeed(vm["seed"].as<uint64_t>());
+    results = sampler.calculateEquity(showdown.parseFuzzDistributions(hands),
+                                      CardSet(board), evaluator);
+  } else {
+    vector<CardDistribution> dists = showdown.parseFuzzDistributions(hands);
+    if (boardDist)
+      results = showdown.calculateEquity(dists, boards, evaluator, limit);
+    else
+      results = showdown.calculateEquity(dists, CardSet(board), evaluator, limit);
+  }
 
   double total = 0.0;
   for (const EquityResult& result : results) {
     total += result.winShares + result.tieShares;
   }
 
-  if (!quiet) {
+  if (!quiet && total == 0.0 && !sample && limit && !control.complete()) {
+      cout << "stopped before covering any deals" << endl;
+  } else if (!quiet) {
       for (size_t i = 0; i < results.size(); ++i) {
         double equity = (results[i].winShares + results[i].tieShares) / total;
         string handDesc =
             (i < hands.size()) ? "The hand " + hands[i] : "A random hand";
-        cout << handDesc << " has " << equity * 100. << " % equity ("
-             << results[i].str() << ")" << endl;
+        cout << handDesc << " has " << equity * 100. << " % equity";
+        if (sample) {
+          pair<double, double> ci = sampler.confidenceInterval(results[i]);
+          cout << " (95% interval " << ci.first * 100. << " - "
+               << ci.second * 100. << " %)";
+        }
+        cout << " (" << results[i].str() << ")" << endl;
       }
+      if (sample)
+        cout << sampler.samples() << " samples" << endl;
+      else if (limit && !control.complete())
+        cout << "stopped after covering " << control.coverage() * 100.
+             << " % of the deals" << endl;
   }
 }
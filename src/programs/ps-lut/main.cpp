@@ -8,7 +8,11 @@
 #include <pokerstove/peval/Card.h>
 #include <pokerstove/peval/CardSet.h>
 #include <pokerstove/peval/CardSetGenerators.h>
+#include <pokerstove/peval/HighStateTable.h>
+#include <pokerstove/peval/LowballTable.h>
+#include <pokerstove/peval/OmahaTable.h>
 #include <pokerstove/peval/PokerHandEvaluator.h>
+#include <pokerstove/peval/RankTable.h>
 
 using namespace std;
 namespace po = boost::program_options;
@@ -27,6 +31,10 @@ int main (int argc, char ** argv)
             ("board-count,b",  po::value<size_t>()->default_value(3), "number of board cards to use")
             ("game,g",         po::value<string>()->default_value("O"), "game to use for evaluation")
             ("ranks",          "print the set of rank values")
+            ("binary",         po::value<string>(), "with --ranks, write the rank table to a file and exit")
+            ("high-states",    po::value<string>(), "write the high hand state table to a file and exit")
+            ("omaha-table",    po::value<string>(), "write the omaha two card by three card table to a file and exit")
+            ("lowball-table",  po::value<string>(), "write the lowball tables to a file and exit")
             ;
       
         po::variables_map vm;
@@ -43,6 +51,32 @@ int main (int argc, char ** argv)
             return 1;
         }
 
+        if (vm.count("high-states"))
+        {
+            HighStateTable::write (vm["high-states"].as<string>());
+            return 0;
+        }
+
+        if (vm.count("omaha-table"))
+        {
+            OmahaTable::write (vm["omaha-table"].as<string>());
+            return 0;
+        }
+
+        if (vm.count("lowball-table"))
+        {
+            LowballTable::write (vm["lowball-table"].as<string>());
+            return 0;
+        }
+
+        if (vm.count("binary"))
+        {
+            if (!vm.count("ranks"))
+                throw invalid_argument("--binary needs --ranks");
+            RankTable::write (vm["binary"].as<string>());
+            return 0;
+        }
+
         // extract the options
         size_t pocketCount = vm["pocket-count"].as<size_t>();
         size_t boardCount = vm["board-count"].as<size_t>();
@@ -53,40 +87,42 @@ int main (int argc, char ** argv)
         Card::Grouping grouping = Card::SUIT_CANONICAL;
         if (ranks)
             grouping = Card::RANK;
-        set<CardSet> pockets = createCardSet(pocketCount, grouping);
-        set<CardSet> boards = createCardSet(boardCount, grouping);
+        // the pockets are few, the boards are walked again for each
+        vector<CardSet> pockets;
+        visitCardSets (pocketCount, grouping, [&](const CardSet& hand, size_t)
+        {
+            pockets.push_back (hand);
+        });
 
         auto evaluator = PokerHandEvaluator::alloc (game);
         for (auto pit=pockets.begin(); pit != pockets.end(); pit++)
-            for (auto bit=boards.begin(); bit != boards.end(); bit++)
+            visitCardSets (boardCount, grouping, [&](const CardSet& board, size_t)
             {
                 if (ranks)
                 {
-                    PokerEvaluation eval = evaluator->evaluateRanks(*pit, *bit);
-                    //cout << boost::format("%s, %s\n") % pit->rankstr() % bit->rankstr();
+                    PokerEvaluation eval = evaluator->evaluateRanks(*pit, board);
                     cout << boost::format("%s, %s: [%4d,%4d] -> %s [%9d]\n") 
                         % pit->str()
-                        % bit->str()
+                        % board.str()
                         % pit->rankColex()
-                        % bit->rankColex()
+                        % board.rankColex()
                         % eval.str()
                         % eval.code();
                 }
                 else
                 {
-                    bit->canonize(*pit);
-                    if (pit->intersects(*bit))
-                        continue;
-                    PokerHandEvaluation eval = evaluator->evaluate(*pit, *bit);
+                    if (pit->intersects(board))
+                        return;
+                    PokerHandEvaluation eval = evaluator->evaluate(*pit, board);
                     cout << boost::format("%s, %s: [%4d,%4d] -> %s [%9d]\n") 
                         % pit->str()
-                        % bit->str()
+                        % board.str()
                         % pit->colex()
-                        % bit->colex()
+                        % board.colex()
                         % eval.str()
                         % eval.high().code();
                 }
-            }
+            });
     }
     catch(std::exception& e) 
     {
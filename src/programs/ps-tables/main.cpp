@@ -0,0 +1,323 @@
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+
+using namespace std;
+namespace po = boost::program_options;
+
+/**
+ * Writes lib/pokerstove/peval/PokerEvaluationTables.h.  Every table is
+ * worked out from its definition here, so that the header can be rebuilt,
+ * and checked, rather than edited by hand.  This program deliberately
+ * does not link peval, which includes the tables it makes.
+ *
+ * The rank mask tables of 2^13 entries are indexed by the ranks of a
+ * full deck, which is what the kicker bits of PokerEvaluation and the
+ * older CardSet routines hand them.  The tables of 2^DECK_RANKS entries
+ * are for the ranks of this deck, with its ace low straight.
+ */
+
+namespace
+{
+const int FULL_RANKS = 13;
+const int DECK_RANKS = 9;           // Rank::NUM_RANK, checked where it is used
+
+int countRanks (int mask)
+{
+    int n = 0;
+    for (; mask; mask &= mask-1)
+        n++;
+    return n;
+}
+
+int topRank (int mask)
+{
+    int r = -1;
+    for (; mask; mask >>= 1)
+        r++;
+    return r;
+}
+
+int bottomRank (int mask)
+{
+    if (mask == 0)
+        return -1;
+    int r = 0;
+    for (; (mask & 0x01) == 0; mask >>= 1)
+        r++;
+    return r;
+}
+
+// the mask of the top n ranks
+int topRanks (int mask, int n)
+{
+    int ret = 0;
+    for (int r=FULL_RANKS; r-- > 0 && n > 0; )
+        if (mask & 0x01<<r)
+        {
+            ret |= 0x01<<r;
+            n--;
+        }
+    return ret;
+}
+
+// the top rank of the best straight in the ranks, with the ace
+// (rank nranks-1) also playing low, or zero if there is none
+int madeStraight (int mask, int nranks)
+{
+    const int lowace = (mask >> (nranks-1)) & 0x01;
+    const int ext = (mask << 1) | lowace;     // bit r+1 is rank r
+    for (int top=nranks; top >= 4; top--)
+        if (((ext >> (top-4)) & 0x1F) == 0x1F)
+            return top-1;
+    return 0;
+}
+
+// the number of ranks which would make a straight
+int straightOuts (int mask, int nranks)
+{
+    int outs = 0;
+    for (int r=0; r<nranks; r++)
+        if ((mask & 0x01<<r) == 0 && madeStraight (mask | 0x01<<r, nranks) > 0)
+            outs++;
+    return outs;
+}
+
+/**
+ * N for an N high straight, -1 for one rank to a straight (a gutshot), -2
+ * for exactly two (open ended), -3 when it takes two more ranks, and 0
+ * otherwise.  Ranks with more than two outs, which need eight or more
+ * ranks, have always been zero.
+ */
+int straightValue (int mask, int nranks)
+{
+    const int made = madeStraight (mask, nranks);
+    if (made > 0)
+        return made;
+    const int outs = straightOuts (mask, nranks);
+    if (outs == 2)
+        return -2;
+    if (outs == 1)
+        return -1;
+    if (outs > 2)
+        return 0;
+    for (int r=0; r<nranks; r++)
+        if ((mask & 0x01<<r) == 0 && straightOuts (mask | 0x01<<r, nranks) > 0)
+            return -3;
+    return 0;
+}
+
+// the five lowest ranks with the ace low, bit 0 for the ace, for A-5
+// lowball, as PokerEvaluation::generateLowballLookupA5 did
+int lowballA5 (int mask)
+{
+    const int ACE = 0x01<<FULL_RANKS;
+    int bits = mask<<1;
+    if (bits & ACE)
+        bits = bits - ACE + 1;
+    int low = 0;
+    int n = 0;
+    for (int b=0; b<FULL_RANKS && n<5; b++)
+        if (bits & 0x01<<b)
+        {
+            low |= 0x01<<b;
+            n++;
+        }
+    return low;
+}
+
+typedef int (*MaskFunction) (int mask);
+
+int nranksOf      (int mask) { return countRanks (mask); }
+int topOf         (int mask) { return topRank (mask); }
+int bottomOf      (int mask) { return bottomRank (mask); }
+int straightOf    (int mask) { return straightValue (mask, FULL_RANKS); }
+int topFiveOf     (int mask) { return topRanks (mask, 5); }
+int topThreeOf    (int mask) { return topRanks (mask, 3); }
+int bottomMaskOf  (int mask) { return mask & -mask; }
+
+void writeTable (ostream& out, const string& decl, MaskFunction f, int entries)
+{
+    const int PER_LINE = 12;
+    out << decl << " =\n{\n";
+    for (int i=0; i<entries; i+=PER_LINE)
+    {
+        out << "   ";
+        for (int j=i; j<i+PER_LINE && j<entries; j++)
+            out << boost::format(" %5d,") % f(j);
+        out << "\n";
+    }
+    out << "};\n\n";
+}
+
+void writeRankMaskTable (ostream& out)
+{
+    out << "alignas(64) const RankMaskEntry rankMaskTable[] =\n{\n";
+    for (int m=0; m<(1<<DECK_RANKS); m++)
+        out << boost::format("    { %5d, %5d, %d, %2d, %2d, %2d },\n")
+            % topRanks (m, 5) % topRanks (m, 3) % countRanks (m)
+            % straightValue (m, DECK_RANKS) % topRank (m) % bottomRank (m);
+    out << "};\n\n";
+}
+
+string generate ()
+{
+    ostringstream out;
+    out <<
+        "/**\n"
+        " * Copyright (c) 2012 Andrew Prock. All rights reserved.\n"
+        " *\n"
+        " * Generated by ps-tables, do not edit.  Rebuild it with\n"
+        " * \"make peval-tables\", the TablesUpToDate test checks it.\n"
+        " */\n"
+        "#ifndef PEVAL_POKEREVALUATIONTABLES_H_\n"
+        "#define PEVAL_POKEREVALUATIONTABLES_H_\n"
+        "\n"
+        "#include <boost/cstdint.hpp>\n"
+        "\n"
+        "namespace pokerstove\n"
+        "{\n"
+        "\n"
+        "/* the tables defined in this file, each indexed by a mask of ranks:\n"
+        " *\n"
+        " * const int8_t topRankTable[]\n"
+        " * const int8_t botRankTable[]\n"
+        " *   the top and bottom rank, -1 for no ranks\n"
+        " *\n"
+        " * const int8_t straightTable[]\n"
+        " *  -3 runner runner\n"
+        " *  -2 open-ended\n"
+        " *  -1 gutshot\n"
+        " *   0\n"
+        " *   N N-high straight\n"
+        " *\n"
+        " * const uint8_t nRanksTable[]\n"
+        " *\n"
+        " * const uint16_t topFiveRanksTable[]\n"
+        " *   A bitmask of the top five ranks.\n"
+        " *   Useful for flushes, high cards (in high)\n"
+        " *\n"
+        " * const uint16_t topThreeRanksTable[]\n"
+        " *   A bitmask for the top three ranks.\n"
+        " *   Useful for a pair + three kickers\n"
+        " *\n"
+        " * const uint16_t lowballA5Ranks[]\n"
+        " *   the five lowest ranks, with the ace low in bit 0\n"
+        " *\n"
+        " * const uint16_t bottomRankMask[]\n"
+        " *   A table that returns the bitmask with\n"
+        " *   only the bottom bit set.\n"
+        " *\n"
+        " * The tables above have 2^13 entries, for the ranks of a full deck.\n"
+        " *\n"
+        " * const RankMaskEntry rankMaskTable[]\n"
+        " *   the lookups of evaluateHigh for the ranks of this deck, one\n"
+        " *   8 byte entry per mask, so that what one hand needs shares a\n"
+        " *   cache line.  Its straights have the ace low straight of this\n"
+        " *   deck.\n"
+        " */\n"
+        "\n";
+
+    writeTable (out, "const int8_t topRankTable[]",         topOf,        1<<FULL_RANKS);
+    writeTable (out, "const int8_t botRankTable[]",         bottomOf,     1<<FULL_RANKS);
+    writeTable (out, "const int8_t straightTable[]",        straightOf,   1<<FULL_RANKS);
+    writeTable (out, "const uint8_t nRanksTable[]",         nranksOf,     1<<FULL_RANKS);
+    writeTable (out, "const uint16_t topFiveRanksTable[]",  topFiveOf,    1<<FULL_RANKS);
+    writeTable (out, "const uint16_t topThreeRanksTable[]", topThreeOf,   1<<FULL_RANKS);
+    writeTable (out, "const uint16_t lowballA5Ranks[]",     lowballA5,    1<<FULL_RANKS);
+    writeTable (out, "const uint16_t bottomRankMask[]",     bottomMaskOf, 1<<FULL_RANKS);
+
+    out <<
+        "struct RankMaskEntry\n"
+        "{\n"
+        "    uint16_t topFive;       //!< topFiveRanksTable\n"
+        "    uint16_t topThree;      //!< topThreeRanksTable\n"
+        "    uint8_t  nRanks;        //!< nRanksTable\n"
+        "    int8_t   straight;      //!< straightTable, with this deck's wheel\n"
+        "    int8_t   top;           //!< topRankTable\n"
+        "    int8_t   bottom;        //!< botRankTable\n"
+        "};\n"
+        "\n";
+    writeRankMaskTable (out);
+
+    out <<
+        "}\n"
+        "\n"
+        "#endif  // PEVAL_POKEREVALUATIONTABLES_H_\n";
+    return out.str();
+}
+}
+
+int main (int argc, char ** argv)
+{
+    try
+    {
+        po::options_description desc(
+            "generate PokerEvaluationTables.h\n");
+        desc.add_options()
+            ("help,?",    "produce help message")
+            ("output,o",  po::value<string>(), "write the tables to a file, in place of stdout")
+            ("check,c",   po::value<string>(), "exit with an error if the file differs from the tables")
+            ;
+
+        po::variables_map vm;
+        po::store (po::command_line_parser(argc, argv)
+                   .style(po::command_line_style::unix_style)
+                   .options(desc)
+                   .run(), vm);
+        po::notify (vm);
+
+        if (vm.count("help"))
+        {
+            cout << desc << endl;
+            return 1;
+        }
+
+        const string tables = generate ();
+
+        if (vm.count("check"))
+        {
+            const string filename = vm["check"].as<string>();
+            ifstream in(filename.c_str(), ios::binary);
+            ostringstream current;
+            current << in.rdbuf();
+            if (!in || current.str() != tables)
+            {
+                cerr << filename << " is out of date, rebuild it with \"make peval-tables\"\n";
+                return 1;
+            }
+            return 0;
+        }
+
+        if (vm.count("output"))
+        {
+            const string filename = vm["output"].as<string>();
+            ofstream out(filename.c_str(), ios::binary);
+            out << tables;
+            if (!out)
+            {
+                cerr << "can not write " << filename << endl;
+                return 1;
+            }
+            return 0;
+        }
+
+        cout << tables;
+    }
+    catch(std::exception& e)
+    {
+        cerr << "-- caught exception--\n" << e.what() << "\n";
+        return 1;
+    }
+    catch(...)
+    {
+        cerr << "Exception of unknown type!\n";
+        return 1;
+    }
+    return 0;
+}